@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <map>
+#include "PDESolver.hpp"
+
+// Fixed (plain Crank-Nicolson and Rannacher) vs adaptive time stepping on
+// ATM puts of 1, 5 and 10 years, all on the same 200-interval sinh grid.
+// Each benchmark reports the time-discretization error against a
+// 20000-step reference on that grid (abs_err), the accepted steps (steps)
+// and the LU factorizations (factorizations); compare rows at equal
+// abs_err.
+
+static double reference(double T) {
+    static std::map<double, double> cache;
+    auto it = cache.find(T);
+    if (it != cache.end())
+        return it->second;
+    PDESolver ref(200, 20000, GridType::Sinh);
+    ref.setRannacherSteps(2);
+    double price = ref.priceEuropean(Option(100, 100, T, 0.05, 0.2, OptionType::Put));
+    return cache[T] = price;
+}
+
+static void report(benchmark::State& state, const PDESolver& solver, double price,
+                   double T) {
+    SolveStats stats = solver.lastSolveStats();
+    state.counters["abs_err"] = std::abs(price - reference(T));
+    state.counters["steps"] = stats.steps;
+    state.counters["factorizations"] = stats.factorizations;
+}
+
+// Args: maturity in years, number of steps, Rannacher start-up steps.
+static void BM_FixedSteps(benchmark::State& state) {
+    double T = static_cast<double>(state.range(0));
+    Option opt(100, 100, T, 0.05, 0.2, OptionType::Put);
+    PDESolver solver(200, static_cast<int>(state.range(1)), GridType::Sinh);
+    solver.setRannacherSteps(static_cast<int>(state.range(2)));
+
+    double price = 0.0;
+    for (auto _ : state) {
+        price = solver.priceEuropean(opt);
+        benchmark::DoNotOptimize(price);
+    }
+    report(state, solver, price, T);
+}
+
+// Args: maturity in years, -log10(tol).
+static void BM_AdaptiveSteps(benchmark::State& state) {
+    double T = static_cast<double>(state.range(0));
+    Option opt(100, 100, T, 0.05, 0.2, OptionType::Put);
+    PDESolver solver(200, 1, GridType::Sinh);
+    solver.setTimeTolerance(std::pow(10.0, -static_cast<double>(state.range(1))));
+
+    double price = 0.0;
+    for (auto _ : state) {
+        price = solver.priceEuropean(opt);
+        benchmark::DoNotOptimize(price);
+    }
+    report(state, solver, price, T);
+}
+
+static void fixedArgs(benchmark::internal::Benchmark* b) {
+    for (int rannacher : {0, 2})
+        for (int T : {1, 5, 10})
+            for (int N : {25, 50, 100, 200})
+                b->Args({T, N, rannacher});
+}
+
+static void adaptiveArgs(benchmark::internal::Benchmark* b) {
+    for (int T : {1, 5, 10})
+        for (int digits : {3, 4, 5})
+            b->Args({T, digits});
+}
+
+BENCHMARK(BM_FixedSteps)->Apply(fixedArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AdaptiveSteps)->Apply(adaptiveArgs)->Unit(benchmark::kMicrosecond);
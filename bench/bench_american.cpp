@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include "PDESolver.hpp"
+
+// Cost vs accuracy of the early-exercise methods on an ATM American put.
+// Args: {method, grid size M = N}. The abs_err counter is the distance to
+// a 3200 x 3200 Brennan-Schwartz solve.
+
+static Option americanPut() {
+    return Option(100, 100, 1.0, 0.05, 0.2, OptionType::Put, ExerciseType::American);
+}
+
+static double referencePrice() {
+    static const double ref = [] {
+        PDESolver solver(3200, 3200, true);
+        solver.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+        return solver.priceAmerican(americanPut());
+    }();
+    return ref;
+}
+
+static void BM_AmericanMethod(benchmark::State& state) {
+    auto method = static_cast<AmericanMethod>(state.range(0));
+    int M = static_cast<int>(state.range(1));
+    double ref = referencePrice();
+    Option opt = americanPut();
+    PDESolver solver(M, M, true);
+    solver.setAmericanMethod(method);
+
+    double price = 0.0;
+    for (auto _ : state) {
+        price = solver.priceAmerican(opt);
+        benchmark::DoNotOptimize(price);
+    }
+    state.counters["abs_err"] = std::abs(price - ref);
+}
+
+static void methodArgs(benchmark::internal::Benchmark* b) {
+    for (int method = 0; method < 4; ++method)
+        for (int M : {100, 200, 400, 800}) {
+            if (method == static_cast<int>(AmericanMethod::PSOR) && M > 400)
+                continue;  // seconds per price
+            b->Args({method, M});
+        }
+}
+
+BENCHMARK(BM_AmericanMethod)->Apply(methodArgs)->Unit(benchmark::kMillisecond);
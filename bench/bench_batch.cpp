@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <thread>
+#include <vector>
+#include "BatchPricer.hpp"
+
+// Mixed book: one American for every three Europeans, spread over
+// moneyness, maturity and vol. Fixed seed so every run prices the same book.
+static std::vector<Option> makeBook(int count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> spot(70.0, 130.0), mat(0.1, 2.0), vol(0.1, 0.5);
+    std::vector<Option> book;
+    book.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        OptionType type = (i % 2 == 0) ? OptionType::Call : OptionType::Put;
+        ExerciseType ex = (i % 4 == 3) ? ExerciseType::American : ExerciseType::European;
+        book.emplace_back(spot(rng), 100.0, mat(rng), 0.05, vol(rng), type, ex);
+    }
+    return book;
+}
+
+// Thread scaling: the same 512-contract book priced on 1..N threads.
+static void BM_PriceBatch(benchmark::State& state) {
+    int threads = static_cast<int>(state.range(0));
+    auto book = makeBook(512);
+    BatchPricer pricer(PDESolver(200, 200, true), threads);
+    std::vector<double> out(book.size());
+
+    for (auto _ : state) {
+        pricer.priceBatch(book.data(), book.size(), out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(book.size()));
+}
+
+static void threadCounts(benchmark::internal::Benchmark* b) {
+    int hw = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int t = 1; t < hw; t *= 2)
+        b->Arg(t);
+    b->Arg(hw);
+}
+
+BENCHMARK(BM_PriceBatch)->Apply(threadCounts)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "BlackScholes.hpp"
+
+// Random quote set shared by the scalar and batch benchmarks.
+struct Quotes {
+    std::vector<Option> options;
+    std::vector<double> S, K, T, r, sigma;
+    std::vector<OptionType> type;
+
+    explicit Quotes(int n) {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> spot(60, 140), mat(0.02, 3.0),
+            rate(0.0, 0.08), vol(0.05, 0.8);
+        for (int i = 0; i < n; ++i) {
+            OptionType t = (i % 2 == 0) ? OptionType::Call : OptionType::Put;
+            options.emplace_back(spot(rng), 100.0, mat(rng), rate(rng), vol(rng), t);
+            const Option& o = options.back();
+            S.push_back(o.S); K.push_back(o.K); T.push_back(o.T);
+            r.push_back(o.r); sigma.push_back(o.sigma); type.push_back(o.type);
+        }
+    }
+};
+
+// Current scalar path: price + delta, one Option at a time.
+static void BM_BlackScholesScalar(benchmark::State& state) {
+    Quotes q(static_cast<int>(state.range(0)));
+    for (auto _ : state)
+        for (const auto& o : q.options) {
+            benchmark::DoNotOptimize(BlackScholes::price(o));
+            benchmark::DoNotOptimize(BlackScholes::delta(o));
+        }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Scalar path for the full greek set the batch kernel produces
+// (vanna/volga omitted: there are no scalar functions for them).
+static void BM_BlackScholesScalarGreeks(benchmark::State& state) {
+    Quotes q(static_cast<int>(state.range(0)));
+    for (auto _ : state)
+        for (const auto& o : q.options) {
+            benchmark::DoNotOptimize(BlackScholes::price(o));
+            benchmark::DoNotOptimize(BlackScholes::delta(o));
+            benchmark::DoNotOptimize(BlackScholes::gamma(o));
+            benchmark::DoNotOptimize(BlackScholes::vega(o));
+            benchmark::DoNotOptimize(BlackScholes::theta(o));
+            benchmark::DoNotOptimize(BlackScholes::rho(o));
+        }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Batch kernel: price and all eight greeks per quote.
+static void BM_BlackScholesBatch(benchmark::State& state) {
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    Quotes q(static_cast<int>(n));
+    std::vector<double> out(8 * n);
+    BSQuotes in{q.S.data(), q.K.data(), q.T.data(), q.r.data(), q.sigma.data(), q.type.data(), n};
+    BSGreeks g{&out[0], &out[n], &out[2 * n], &out[3 * n],
+               &out[4 * n], &out[5 * n], &out[6 * n], &out[7 * n]};
+    for (auto _ : state) {
+        BlackScholes::priceBatch(in, g);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_BlackScholesScalar)->Arg(1 << 16);
+BENCHMARK(BM_BlackScholesScalarGreeks)->Arg(1 << 16);
+BENCHMARK(BM_BlackScholesBatch)->Arg(1 << 16);
@@ -0,0 +1,118 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "BlackScholes.hpp"
+#include "Grid.hpp"
+#include "PDESolver.hpp"
+#include "Tridiagonal.hpp"
+
+// Core timings tracked by the perf_regression gate (perf_gate.py), next to
+// BM_FillOperator and BM_StepFused from bench_kernels.cpp: the tridiagonal
+// solvers, grid construction, the analytic price, and end-to-end European
+// and American prices across grid sizes. BM_Calibration is a fixed
+// dependent chain of floating-point operations; the gate compares every
+// other timing relative to it, so a uniformly faster or slower host does
+// not move the ratios.
+
+static void BM_Calibration(benchmark::State& state) {
+    for (auto _ : state) {
+        double x = 1.0;
+        benchmark::DoNotOptimize(x);
+        for (int i = 0; i < 4096; ++i)
+            x = x * 0.999999 + 1e-6;
+        benchmark::DoNotOptimize(x);
+    }
+}
+
+static void makeSystem(int n, std::vector<double>& a, std::vector<double>& b,
+                       std::vector<double>& c, std::vector<double>& d) {
+    a.assign(n, -0.3);
+    b.assign(n, 2.0);
+    c.assign(n, -0.7);
+    d.resize(n);
+    for (int i = 0; i < n; ++i)
+        d[i] = std::sin(0.1 * i);
+}
+
+static void BM_ThomasSolve(benchmark::State& state) {
+    std::vector<double> a, b, c, d, x;
+    makeSystem(static_cast<int>(state.range(0)), a, b, c, d);
+    for (auto _ : state) {
+        solveTridiagonal(a, b, c, d, x);
+        benchmark::DoNotOptimize(x.data());
+    }
+}
+
+static void BM_FactoredSolve(benchmark::State& state) {
+    std::vector<double> a, b, c, d, x;
+    makeSystem(static_cast<int>(state.range(0)), a, b, c, d);
+    TridiagonalLU lu;
+    lu.factor(a, b, c);
+    for (auto _ : state) {
+        lu.solve(d, x);
+        benchmark::DoNotOptimize(x.data());
+    }
+}
+
+// Args: GridType, n_space.
+static void BM_GridBuild(benchmark::State& state) {
+    int M = static_cast<int>(state.range(1));
+    for (auto _ : state) {
+        std::unique_ptr<Grid> grid;
+        switch (static_cast<GridType>(state.range(0))) {
+        case GridType::Uniform:  grid = std::make_unique<UniformGrid>(300.0, M); break;
+        case GridType::Adaptive: grid = std::make_unique<AdaptiveGrid>(300.0, M, 100.0); break;
+        default:
+            grid = std::make_unique<SinhGrid>(300.0, M, std::vector<double>{100.0, 95.0}, 10.0);
+        }
+        benchmark::DoNotOptimize(grid.get());
+    }
+}
+
+static void BM_BlackScholesPrice(benchmark::State& state) {
+    Option opt(100, 100, 1.0, 0.05, 0.2, OptionType::Put);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(opt);
+        benchmark::DoNotOptimize(BlackScholes::price(opt));
+    }
+}
+
+// Args: GridType, n_space; n_time = n_space.
+static void BM_PriceEuropean(benchmark::State& state) {
+    int M = static_cast<int>(state.range(1));
+    PDESolver solver(M, M, static_cast<GridType>(state.range(0)));
+    Option opt(100, 100, 1.0, 0.05, 0.2, OptionType::Put);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(solver.priceEuropean(opt));
+}
+
+// Args: AmericanMethod, n_space; n_time = n_space, Adaptive grid.
+static void BM_PriceAmerican(benchmark::State& state) {
+    int M = static_cast<int>(state.range(1));
+    PDESolver solver(M, M, GridType::Adaptive);
+    solver.setAmericanMethod(static_cast<AmericanMethod>(state.range(0)));
+    Option opt(100, 100, 1.0, 0.05, 0.2, OptionType::Put, ExerciseType::American);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(solver.priceAmerican(opt));
+}
+
+static void gridArgs(benchmark::internal::Benchmark* b) {
+    for (GridType g : {GridType::Uniform, GridType::Adaptive, GridType::Sinh})
+        for (int M : {100, 400, 1600})
+            b->Args({static_cast<int>(g), M});
+}
+
+static void americanArgs(benchmark::internal::Benchmark* b) {
+    for (AmericanMethod m : {AmericanMethod::Projection, AmericanMethod::BrennanSchwartz})
+        for (int M : {100, 400})
+            b->Args({static_cast<int>(m), M});
+}
+
+BENCHMARK(BM_Calibration);
+BENCHMARK(BM_ThomasSolve)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_FactoredSolve)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_GridBuild)->Apply(gridArgs);
+BENCHMARK(BM_BlackScholesPrice);
+BENCHMARK(BM_PriceEuropean)->Apply(gridArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PriceAmerican)->Apply(americanArgs)->Unit(benchmark::kMicrosecond);
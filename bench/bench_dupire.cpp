@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "DupireSolver.hpp"
+#include "PDESolver.hpp"
+
+// A vol-surface marking grid: 41 strikes (80..120) x 4 expiries (3M, 6M,
+// 9M, 1Y), Sinh grids with M = 400 and 400 steps per year.
+static const std::vector<double> kExpiries = {0.25, 0.5, 0.75, 1.0};
+
+static std::vector<double> strikes() {
+    std::vector<double> K;
+    for (int k = 0; k <= 40; ++k)
+        K.push_back(80.0 + k);
+    return K;
+}
+
+// One backward sweep per strike, each returning all four expiries.
+static void BM_StrikeGridBackward(benchmark::State& state) {
+    std::vector<double> K = strikes();
+    PDESolver solver(400, 400, GridType::Sinh);
+    solver.setRannacherSteps(2);
+    for (auto _ : state)
+        for (double k : K)
+            benchmark::DoNotOptimize(solver.priceMaturities(
+                Option(100, k, 1.0, 0.05, 0.2, OptionType::Call), kExpiries));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(K.size() * kExpiries.size()));
+}
+
+// One forward sweep for the whole grid.
+static void BM_StrikeGridForward(benchmark::State& state) {
+    std::vector<double> K = strikes();
+    std::vector<double> out(K.size());
+    DupireSolver solver(400, 400);
+    solver.setRannacherSteps(2);
+    for (auto _ : state) {
+        for (const StrikeSlice& slice : solver.solve(100, 0.05, 0.2, OptionType::Call, kExpiries))
+            slice.prices.evaluate(K.data(), K.size(), out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(K.size() * kExpiries.size()));
+}
+
+BENCHMARK(BM_StrikeGridBackward)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StrikeGridForward)->Unit(benchmark::kMicrosecond);
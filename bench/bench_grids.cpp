@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include "BlackScholes.hpp"
+#include "PDESolver.hpp"
+
+// Error per node of the grid families. Args: {GridType, M}. Each
+// iteration prices four contracts (ATM 1y, OTM 3m put, short-dated OTM
+// call, long-dated high-vol put) with N = 1000 time steps and Rannacher
+// start-up, so the time error is negligible and the spatial error shows.
+// Counters: max_err and mean_err against Black-Scholes, and nodes (M+1).
+
+static const Option kContracts[] = {
+    Option(100, 100, 1.0, 0.05, 0.20, OptionType::Call),
+    Option(90, 100, 0.25, 0.05, 0.30, OptionType::Put),
+    Option(113, 100, 0.1, 0.05, 0.15, OptionType::Call),
+    Option(100, 100, 2.0, 0.03, 0.45, OptionType::Put),
+};
+
+static void BM_GridFamily(benchmark::State& state) {
+    auto grid = static_cast<GridType>(state.range(0));
+    int M = static_cast<int>(state.range(1));
+    PDESolver solver(M, 1000, grid);
+    solver.setRannacherSteps(2);
+
+    double max_err = 0.0, sum_err = 0.0;
+    for (auto _ : state) {
+        max_err = sum_err = 0.0;
+        for (const Option& opt : kContracts) {
+            double err = std::abs(solver.priceEuropean(opt) - BlackScholes::price(opt));
+            max_err = std::max(max_err, err);
+            sum_err += err;
+        }
+    }
+    state.counters["max_err"] = max_err;
+    state.counters["mean_err"] = sum_err / 4.0;
+    state.counters["nodes"] = M + 1;
+}
+
+BENCHMARK(BM_GridFamily)
+    ->ArgsProduct({{static_cast<int>(GridType::Uniform), static_cast<int>(GridType::Adaptive),
+                    static_cast<int>(GridType::Sinh), static_cast<int>(GridType::SinhRefined)},
+                   {50, 100, 200, 400}})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "HestonSolver.hpp"
+
+// One ATM call under Fang and Oosterlee's Heston parameters on a 200x100
+// (S x v) grid with 100 time steps, per ADI scheme and thread count.
+// abs_err is against the semi-analytic price.
+static const HestonParams kModel{0.0175, 1.5768, 0.0398, 0.5751, -0.5711};
+
+static void BM_HestonAdi(benchmark::State& state) {
+    AdiScheme scheme = static_cast<AdiScheme>(state.range(0));
+    int threads = static_cast<int>(state.range(1));
+    Option call(100, 100, 1.0, 0.0, 0.2, OptionType::Call);
+    HestonSolver solver(200, 100, 100, scheme, threads);
+    solver.setRannacherSteps(2);
+    double price = 0.0;
+    for (auto _ : state) {
+        price = solver.price(call, kModel);
+        benchmark::DoNotOptimize(price);
+    }
+    state.counters["abs_err"] = std::abs(price - hestonPrice(call, kModel));
+}
+
+static void schemesAndThreads(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"scheme", "threads"});
+    int hw = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int scheme = 0; scheme < 3; ++scheme) {
+        for (int t = 1; t < hw; t *= 2)
+            b->Args({scheme, t});
+        b->Args({scheme, hw});
+    }
+}
+
+static void BM_HestonClosedForm(benchmark::State& state) {
+    Option call(100, 100, 1.0, 0.0, 0.2, OptionType::Call);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(hestonPrice(call, kModel));
+}
+
+BENCHMARK(BM_HestonAdi)->Apply(schemesAndThreads)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HestonClosedForm)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "BlackScholes.hpp"
+#include "ImpliedVol.hpp"
+
+// A quote book over strikes 60..160, expiries 1M..2Y and a vol smile;
+// European quotes are Black-Scholes prices, American ones 200x200 Sinh
+// PDE prices (the solver's default prototype).
+static void quotes(int count, ExerciseType exercise, std::vector<Option>& options,
+                   std::vector<double>& prices) {
+    PDESolver pricer(200, 200, GridType::Sinh);
+    pricer.setRannacherSteps(2);
+    pricer.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+    for (int i = 0; i < count; ++i) {
+        double K = 60.0 + (i * 37 % 101);
+        double T = 1.0 / 12 + (i * 13 % 24) / 12.0;
+        double sigma = 0.15 + 0.2 * std::abs(K - 100.0) / 60.0;
+        OptionType type = K < 100.0 ? OptionType::Put : OptionType::Call;
+        Option option(100, K, T, 0.03, sigma, type, exercise);
+        options.push_back(option);
+        prices.push_back(exercise == ExerciseType::European ? BlackScholes::price(option)
+                                                            : pricer.price(option));
+    }
+}
+
+static void run(benchmark::State& state, ExerciseType exercise, int count) {
+    std::vector<Option> options;
+    std::vector<double> prices;
+    quotes(count, exercise, options, prices);
+    ImpliedVolSolver solver(static_cast<int>(state.range(0)));
+    std::vector<ImpliedVolResult> out(count);
+    for (auto _ : state) {
+        solver.solveBatch(options.data(), prices.data(), options.size(), out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    double iterations = 0.0;
+    for (const ImpliedVolResult& r : out)
+        iterations += r.iterations;
+    state.counters["iterations"] = iterations / count;
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_ImpliedVolEuropean(benchmark::State& state) {
+    run(state, ExerciseType::European, 10000);
+}
+
+static void BM_ImpliedVolAmerican(benchmark::State& state) {
+    run(state, ExerciseType::American, 64);
+}
+
+BENCHMARK(BM_ImpliedVolEuropean)->Arg(1)->Arg(0)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(BM_ImpliedVolAmerican)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
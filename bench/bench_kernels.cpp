@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "Grid.hpp"
+#include "SolverKernels.hpp"
+#include "Tridiagonal.hpp"
+
+// Per-step kernels of the solver on a uniform grid of state.range(0)
+// intervals: operator assembly with the closed-form uniform stencil vs the
+// general non-uniform one, and a Crank-Nicolson step as a separate RHS
+// product followed by solve() vs the fused solveProduct().
+
+namespace {
+
+struct Step {
+    std::vector<double> a, b, c, ea, eb, ec, V, rhs;
+    TridiagonalLU lu;
+
+    explicit Step(int M) {
+        UniformGrid grid(300.0, M);
+        int n = grid.size();
+        a.resize(n); b.resize(n); c.resize(n);
+        kernels::fillOperator<kernels::UniformSpacing>(grid.nodes().data(), n, 0.2, 0.05,
+                                                       a.data(), b.data(), c.data());
+        double h = 0.5 / 200;
+        std::vector<double> lower(n), diag(n), upper(n);
+        ea.resize(n); eb.resize(n); ec.resize(n);
+        for (int i = 0; i < n; ++i) {
+            lower[i] = -h * a[i]; diag[i] = 1.0 - h * b[i]; upper[i] = -h * c[i];
+            ea[i] = h * a[i];     eb[i] = 1.0 + h * b[i];   ec[i] = h * c[i];
+        }
+        lu.factor(lower, diag, upper);
+        V.resize(n);
+        kernels::fillPayoff<kernels::PutPayoff>(grid.nodes().data(), n, 100.0, V.data());
+        rhs.resize(n);
+    }
+};
+
+}  // namespace
+
+template <class Spacing>
+static void BM_FillOperator(benchmark::State& state) {
+    UniformGrid grid(300.0, static_cast<int>(state.range(0)));
+    int n = grid.size();
+    std::vector<double> a(n), b(n), c(n);
+    for (auto _ : state) {
+        kernels::fillOperator<Spacing>(grid.nodes().data(), n, 0.2, 0.05,
+                                       a.data(), b.data(), c.data());
+        benchmark::DoNotOptimize(a.data());
+        benchmark::ClobberMemory();
+    }
+}
+
+static void BM_StepTwoPass(benchmark::State& state) {
+    Step s(static_cast<int>(state.range(0)));
+    int n = static_cast<int>(s.V.size());
+    for (auto _ : state) {
+        s.rhs[0] = s.V[0];
+        for (int i = 1; i < n - 1; ++i)
+            s.rhs[i] = s.ea[i] * s.V[i - 1] + s.eb[i] * s.V[i] + s.ec[i] * s.V[i + 1];
+        s.rhs[n - 1] = s.V[n - 1];
+        s.lu.solve(s.rhs, s.V);
+        benchmark::DoNotOptimize(s.V.data());
+    }
+}
+
+static void BM_StepFused(benchmark::State& state) {
+    Step s(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        s.lu.solveProduct(s.ea.data(), s.eb.data(), s.ec.data(), s.V, s.V);
+        benchmark::DoNotOptimize(s.V.data());
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_FillOperator, kernels::UniformSpacing)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_FillOperator, kernels::GeneralSpacing)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_StepTwoPass)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_StepFused)->RangeMultiplier(4)->Range(64, 4096);
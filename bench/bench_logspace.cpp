@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "BlackScholes.hpp"
+#include "PDESolver.hpp"
+#include "SetupCache.hpp"
+
+// S-space against log-space grids. Args start with the GridType.
+
+// A 41-strike ladder (80..120) of 1-year European puts at spot 100,
+// priced with a SetupCache on M = 400 intervals and state.range(1) time
+// steps. S-space setups are keyed on the strike, log-space ones are
+// not: one factorization serves the whole ladder. Counters: misses and
+// max_err against Black-Scholes.
+static void BM_StrikeLadder(benchmark::State& state) {
+    auto grid = static_cast<GridType>(state.range(0));
+    PDESolver solver(400, static_cast<int>(state.range(1)), grid);
+    solver.setRannacherSteps(2);
+    auto cache = std::make_shared<SetupCache>(64);
+    solver.setSetupCache(cache);
+    std::vector<Option> book;
+    for (int k = 0; k <= 40; ++k)
+        book.emplace_back(100, 80.0 + k, 1.0, 0.05, 0.2, OptionType::Put);
+
+    double max_err = 0.0;
+    for (auto _ : state) {
+        cache->clear();
+        max_err = 0.0;
+        for (const Option& opt : book)
+            max_err = std::max(max_err, std::abs(solver.priceEuropean(opt) -
+                                                 BlackScholes::price(opt)));
+    }
+    state.SetItemsProcessed(state.iterations() * book.size());
+    state.counters["misses"] = static_cast<double>(cache->stats().misses) / state.iterations();
+    state.counters["max_err"] = max_err;
+}
+
+// One uncached ATM put on M = N = state.range(1): grid, assembly,
+// factorization and M steps. Counter: abs_err.
+static void BM_PriceSpace(benchmark::State& state) {
+    auto grid = static_cast<GridType>(state.range(0));
+    int M = static_cast<int>(state.range(1));
+    PDESolver solver(M, M, grid);
+    solver.setRannacherSteps(2);
+    Option opt(100, 100, 1.0, 0.05, 0.2, OptionType::Put);
+    double price = 0.0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(price = solver.priceEuropean(opt));
+    state.counters["abs_err"] = std::abs(price - BlackScholes::price(opt));
+}
+
+static const std::vector<int64_t> kGrids = {
+    static_cast<int>(GridType::Uniform), static_cast<int>(GridType::Sinh),
+    static_cast<int>(GridType::LogUniform), static_cast<int>(GridType::LogSinh)};
+
+BENCHMARK(BM_StrikeLadder)->ArgsProduct({kGrids, {25, 200}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PriceSpace)->ArgsProduct({kGrids, {200, 800}})->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "Option.hpp"
+#include "PDESolver.hpp"
+#include "PartitionedTridiagonal.hpp"
+#include "Tridiagonal.hpp"
+
+// One Crank-Nicolson step, LHS^-1 (RHS V), on a system of n rows with
+// dt / h^2 = 50: the Thomas solve (threads = 0) against the partitioned
+// one on a pool of `threads`. The crossover in n sets
+// PartitionedTridiagonalLU::kMinRows. V is a shifted ramp, which the
+// steps leave unchanged, so every iteration sees the same (normal) values.
+static void BM_TridiagonalSolve(benchmark::State& state) {
+    int n = static_cast<int>(state.range(0));
+    int threads = static_cast<int>(state.range(1));
+    const double r = 50.0;
+    std::vector<double> lower(n, -0.5 * r), diag(n, 1.0 + r), upper(n, -0.5 * r);
+    std::vector<double> ea(n, 0.5 * r), eb(n, 1.0 - r), ec(n, 0.5 * r);
+    std::vector<double> V(n), work;
+    lower[0] = upper[0] = lower[n - 1] = upper[n - 1] = 0.0;
+    diag[0] = diag[n - 1] = 1.0;
+    ea[0] = ec[0] = ea[n - 1] = ec[n - 1] = 0.0;
+    eb[0] = eb[n - 1] = 1.0;
+    for (int i = 0; i < n; ++i)
+        V[i] = 1.0 + std::max(0.0, i - 0.5 * n);
+
+    TridiagonalLU thomas;
+    PartitionedTridiagonalLU partitioned;
+    std::unique_ptr<WorkStealingPool> pool;
+    if (threads == 0) {
+        thomas.factor(lower, diag, upper);
+    } else {
+        partitioned.factor(lower, diag, upper);
+        pool = std::make_unique<WorkStealingPool>(threads);
+    }
+
+    for (auto _ : state) {
+        if (threads == 0)
+            thomas.solveProduct(ea.data(), eb.data(), ec.data(), V, V);
+        else
+            partitioned.solveProduct(ea.data(), eb.data(), ec.data(), V, V, work, pool.get());
+        benchmark::DoNotOptimize(V.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void sizesAndThreads(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"n", "threads"});
+    int hw = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int n : {1026, 2048, 4096, 8192, 16384, 65536, 262144}) {
+        b->Args({n, 0});
+        for (int t = 1; t < hw; t *= 2)
+            b->Args({n, t});
+        b->Args({n, hw});
+    }
+}
+
+BENCHMARK(BM_TridiagonalSolve)->Apply(sizesAndThreads)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+// A European call on a Sinh grid of M intervals and 200 time steps,
+// without a solve pool (threads = 0) and with one of `threads`.
+static void BM_LargeGridEuropean(benchmark::State& state) {
+    int M = static_cast<int>(state.range(0));
+    int threads = static_cast<int>(state.range(1));
+    Option call(100, 100, 1.0, 0.05, 0.2, OptionType::Call);
+    PDESolver solver(M, 200, GridType::Sinh);
+    if (threads > 0)
+        solver.setSolvePool(std::make_shared<WorkStealingPool>(threads));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(solver.priceEuropean(call));
+}
+
+static void gridsAndThreads(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"M", "threads"});
+    int hw = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int M : {2000, 8000, 32000}) {
+        b->Args({M, 0});
+        for (int t = 2; t < hw; t *= 2)
+            b->Args({M, t});
+        if (hw > 1)
+            b->Args({M, hw});
+    }
+}
+
+BENCHMARK(BM_LargeGridEuropean)->Apply(gridsAndThreads)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "BatchFile.hpp"
+#include "BatchPipeline.hpp"
+#include "BatchPricer.hpp"
+
+// File I/O around the pricer: 200k options through a 20x4 uniform solver
+// (~1 us per price), so parsing and formatting are a visible share of the
+// work. Output goes to /dev/null.
+static const int kOptions = 200000;
+
+static PDESolver cheapSolver() {
+    return PDESolver(20, 4, GridType::Uniform);
+}
+
+static const std::string& inputFile(BatchFormat format) {
+    static std::string paths[2];
+    std::string& path = paths[format == BatchFormat::CSV ? 0 : 1];
+    if (path.empty()) {
+        std::vector<Option> options;
+        for (int i = 0; i < kOptions; ++i)
+            options.emplace_back(100.0, 60.0 + (i * 37 % 1001) * 0.1, 0.1 + (i % 97) * 0.02, 0.03,
+                                 0.1 + (i % 41) * 0.01, i % 2 ? OptionType::Call : OptionType::Put);
+        path = std::string("/tmp/pde_bench_book") + (format == BatchFormat::CSV ? ".csv" : ".bin");
+        writeOptionFile(path, options, format);
+    }
+    return path;
+}
+
+// What a hand-rolled wrapper does: getline, stringstream parsing,
+// BatchPricer on the whole book, iostream output.
+static void BM_BatchIostream(benchmark::State& state) {
+    const std::string& path = inputFile(BatchFormat::CSV);
+    BatchPricer pricer(cheapSolver(), 0);
+    for (auto _ : state) {
+        std::ifstream in(path);
+        std::ofstream out("/dev/null");
+        std::vector<Option> options;
+        std::string line;
+        std::getline(in, line);
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            double v[5];
+            char comma, type, exercise;
+            fields >> v[0] >> comma >> v[1] >> comma >> v[2] >> comma >> v[3] >> comma >> v[4] >>
+                comma >> type >> comma >> exercise;
+            options.emplace_back(v[0], v[1], v[2], v[3], v[4],
+                                 type == 'C' ? OptionType::Call : OptionType::Put,
+                                 exercise == 'A' ? ExerciseType::American : ExerciseType::European);
+        }
+        std::vector<double> prices = pricer.priceBatch(options);
+        out << "index,price\n";
+        for (std::size_t i = 0; i < prices.size(); ++i)
+            out << i << ',' << prices[i] << '\n';
+    }
+    state.SetItemsProcessed(state.iterations() * kOptions);
+}
+
+static void BM_BatchPipeline(benchmark::State& state) {
+    BatchFormat format = state.range(0) ? BatchFormat::Binary : BatchFormat::CSV;
+    const std::string& path = inputFile(format);
+    BatchPipeline pipeline(cheapSolver(), 0);
+    PipelineStats stats;
+    for (auto _ : state) {
+        std::FILE* out = std::fopen("/dev/null", "wb");
+        stats = pipeline.run(path, out);
+        std::fclose(out);
+    }
+    state.counters["parse_s"] = stats.parse_seconds;
+    state.counters["price_s"] = stats.price_seconds;
+    state.counters["format_s"] = stats.format_seconds;
+    state.SetItemsProcessed(state.iterations() * kOptions);
+}
+
+BENCHMARK(BM_BatchIostream)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_BatchPipeline)->ArgName("binary")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
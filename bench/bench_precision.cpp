@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "BlackScholes.hpp"
+#include "PDESolver.hpp"
+
+// Throughput against accuracy per Precision (0 Double, 1 Single, 2 Mixed).
+// solve_err is the largest relative difference from the double solve on
+// the same grid, i.e. what the mode itself costs; bs_err the largest
+// absolute error against Black-Scholes, which includes the discretization.
+static std::vector<Option> makeBook(int count) {
+    std::vector<Option> book;
+    for (int i = 0; i < count; ++i) {
+        OptionType type = (i % 2 == 0) ? OptionType::Call : OptionType::Put;
+        book.emplace_back(80.0 + 0.6 * i, 100.0, 0.25 + 0.02 * i, 0.05,
+                          0.15 + 0.005 * i, type);
+    }
+    return book;
+}
+
+static void setErrors(benchmark::State& state, const std::vector<Option>& book,
+                      const std::vector<double>& price, const std::vector<double>& reference) {
+    double solve_err = 0.0, bs_err = 0.0;
+    for (std::size_t i = 0; i < book.size(); ++i) {
+        solve_err = std::max(solve_err, std::abs(price[i] / reference[i] - 1.0));
+        bs_err = std::max(bs_err, std::abs(price[i] - BlackScholes::price(book[i])));
+    }
+    state.counters["solve_err"] = solve_err;
+    state.counters["bs_err"] = bs_err;
+}
+
+static const char* modeName(Precision p) {
+    return p == Precision::Double ? "double" : p == Precision::Single ? "single" : "mixed";
+}
+
+// 64 options one at a time on M x 200 Sinh grids, Double against Mixed;
+// scalar prices in Single run in double.
+static void BM_PrecisionScalar(benchmark::State& state) {
+    Precision mode = static_cast<Precision>(state.range(0));
+    int M = static_cast<int>(state.range(1));
+    auto book = makeBook(64);
+    PDESolver solver(M, 200, GridType::Sinh);
+    std::vector<double> price(book.size()), reference(book.size());
+    for (std::size_t i = 0; i < book.size(); ++i)
+        reference[i] = solver.priceEuropean(book[i]);
+    solver.setPrecision(mode);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < book.size(); ++i)
+            price[i] = solver.priceEuropean(book[i]);
+        benchmark::DoNotOptimize(price.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(book.size()));
+    setErrors(state, book, price, reference);
+    state.SetLabel(modeName(mode));
+}
+
+// The same book through priceEuropeanBatch() on the 200x200 adaptive
+// layout of BM_EuropeanLanes; Single and Mixed run twice as many lanes
+// per sweep.
+static void BM_PrecisionBatch(benchmark::State& state) {
+    Precision mode = static_cast<Precision>(state.range(0));
+    auto book = makeBook(64);
+    PDESolver solver(200, 200, GridType::Adaptive);
+    std::vector<double> price(book.size()), reference(book.size());
+    solver.priceEuropeanBatch(book.data(), book.size(), reference.data());
+    solver.setPrecision(mode);
+    for (auto _ : state) {
+        solver.priceEuropeanBatch(book.data(), book.size(), price.data());
+        benchmark::DoNotOptimize(price.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(book.size()));
+    setErrors(state, book, price, reference);
+    state.SetLabel(modeName(mode));
+}
+
+BENCHMARK(BM_PrecisionScalar)
+    ->ArgNames({"mode", "M"})
+    ->ArgsProduct({{0, 2}, {200, 2000}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PrecisionBatch)->ArgName("mode")->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include "BlackScholes.hpp"
+#include "PDESolver.hpp"
+
+// Error vs wall-clock time for the three time-stepping schemes on a
+// 3-month ATM put, with N = M / 4 time steps. Each benchmark reports the
+// absolute error against Black-Scholes (abs_err) and the total number of
+// space-time nodes solved (nodes); compare rows at equal abs_err.
+
+enum Scheme { CrankNicolson, Rannacher, RannacherRichardson };
+
+static void BM_TimeStepping(benchmark::State& state) {
+    auto scheme = static_cast<Scheme>(state.range(0));
+    int M = static_cast<int>(state.range(1));
+    int N = M / 4;
+    Option opt(100, 100, 0.25, 0.05, 0.2, OptionType::Put);
+    double exact = BlackScholes::price(opt);
+
+    PDESolver solver(M, N, true);
+    if (scheme != CrankNicolson)
+        solver.setRannacherSteps(2);
+
+    double price = 0.0;
+    for (auto _ : state) {
+        price = scheme == RannacherRichardson ? solver.priceExtrapolated(opt)
+                                              : solver.priceEuropean(opt);
+        benchmark::DoNotOptimize(price);
+    }
+    double nodes = static_cast<double>(M) * N;
+    if (scheme == RannacherRichardson)
+        nodes *= 5.0;   // (M, N) plus (2M, 2N)
+    state.counters["abs_err"] = std::abs(price - exact);
+    state.counters["nodes"] = nodes;
+}
+
+static void schemeArgs(benchmark::internal::Benchmark* b) {
+    for (int scheme : {CrankNicolson, Rannacher})
+        for (int M : {100, 200, 400, 800, 1600, 3200})
+            b->Args({scheme, M});
+    for (int M : {50, 100, 200, 400})
+        b->Args({RannacherRichardson, M});
+}
+
+BENCHMARK(BM_TimeStepping)->Apply(schemeArgs)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "PricingClient.hpp"
+#include "PricingServer.hpp"
+
+// Round trips through an in-process PricingServer on a Unix socket: 4
+// connections x 16 in flight, a book of 2000 Europeans on 40 shapes
+// (strikes vary within a shape). Argument: max_batch. With 1 every
+// request is its own batch and its own solve; with 64 same-shape
+// contracts share lane solves and the setup cache.
+static const std::size_t kRequests = 4000;
+
+static std::vector<Option> serverBook() {
+    std::vector<Option> book;
+    for (int i = 0; i < 2000; ++i)
+        book.emplace_back(100.0, 80.0 + (i * 7) % 41, 0.25 * (1 + i % 4), 0.03,
+                          0.15 + 0.05 * (i / 4 % 5), i / 20 % 2 ? OptionType::Call : OptionType::Put);
+    return book;
+}
+
+static void BM_ServerRoundTrip(benchmark::State& state) {
+    PDESolver prototype(100, 50, GridType::Sinh);
+    ServerConfig config;
+    config.max_batch = static_cast<std::size_t>(state.range(0));
+    PricingServer server(prototype, config);
+    std::string path = "/tmp/pde_bench_server." + std::to_string(::getpid());
+    server.listenUnix(path);
+
+    std::vector<Option> book = serverBook();
+    LoadConfig load;
+    load.unix_path = path;
+    load.requests = kRequests;
+    LoadReport report;
+    for (auto _ : state)
+        report = runLoad(load, book);
+    server.stop();
+
+    state.counters["p50_us"] = report.latency.percentile(0.5) * 1e-3;
+    state.counters["p99_us"] = report.latency.percentile(0.99) * 1e-3;
+    state.counters["mean_batch"] = server.stats().meanBatch();
+    state.SetItemsProcessed(state.iterations() * kRequests);
+}
+
+BENCHMARK(BM_ServerRoundTrip)->ArgName("max_batch")->Arg(1)->Arg(64)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
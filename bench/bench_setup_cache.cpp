@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+#include "PDESolver.hpp"
+#include "SetupCache.hpp"
+
+// A spot ladder of 64 European puts sharing strike, vol, rate and
+// maturity, priced with and without a SetupCache on an Adaptive grid of
+// state.range(0) intervals and state.range(1) time steps. Few time steps
+// make grid and LHS setup a large share of each price.
+
+static std::vector<Option> ladder() {
+    std::vector<Option> book;
+    for (int i = 0; i < 64; ++i)
+        book.emplace_back(70.0 + i, 100, 0.5, 0.05, 0.2, OptionType::Put);
+    return book;
+}
+
+static void run(benchmark::State& state, bool cached) {
+    PDESolver solver(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)),
+                     GridType::Adaptive);
+    auto cache = std::make_shared<SetupCache>();
+    if (cached)
+        solver.setSetupCache(cache);
+    std::vector<Option> book = ladder();
+    for (auto _ : state)
+        for (const Option& opt : book)
+            benchmark::DoNotOptimize(solver.priceEuropean(opt));
+    state.SetItemsProcessed(state.iterations() * book.size());
+    if (cached)
+        state.counters["misses"] = static_cast<double>(cache->stats().misses);
+}
+
+static void BM_LadderUncached(benchmark::State& state) { run(state, false); }
+static void BM_LadderCached(benchmark::State& state) { run(state, true); }
+
+static void ladderArgs(benchmark::internal::Benchmark* b) {
+    for (int M : {200, 800})
+        for (int N : {10, 50, 200})
+            b->Args({M, N});
+}
+
+BENCHMARK(BM_LadderUncached)->Apply(ladderArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LadderCached)->Apply(ladderArgs)->Unit(benchmark::kMicrosecond);
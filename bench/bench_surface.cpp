@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "PDESolver.hpp"
+
+// A 41-point spot ladder (80..120) on one contract.
+static std::vector<double> ladder() {
+    std::vector<double> spots;
+    for (int k = 0; k <= 40; ++k)
+        spots.push_back(80.0 + k);
+    return spots;
+}
+
+// One full solve per ladder point.
+static void BM_SpotLadderResolve(benchmark::State& state) {
+    auto spots = ladder();
+    PDESolver solver(200, 200, true);
+    for (auto _ : state)
+        for (double S : spots)
+            benchmark::DoNotOptimize(solver.priceEuropean(
+                Option(S, 100, 1.0, 0.05, 0.2, OptionType::Call)));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(spots.size()));
+}
+
+// One solve, then the whole ladder off the surface.
+static void BM_SpotLadderSurface(benchmark::State& state) {
+    auto spots = ladder();
+    std::vector<double> out(spots.size());
+    PDESolver solver(200, 200, true);
+    Option opt(100, 100, 1.0, 0.05, 0.2, OptionType::Call);
+    for (auto _ : state) {
+        PriceSurface surface = solver.priceSurface(opt);
+        surface.evaluate(spots.data(), spots.size(), out.data(), Interpolation::Cubic);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(spots.size()));
+}
+
+BENCHMARK(BM_SpotLadderResolve)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SpotLadderSurface)->Unit(benchmark::kMicrosecond);
+
+// A same-strike strip of 1M, 3M, 6M and 1Y puts, M = 200 and ~200 steps
+// per year: one solve per tenor against one sweep over the longest.
+static const std::vector<double> kStrip = {1.0 / 12, 0.25, 0.5, 1.0};
+
+static void BM_MaturityStripResolve(benchmark::State& state) {
+    std::vector<PDESolver> solvers;
+    for (double T : kStrip)
+        solvers.emplace_back(200, static_cast<int>(200 * T), true);
+    for (auto _ : state)
+        for (std::size_t i = 0; i < kStrip.size(); ++i)
+            benchmark::DoNotOptimize(solvers[i].priceEuropean(
+                Option(100, 100, kStrip[i], 0.05, 0.2, OptionType::Put)));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kStrip.size()));
+}
+
+static void BM_MaturityStripSweep(benchmark::State& state) {
+    PDESolver solver(200, 200, true);
+    Option opt(100, 100, 1.0, 0.05, 0.2, OptionType::Put);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(solver.priceMaturities(opt, kStrip));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kStrip.size()));
+}
+
+BENCHMARK(BM_MaturityStripResolve)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MaturityStripSweep)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,134 @@
+"""
+Performance regression gate for pde_bench.
+
+Runs the core benchmarks (bench_core.cpp plus the operator and
+Crank-Nicolson step kernels), writes Google Benchmark JSON, and compares
+each benchmark's fastest repetition against a checked-in baseline. Times
+are taken relative to BM_Calibration, so a uniformly faster or slower host
+leaves the ratios unchanged. A benchmark fails when its ratio grew by more
+than the threshold, and still does when re-measured in a fresh process.
+
+Usage:
+    python3 bench/perf_gate.py --bench build/bench/pde_bench \
+        --baseline bench/baseline.json [--threshold 15] [--out results.json]
+    python3 bench/perf_gate.py ... --update     # rewrite the baseline
+
+Registered as the ctest `perf_regression` with -DPDE_PERF_GATE=ON.
+"""
+
+import argparse
+import json
+import re
+import subprocess
+import sys
+
+CORE_FILTER = ("^BM_(Calibration|ThomasSolve|FactoredSolve|GridBuild|BlackScholesPrice|"
+               "PriceEuropean|PriceAmerican|StepFused|FillOperator)")
+CALIBRATION = "BM_Calibration"
+
+
+def run_bench(binary, out, repetitions, bench_filter=CORE_FILTER):
+    cmd = [binary,
+           "--benchmark_filter=" + bench_filter,
+           "--benchmark_repetitions=%d" % repetitions,
+           "--benchmark_min_time=0.05",
+           "--benchmark_enable_random_interleaving=true",
+           "--benchmark_out=" + out,
+           "--benchmark_out_format=json"]
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+    with open(out) as f:
+        return json.load(f)
+
+
+def fastest(report):
+    """Fastest repetition's real time (ns) per benchmark name. Noise on a
+    shared host only ever adds time, so the minimum is the most stable
+    statistic."""
+    scale = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+    times = {}
+    for b in report["benchmarks"]:
+        if b.get("run_type", "iteration") != "iteration":
+            continue
+        t = b["real_time"] * scale[b.get("time_unit", "ns")]
+        name = b.get("run_name", b["name"])
+        times[name] = min(t, times.get(name, t))
+    return times
+
+
+def relative(times):
+    calibration = times[CALIBRATION]
+    return {name: t / calibration for name, t in times.items() if name != CALIBRATION}
+
+
+def merge(times, more):
+    for name, t in more.items():
+        times[name] = min(t, times.get(name, t))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    parser.add_argument("--bench", required=True, help="path to pde_bench")
+    parser.add_argument("--baseline", required=True, help="baseline JSON")
+    parser.add_argument("--threshold", type=float, default=15.0,
+                        help="allowed slowdown in percent (default 15)")
+    parser.add_argument("--out", default="pde_bench_results.json",
+                        help="where to write the Google Benchmark JSON")
+    parser.add_argument("--repetitions", type=int, default=5)
+    parser.add_argument("--retries", type=int, default=2,
+                        help="re-measure slow benchmarks this many times (default 2)")
+    parser.add_argument("--update", action="store_true",
+                        help="write the current timings as the new baseline")
+    args = parser.parse_args()
+
+    times = fastest(run_bench(args.bench, args.out, args.repetitions))
+    ratios = relative(times)
+
+    if args.update:
+        with open(args.baseline, "w") as f:
+            json.dump({"calibration_ns": times[CALIBRATION], "ratios": ratios}, f,
+                      indent=2, sort_keys=True)
+            f.write("\n")
+        print("wrote %d baseline ratios to %s" % (len(ratios), args.baseline))
+        return 0
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)["ratios"]
+
+    limit = 1.0 + args.threshold / 100.0
+
+    # Code layout and heap placement differ between processes, which moves
+    # sub-microsecond benchmarks by tens of percent. A slowdown only counts
+    # if it persists in fresh processes.
+    for _ in range(args.retries):
+        slow = [n for n in baseline if n in ratios and ratios[n] / baseline[n] > limit]
+        if not slow:
+            break
+        names = "|".join(re.escape(n) for n in slow + [CALIBRATION])
+        merge(times, fastest(run_bench(args.bench, args.out + ".retry", args.repetitions,
+                                       "^(%s)$" % names)))
+        ratios = relative(times)
+
+    failures = 0
+    for name in sorted(baseline):
+        if name not in ratios:
+            print("MISSING  %s" % name)
+            failures += 1
+            continue
+        change = ratios[name] / baseline[name]
+        status = "SLOWER" if change > limit else "ok"
+        if change > limit:
+            failures += 1
+        print("%-8s %-50s %+7.1f%%" % (status, name, 100.0 * (change - 1.0)))
+    for name in sorted(set(ratios) - set(baseline)):
+        print("NEW      %s (not in baseline)" % name)
+
+    if failures:
+        print("%d benchmark(s) regressed by more than %.0f%% or are missing"
+              % (failures, args.threshold))
+        return 1
+    print("all %d benchmarks within %.0f%% of the baseline" % (len(baseline), args.threshold))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
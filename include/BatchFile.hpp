@@ -0,0 +1,106 @@
+#pragma once
+#include "Option.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Option files for the batch pricer (BatchPipeline.hpp, `pde_pricer
+// batch`), in one of two formats.
+//
+// CSV: one option per line,
+//
+//   S,K,T,r,sigma,type[,exercise]
+//
+// with type C/P (or call/put) and exercise E/A (or european/american,
+// default European), case-insensitive. Blank lines and lines starting
+// with '#' are skipped, as is a first line that is not numeric (a
+// header). Fields may be padded with spaces; CRLF line ends are fine.
+//
+// Binary: a 16-byte header, the magic "PDEOPTS1" and the record size as
+// a little-endian uint32 followed by 4 zero bytes, then one 48-byte
+// record per option:
+//
+//   offset  0  double S, K, T, r, sigma (little-endian IEEE 754)
+//   offset 40  uint8 type (0 call, 1 put)
+//   offset 41  uint8 exercise (0 European, 1 American)
+//   offset 42  6 zero bytes
+//
+// Records are fixed-width, so a chunk of the file is split across
+// threads by arithmetic alone and decoding is a copy. Files are written
+// and read in the host byte order, which the format requires to be
+// little-endian.
+enum class BatchFormat { CSV, Binary };
+
+// One option as read from a file, before validation. `line` is the
+// 1-based line (CSV) or record (binary) number; `error` is null, or
+// names what is wrong with the row (a static string).
+struct OptionRecord {
+    double S, K, T, r, sigma;
+    OptionType type;
+    ExerciseType exercise;
+    std::uint64_t line;
+    const char* error;
+};
+
+namespace batchfile {
+
+constexpr char kMagic[8] = {'P', 'D', 'E', 'O', 'P', 'T', 'S', '1'};
+constexpr std::size_t kHeaderSize = 16;
+constexpr std::size_t kRecordSize = 48;
+
+// Binary if the data starts with the magic, CSV otherwise.
+BatchFormat detect(const char* data, std::size_t size);
+
+// Offset of the first CSV line to parse: past a header line, if any.
+// `lines` receives the number of lines skipped.
+std::size_t csvStart(const char* data, std::size_t size, std::uint64_t& lines);
+
+// Parses one CSV line [begin, end), without its '\n'. Returns false for
+// a blank or comment line; otherwise fills `out` (with out.error set if
+// the line is malformed) and returns true.
+bool parseCsvLine(const char* begin, const char* end, OptionRecord& out);
+
+// Number of records in a binary file; throws std::runtime_error if the
+// header names another record size or the data is not a whole number of
+// records.
+std::size_t recordCount(const char* data, std::size_t size);
+
+// Decodes the binary record at `data` (kRecordSize bytes), or encodes
+// `option` into one.
+void decodeRecord(const char* data, OptionRecord& out);
+void encodeRecord(const Option& option, char* out);
+
+}  // namespace batchfile
+
+// Read-only memory map of a whole file. Pages are read from disk as they
+// are first touched; release() drops a range already consumed, so
+// resident memory stays bounded while a large file is streamed through.
+// Pipes and devices are rejected with std::runtime_error; where mmap is
+// unavailable, files are read into memory instead.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);   // throws std::runtime_error
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const;
+    std::size_t size() const;
+
+    // Hint that [begin, end) will not be read again.
+    void release(std::size_t begin, std::size_t end);
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<char> buffer_;   // without mmap
+};
+
+// Whole-file helpers, for converting and for tests. readOptionFile
+// throws std::runtime_error naming the first malformed or invalid row.
+std::vector<Option> readOptionFile(const std::string& path);
+void writeOptionFile(const std::string& path, const std::vector<Option>& options,
+                     BatchFormat format);
@@ -0,0 +1,64 @@
+#pragma once
+#include "PDESolver.hpp"
+#include "ThreadPool.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Outcome of one BatchPipeline::run().
+struct PipelineStats {
+    std::size_t records = 0;    // options read
+    std::size_t rejected = 0;   // malformed or invalid rows, written as nan
+    std::string first_error;    // e.g. "line 12: malformed number"; empty if none
+
+    // Wall time of the run, and of its stages on the producing thread.
+    // stall_seconds is time spent waiting for the writer, non-zero only
+    // when output is the bottleneck.
+    double seconds = 0.0;
+    double parse_seconds = 0.0, price_seconds = 0.0, format_seconds = 0.0;
+    double stall_seconds = 0.0;
+
+    double optionsPerSecond() const;
+};
+
+// Prices an option file of any size (BatchFile.hpp: CSV or binary) in
+// bounded memory, streaming "index,price" lines to a FILE*.
+//
+// The file is memory-mapped and consumed in chunks of about
+// setChunkBytes() of input. Each chunk goes through three stages on the
+// pool, each a parallelFor over the chunk: parse (the chunk split into
+// blocks at line or record boundaries), price (one option per item,
+// work-stealing as in BatchPricer), and format (the blocks again, into
+// text). A writer thread drains formatted chunks to the output while the
+// next chunk is computed, through a queue of setQueueDepth() chunks;
+// the producer waits when it is full. Chunk buffers are recycled, so
+// resident memory is (depth + 1) chunks of records and text plus the
+// mapped pages of the current chunk, which are released once parsed.
+//
+// Output is one line per option, in input order, after an "index,price"
+// header: the 0-based option index and the price with the shortest
+// round-trip representation. Malformed rows and rows the solver rejects
+// are written with price nan and counted, not fatal. Prices are
+// independent of the thread count and chunk size, as with BatchPricer.
+class BatchPipeline {
+public:
+    // threads = 0 uses std::thread::hardware_concurrency().
+    explicit BatchPipeline(const PDESolver& prototype, int threads = 0);
+
+    // Defaults: 1 MiB of input per chunk, 2 chunks queued for writing.
+    void setChunkBytes(std::size_t bytes);
+    void setQueueDepth(int chunks);
+
+    // Throws std::runtime_error if the input cannot be read or is not a
+    // valid binary file, or if writing fails.
+    PipelineStats run(const std::string& input, std::FILE* out);
+
+    int threads() const;
+
+private:
+    WorkStealingPool pool_;
+    std::vector<PDESolver> solvers_;   // one per pool worker
+    std::size_t chunk_bytes_ = std::size_t(1) << 20;
+    int depth_ = 2;
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include "Option.hpp"
+#include "PDESolver.hpp"
+#include "ThreadPool.hpp"
+#include <cstddef>
+#include <vector>
+
+// Prices a book of options across all cores.
+//
+// Every worker thread owns a copy of the prototype solver, so solver
+// state is never shared. Each option is priced start-to-finish by one
+// worker with an identically configured solver, which makes the result
+// for every option bit-identical whatever the thread count or the order
+// in which work is stolen. American and European contracts may be mixed
+// freely; the work-stealing pool rebalances their very different costs.
+class BatchPricer {
+public:
+    // threads = 0 uses std::thread::hardware_concurrency().
+    explicit BatchPricer(const PDESolver& prototype, int threads = 0);
+
+    // out[i] = price of options[i], for i in [0, count).
+    void priceBatch(const Option* options, std::size_t count, double* out);
+    std::vector<double> priceBatch(const std::vector<Option>& options);
+
+    int threads() const;
+
+private:
+    WorkStealingPool pool_;
+    std::vector<PDESolver> solvers_;   // one per pool worker
+};
@@ -1,10 +1,53 @@
 #pragma once
 #include "Option.hpp"
+#include <cstddef>
+
+// Structure-of-arrays quotes for BlackScholes::priceBatch.
+// Every array holds `count` elements.
+struct BSQuotes {
+    const double* S;
+    const double* K;
+    const double* T;
+    const double* r;
+    const double* sigma;
+    const OptionType* type;
+    std::size_t count;
+};
+
+// Outputs of BlackScholes::priceBatch, one array per quantity, each of
+// `count` elements. theta is dV/dt per year (calendar time), vega and
+// rho are per unit (not per 1%) change.
+struct BSGreeks {
+    double* price;
+    double* delta;   // dV/dS
+    double* gamma;   // d2V/dS2
+    double* vega;    // dV/dsigma
+    double* theta;   // dV/dt
+    double* rho;     // dV/dr
+    double* vanna;   // d2V/dS dsigma
+    double* volga;   // d2V/dsigma2
+};
 
 class BlackScholes {
 public:
     static double price(const Option& option);
     static double delta(const Option& option);
-private:
+    static double gamma(const Option& option);
+    static double vega(const Option& option);
+    static double theta(const Option& option);
+    static double rho(const Option& option);
+
+    // Price and all first/second-order greeks for a batch of quotes in
+    // one pass. d1/d2, the discount factor and N(.) are computed once per
+    // quote with the branch-free approximations in FastMath.hpp, so the
+    // loop vectorizes; agreement with the scalar functions is ~1e-14
+    // relative (see FastMath.hpp for the bounds). Input and output arrays
+    // must not overlap.
+    static void priceBatch(const BSQuotes& in, const BSGreeks& out);
+
+    // Standard normal distribution and density, full double accuracy.
     static double normalCDF(double x);
+    static double normalPDF(double x);
+private:
+    static double d1(const Option& option);
 };
@@ -1,4 +1,5 @@
 #pragma once
+#include <initializer_list>
 #include <vector>
 
 // Spatial grid for the PDE domain [0, S_max].
@@ -21,6 +22,9 @@ protected:
 class UniformGrid : public Grid {
 public:
     UniformGrid(double S_max, int M);
+
+    // Rebuilds the grid in place, reusing its node storage.
+    void assign(double S_max, int M);
 };
 
 // Adaptive grid concentrating points near the strike price.
@@ -41,4 +45,111 @@ public:
     // width    = half-width of the zone as a fraction of K (default 0.25).
     AdaptiveGrid(double S_max, int M_total, double K,
                  double frac = 0.60, double width = 0.25);
+
+    // Rebuilds the grid in place, reusing its node storage.
+    void assign(double S_max, int M_total, double K,
+                double frac = 0.60, double width = 0.25);
+};
+
+// Smoothly stretched grid clustering nodes around one or more centres
+// (typically the strike and the spot).
+//
+// Node density follows
+//
+//   rho(S) = sum_k 1 / sqrt(1 + ((S - c_k) / alpha)^2)
+//
+// whose integral is a sum of asinh terms, so with one centre this is the
+// classical sinh grid S = c + alpha * sinh(xi): spacing ~ alpha near the
+// centre, growing geometrically away from it. Unlike AdaptiveGrid the
+// spacing varies smoothly, which keeps the non-uniform stencils
+// second-order everywhere.
+//
+// Every centre inside (0, S_max) is placed exactly on a node: the
+// intervals between consecutive centres each get a whole number of nodes
+// in proportion to their share of the density.
+class SinhGrid : public Grid {
+public:
+    // M      = total number of spatial intervals.
+    // alpha  = cluster half-width, in units of S.
+    SinhGrid(double S_max, int M, std::vector<double> centres, double alpha);
+
+    // Rebuilds the grid in place. Node storage and the scratch space of
+    // the construction are reused, so once a grid of this size has been
+    // built, rebuilding allocates nothing.
+    void assign(double S_max, int M, std::initializer_list<double> centres, double alpha);
+
+private:
+    std::vector<double> centres_, work_;
+
+    void build(double S_max, int M, double alpha);
+};
+
+// Grid equidistributing a tabulated node density.
+//
+// density[j] >= 0 is sampled at the increasing points at[j], covering
+// [0, S_max], and interpolated linearly between them. Node spacing is
+// then ~ 1 / (M * density). Points in `pins` strictly inside the domain
+// are placed exactly on nodes, as for SinhGrid.
+class DensityGrid : public Grid {
+public:
+    DensityGrid(const std::vector<double>& at, const std::vector<double>& density,
+                int M, std::vector<double> pins);
+};
+
+// Grid in the log-moneyness y = ln(S / K) on [-L, L], with nodes
+// S_i = K exp(y_i) from K exp(-L) to K exp(L).
+//
+// In y the Black-Scholes operator has constant coefficients, so on a
+// uniformly spaced grid (alpha = 0) its stencil is the same three numbers
+// at every node. The spacing in y does not depend on K: grids of two
+// strikes differ only by the scale factor K, and share their operator.
+//
+// With alpha > 0 the nodes are sinh-stretched around the strike,
+// y = alpha * sinh(xi) with xi uniform on either side of y = 0, so
+// spacing is ~ alpha at the strike and grows geometrically away from it.
+// The strike is a node whenever alpha > 0 or M is even.
+class LogGrid : public Grid {
+public:
+    // L      = half-width of the domain in y.
+    // M      = total number of intervals.
+    // alpha  = cluster half-width in y; 0 for uniform spacing.
+    LogGrid(double K, double L, int M, double alpha = 0.0);
+
+    // Rebuilds the grid in place, reusing its node storage.
+    void assign(double K, double L, int M, double alpha = 0.0);
+
+    // y_i = ln(S_i / K), the coordinate the operator is built on.
+    const std::vector<double>& logNodes() const;
+
+private:
+    std::vector<double> y_;
 };
+
+// Spatial grid family.
+//
+//   Uniform      evenly spaced on [0, S_max].
+//   Adaptive     AdaptiveGrid: piecewise uniform, 60% of the nodes within
+//                +-25% of the strike.
+//   Sinh         SinhGrid clustered at the strike and the spot, with
+//                cluster width proportional to the diffusion length
+//                K * sigma * sqrt(T).
+//   SinhRefined  Sinh solve at half resolution, then the final solve on a
+//                DensityGrid equidistributing that solution's local
+//                truncation-error estimate. Roughly 1.25x the cost of Sinh.
+//   LogUniform   LogGrid evenly spaced in ln(S / K): the PDE is solved in
+//                log-moneyness with constant coefficients.
+//   LogSinh      LogGrid clustered at the strike, with cluster width
+//                proportional to sigma * sqrt(T).
+enum class GridType { Uniform, Adaptive, Sinh, SinhRefined, LogUniform, LogSinh };
+
+// Sinh cluster half-width in units of the diffusion length K sigma
+// sqrt(T) (sigma sqrt(T) in ln S, for LogSinh grids).
+constexpr double kSinhWidth = 0.5;
+
+// Domain and Sinh cluster width of the grid of type `grid` for a contract
+// struck at K with spot S, and for log grids the domain's half-width in
+// ln(S / K). `domain` is the default S_max / K; Sinh and log grids widen
+// it to 3 sigma sqrt(T) past the strike (and the spot). PDESolver and
+// DupireSolver both size their grids here.
+struct GridShape { double S_max, alpha, log_width; };
+GridShape gridShape(GridType grid, double domain, double K, double S, double sigma, double T);
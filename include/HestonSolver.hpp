@@ -0,0 +1,140 @@
+#pragma once
+#include "Grid.hpp"
+#include "Option.hpp"
+#include "ThreadPool.hpp"
+#include "Tridiagonal.hpp"
+#include <memory>
+#include <vector>
+
+// Heston stochastic-volatility model: the variance v follows
+//
+//   dv = kappa (theta - v) dt + xi sqrt(v) dW_v,   d<W_S, W_v> = rho dt,
+//
+// starting from v0. Under it an option price u(S, v, tau) solves
+//
+//   u_tau = 0.5 v S^2 u_SS + rho xi v S u_Sv + 0.5 xi^2 v u_vv
+//         + r S u_S + kappa (theta - v) u_v - r u.
+struct HestonParams {
+    double v0;      // initial variance
+    double kappa;   // mean-reversion speed
+    double theta;   // long-run variance
+    double xi;      // volatility of variance
+    double rho;     // correlation of the spot and variance shocks
+};
+
+// Semi-analytic European price: Heston's characteristic-function formula
+// in the "little trap" form of Albrecher et al., integrated by
+// Gauss-Legendre quadrature. option.sigma and option.exercise are ignored.
+double hestonPrice(const Option& option, const HestonParams& model);
+
+// Alternating-direction implicit splitting of the Heston operator
+// A = A0 + A1 + A2: A0 is the mixed S-v derivative, A1 holds the S
+// derivatives and A2 the v derivatives (each with half the -r u term).
+// Every scheme starts with a Douglas step,
+//
+//   Y0 = U + dt A U
+//   Y1 = Y0 + theta dt A1 (Y1 - U)
+//   Y2 = Y1 + theta dt A2 (Y2 - U),
+//
+// whose implicit stages are tridiagonal solves along S at each v node and
+// along v at each S node. A0 is only ever applied explicitly.
+//
+//   Douglas            U' = Y2, theta = 1/2. Second order in time only
+//                      without the mixed term; first order with it.
+//   CraigSneyd         a second Douglas pass from Y0 + dt/2 A0 (Y2 - U).
+//                      Second order for theta = 1/2.
+//   HundsdorferVerwer  a second Douglas pass from Y0 + dt/2 A (Y2 - U),
+//                      with Y2 in place of U in its implicit stages.
+//                      Second order, theta = 1/2 + sqrt(3)/6; the most
+//                      robust of the three against the payoff kink and
+//                      large rho.
+enum class AdiScheme { Douglas, CraigSneyd, HundsdorferVerwer };
+
+// European prices under the Heston model on a 2-D (S, v) grid.
+//
+// Both directions reuse the stretched grids of the 1-D solver: S on a
+// SinhGrid over [0, 8 max(K, S)] clustered at the strike and the spot, v
+// on a SinhGrid over [0, 5] clustered at 0 and v0. The spot and v0 are
+// therefore nodes. Stencils are PDESolver's non-uniform central
+// differences, except at v = 0, where the equation degenerates to first
+// order and u_v is a forward difference, and at large v, where the drift
+// term falls back to upwinding wherever central differences would make
+// an off-diagonal negative.
+//
+// Boundaries: u = 0 (call) or K exp(-r tau) (put) at S = 0; the intrinsic
+// value against the discounted strike at S_max; u = S (call) or
+// K exp(-r tau) (put) at v_max.
+//
+// Values are stored S-major, u(S_i, v_j) at j * (S nodes) + i. A task of
+// the S sweep takes LaneTridiagonalLU::lanes adjacent rows, interleaves
+// them and solves them together, so the Thomas recurrences run across
+// rows rather than waiting on each other. A task of the v sweep takes a
+// block of adjacent S columns and runs TridiagonalLU::solveColumns across
+// them, reading whole cache lines in order; A2 does not depend on S, so
+// every column shares one factorization. The explicit operator passes
+// split by rows. All of them run on the solver's own work-stealing pool.
+// Not thread-safe; use one solver per caller.
+class HestonSolver {
+public:
+    // n_spot, n_var = number of S and v intervals, n_time = time steps.
+    // threads = 0 uses every core.
+    HestonSolver(int n_spot, int n_var, int n_time,
+                 AdiScheme scheme = AdiScheme::HundsdorferVerwer, int threads = 0);
+
+    HestonSolver(const HestonSolver&) = delete;
+    HestonSolver& operator=(const HestonSolver&) = delete;
+
+    // European price at (option.S, model.v0). option.sigma is ignored;
+    // Americans throw std::invalid_argument.
+    double price(const Option& option, const HestonParams& model);
+
+    // Replace the first `steps` time steps by two implicit half steps
+    // (Douglas with theta = 1), to damp the payoff kink. Default: 0.
+    void setRannacherSteps(int steps);
+
+    // S_max = multiple * max(K, S) (default 8); v_max = max(v_max, 2 v0)
+    // (default 5).
+    void setDomainMultiple(double multiple);
+    void setMaxVariance(double v_max);
+
+    int threads() const;
+
+    // The grids and solution u(S_i, v_j) at j * spotGrid().size() + i of
+    // the last price.
+    const Grid& spotGrid() const;
+    const Grid& varianceGrid() const;
+    const std::vector<double>& values() const;
+
+private:
+    int M_, P_, N_;
+    AdiScheme scheme_;
+    int rannacher_ = 0;
+    double domain_ = 8.0, v_max_ = 5.0;
+    WorkStealingPool pool_;
+
+    std::unique_ptr<SinhGrid> s_grid_, v_grid_;
+    int ns_ = 0, nv_ = 0;
+
+    // A1 at (i, j) = v_j * p(i) + q(i), per diagonal; A2 per v node; A0 at
+    // (i, j) = sum over k, l of ws_k(i) wv_l(j) u(i + k, j + l).
+    std::vector<double> pa_, pb_, pc_, qa_, qb_, qc_;
+    std::vector<double> a2a_, a2b_, a2c_;
+    std::vector<double> wsa_, wsb_, wsc_, wva_, wvb_, wvc_;
+
+    // (I - theta dt A1) per group of `lanes` v nodes and (I - theta dt A2),
+    // factored for the current theta dt.
+    std::vector<LaneTridiagonalLU> s_lu_;
+    TridiagonalLU v_lu_;
+    double factored_ = 0.0;
+
+    std::vector<double> U_, Y0_, Y_, F0_, F1_, F2_, G0_, G1_, G2_;
+    std::vector<std::vector<double>> line_;   // per worker: interleaved S rows
+
+    void buildGrids(const Option& option, const HestonParams& model);
+    void assemble(const Option& option, const HestonParams& model);
+    void factor(double theta_dt);
+    void apply(const std::vector<double>& U, std::vector<double>& A0U,
+               std::vector<double>& A1U, std::vector<double>& A2U);
+    void setBoundaries(std::vector<double>& U, const Option& option, double tau) const;
+    void step(const Option& option, double tau, double dt, double theta, bool douglas);
+};
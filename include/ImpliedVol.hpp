@@ -0,0 +1,85 @@
+#pragma once
+#include "Option.hpp"
+#include "PDESolver.hpp"
+#include "ThreadPool.hpp"
+#include <cstddef>
+#include <vector>
+
+// Outcome of one implied-volatility solve.
+//
+//   Converged        vol holds the implied volatility.
+//   BelowBound       the price is at or below the no-arbitrage lower bound
+//                    (intrinsic value; max(S - K e^-rT, 0) for a European
+//                    call), where no volatility reproduces it.
+//   AboveBound       the price is at or above the upper bound: S for a
+//                    call, K e^-rT for a European put, K for an American
+//                    put.
+//   NoConvergence    the iteration limit was reached; vol is the last
+//                    iterate.
+enum class VolStatus { Converged, BelowBound, AboveBound, NoConvergence };
+
+struct ImpliedVolResult {
+    double vol;        // NaN for BelowBound and AboveBound
+    int iterations;    // model prices evaluated
+    VolStatus status;
+};
+
+// Implied volatilities of a batch of quotes, across all cores.
+//
+// Europeans are inverted against Black-Scholes. Puts are turned into
+// calls by put-call parity, the Corrado-Miller closed form gives the
+// initial guess, and Halley steps with the analytic vega and volga
+// converge from it in 2-4 prices. Every step keeps a bracket of the root,
+// and one that leaves it is replaced by bisection, so deep in- or
+// out-of-the-money quotes with vanishing vega still converge.
+//
+// Americans are inverted against PDE prices from a copy of the prototype
+// solver. The European implied vol of the price is the initial guess;
+// the first step uses the Black-Scholes vega, the following ones are
+// secant steps, within the same bracket. All iterates of a quote price
+// through PDESolver::priceAtVolatility(), which keeps the grid built for
+// the first iterate and only re-assembles the operator, so the price is
+// a smooth function of the volatility and each further solve skips grid
+// and stencil construction. The result inverts the discrete model:
+// re-pricing at the implied vol with the same solver reproduces the
+// quote.
+//
+// Each quote is solved start-to-finish by one worker, so results do not
+// depend on the thread count. Not thread-safe itself; one batch at a
+// time.
+class ImpliedVolSolver {
+public:
+    // threads = 0 uses std::thread::hardware_concurrency(). The default
+    // prototype is a 200x200 Sinh solver with Rannacher start-up and
+    // Brennan-Schwartz early exercise.
+    explicit ImpliedVolSolver(int threads = 0);
+    explicit ImpliedVolSolver(const PDESolver& prototype, int threads = 0);
+
+    // option.sigma is ignored. Dispatches on option.exercise.
+    ImpliedVolResult solve(const Option& option, double price);
+
+    // out[i] = implied vol of prices[i] for options[i], for i in [0, count).
+    void solveBatch(const Option* options, const double* prices, std::size_t count,
+                    ImpliedVolResult* out);
+    std::vector<ImpliedVolResult> solveBatch(const std::vector<Option>& options,
+                                             const std::vector<double>& prices);
+
+    // Iterations stop once a step changes the volatility by at most tol.
+    // Defaults: 1e-12 for Europeans, 1e-7 for Americans, whose prices
+    // carry discretization errors far above that anyway.
+    void setTolerance(double european, double american);
+
+    // Default 50 model prices per quote.
+    void setMaxIterations(int iterations);
+
+    int threads() const;
+
+private:
+    WorkStealingPool pool_;
+    std::vector<PDESolver> solvers_;   // one per pool worker
+    double tol_european_ = 1e-12, tol_american_ = 1e-7;
+    int max_iter_ = 50;
+
+    ImpliedVolResult solveEuropean(const Option& option, double price) const;
+    ImpliedVolResult solveAmerican(const Option& option, double price, PDESolver& solver) const;
+};
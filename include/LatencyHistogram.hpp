@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Log-linear histogram of durations in nanoseconds, in the style of
+// HdrHistogram. Values below 32 ns have a bucket each; above, every
+// power-of-two range is split into 32 equal buckets, so a reported
+// percentile is within 1.6% of a recorded value over the full 64-bit
+// range, in 15 KiB. Not thread-safe; merge() per-thread histograms.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(std::uint64_t ns);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    std::uint64_t count() const;
+    std::uint64_t max() const;
+
+    // Value at quantile q in [0, 1] (0.5 = median, 0.999 = p999): the
+    // midpoint of the bucket holding it. 0 when empty.
+    double percentile(double q) const;
+
+private:
+    static constexpr int kSubBits = 5;
+    static constexpr int kSub = 1 << kSubBits;
+
+    std::vector<std::uint64_t> buckets_;
+    std::uint64_t count_ = 0, max_ = 0;
+
+    static int bucket(std::uint64_t ns);
+    static double midpoint(int bucket);
+};
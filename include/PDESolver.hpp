@@ -1,41 +1,363 @@
 #pragma once
 #include "Option.hpp"
 #include "Grid.hpp"
+#include "PriceSurface.hpp"
+#include "Profiler.hpp"
+#include "SetupCache.hpp"
+#include "SolverKernels.hpp"
+#include "SolverWorkspace.hpp"
+#include "ThreadPool.hpp"
+#include "Tridiagonal.hpp"
+#include <cstddef>
 #include <vector>
 #include <memory>
+#include <utility>
+
+// How priceAmerican() enforces the early-exercise constraint V >= payoff.
+//
+//   Projection       Crank-Nicolson step, then V = max(V, payoff). Cheapest,
+//                    but only first-order in time near the free boundary.
+//   BrennanSchwartz  Projection inside the substitution sweep of the
+//                    pre-factored LHS: solves the Crank-Nicolson linear
+//                    complementarity problem directly, at the cost of one
+//                    ordinary solve. Requires a single exercise boundary.
+//   Penalty          Policy iteration on (A + P) V = rhs + P * payoff, with a
+//                    large penalty P on nodes below the payoff (Forsyth &
+//                    Vetzal). Refactors the LHS each iteration; usually
+//                    converges in 2-3 iterations.
+//   PSOR             Projected SOR, warm-started from the Projection
+//                    result. Makes no assumption about the exercise region
+//                    but is by far the slowest on fine grids.
+enum class AmericanMethod { Projection, BrennanSchwartz, Penalty, PSOR };
+
+// Price and greeks at the option's spot, all read off one backward sweep.
+// theta is dV/dt per year of calendar time.
+struct PricingResult {
+    double price, delta, gamma, theta;
+};
+
+// One maturity of PDESolver::priceMaturities().
+struct MaturitySnapshot {
+    double T;
+    double price;           // at the option's spot
+    PriceSurface surface;   // V(S) at t = 0 for maturity T
+};
+
+// Time-stepping statistics of the most recent solve.
+struct SolveStats {
+    int steps;            // accepted time steps
+    int rejected;         // steps redone with a smaller dt (adaptive only)
+    int factorizations;   // LU factorizations of the Crank-Nicolson LHS
+                          // (none for a setup taken from a SetupCache)
+};
 
 class PDESolver {
 public:
     // n_space = number of spatial intervals, n_time = number of time steps.
     // use_adaptive = true builds an AdaptiveGrid; false builds a UniformGrid.
     PDESolver(int n_space, int n_time, bool use_adaptive = true);
+    PDESolver(int n_space, int n_time, GridType grid);
 
     double priceEuropean(const Option& option);
     double priceAmerican(const Option& option);
 
+    // Dispatches on option.exercise.
+    double price(const Option& option);
+
+    // Price, delta, gamma and theta from a single solve (dispatches on
+    // option.exercise), instead of bump-and-reprice.
+    PricingResult priceWithGreeks(const Option& option);
+
+    // The whole t = 0 solution (dispatches on option.exercise), for
+    // evaluating a spot ladder or scenarios off one backward sweep.
+    PriceSurface priceSurface(const Option& option);
+
+    // A term structure of option's strike from a single backward sweep.
+    // Coefficients are constant in time, so the level the sweep passes at
+    // time to expiry T_i is the t = 0 solution of the same contract with
+    // maturity T_i: one solve on the longest maturity prices the whole
+    // strip. option.T is ignored. The sweep stops exactly at each T_i; the
+    // intervals between them get whole numbers of steps of about
+    // T_max / n_time (or are stepped adaptively, with a time tolerance).
+    // Grids that depend on T are built for T_max. Results are in the
+    // order of `maturities`, which must be positive. Dispatches on
+    // option.exercise.
+    std::vector<MaturitySnapshot> priceMaturities(const Option& option,
+                                                  const std::vector<double>& maturities);
+
+    // Prices European options LaneTridiagonalLU::lanes at a time (the
+    // float lanes of BasicLaneTridiagonalLU<float> in Single and Mixed
+    // precision), with the time loop vectorized across options. Each
+    // option gets the same grid layout relative to its strike as
+    // priceEuropean(), so results agree with it to rounding (to the float
+    // error in Single). out[i] = price of options[i]. SinhRefined grids
+    // are built per option, so they are priced one at a time. Throws
+    // std::invalid_argument, before pricing any, if an option is
+    // American.
+    void priceEuropeanBatch(const Option* options, std::size_t count, double* out);
+
+    // Early-exercise treatment used by priceAmerican() and by the other
+    // entry points for American options. Default: Projection.
+    void setAmericanMethod(AmericanMethod method);
+    AmericanMethod americanMethod() const;
+
+    // Rannacher start-up: the first `steps` Crank-Nicolson steps are each
+    // replaced by two implicit-Euler half-steps, which damp the
+    // high-frequency error from the payoff kink that Crank-Nicolson
+    // otherwise carries through the sweep. Default 0 (pure CN); 2 is the
+    // usual choice. Applies to all pricing entry points.
+    void setRannacherSteps(int steps);
+    int rannacherSteps() const;
+
+    // Adaptive time stepping. With tol > 0 the time grid is chosen per
+    // price by local error control and n_time is ignored: each step's
+    // estimated local error (RMS over nodes, in price units) is held
+    // below tol, loosened near expiry. Steps are graded from fine at
+    // expiry to coarse far from it, and the LHS is refactored only when
+    // dt changes. European time errors come out within about 10 tol;
+    // American ones are first order in dt, as with fixed steps, because
+    // of the moving exercise boundary. Default 0: fixed dt = T / n_time.
+    // A price that needs more than kMaxAdaptiveSteps steps, accepted and
+    // rejected, throws std::runtime_error: the tolerance is below what
+    // the spatial grid and double rounding can resolve.
+    void setTimeTolerance(double tol);
+    double timeTolerance() const;
+    static constexpr int kMaxAdaptiveSteps = 100000;
+
+    SolveStats lastSolveStats() const;
+
+    // Richardson extrapolation: prices on (n_space, n_time) and on
+    // (2 n_space, 2 n_time) and returns (4 P_fine - P_coarse) / 3, which
+    // cancels the second-order error term. Dispatches on option.exercise.
+    // Most effective with Rannacher start-up, which makes the error
+    // expansion clean enough to extrapolate.
+    double priceExtrapolated(const Option& option);
+
+    // Price of `option` at volatility sigma instead of option.sigma, for
+    // iterations on the volatility (ImpliedVol.hpp). The first call for a
+    // contract builds its grid for option.sigma, as price() would, and
+    // keeps the operator at sigma = 0 and its slope in sigma^2. Later
+    // calls for the same contract (S, K, T, r, type and exercise) reuse
+    // that grid and assemble L = L(0) + sigma^2 (L(1) - L(0)), skipping
+    // grid and stencil construction. The fixed grid also keeps the price a
+    // smooth function of sigma, which Newton-type iterations need; on
+    // Sinh and log grids price() would move the nodes with sigma. Any
+    // other price on the workspace starts over. Dispatches on
+    // option.exercise; bypasses the setup cache.
+    double priceAtVolatility(const Option& option, double sigma);
+
+    GridType gridType() const;
+
+    // Upper end of the spot domain, S_max = multiple * K. Default 3.
+    // Long-dated or high-volatility contracts need a wider domain: the
+    // boundary condition at S_max is only asymptotically right, and that
+    // error does not shrink as the grid is refined. Sinh grids widen the
+    // domain further where needed, to at least K * exp(3 sigma sqrt(T)).
+    void setDomainMultiple(double multiple);
+    double domainMultiple() const;
+
+    // Shares grids, operators and factored LHS matrices of fixed-step
+    // prices through cache, keyed on grid type, n_space, K, S_max, sigma, r
+    // and dt (plus spot and T for Sinh grids). Copies of the solver share
+    // the cache, so one attached to a BatchPricer prototype serves all its
+    // threads. Adaptive time stepping and SinhRefined grids bypass it.
+    // Default: none; pass nullptr to detach.
+    void setSetupCache(std::shared_ptr<SetupCache> cache);
+    std::shared_ptr<SetupCache> setupCache() const;
+
+    // Instrumentation (Profiler.hpp). With PDE_INSTRUMENT on, every price
+    // records per-phase times and work counters, readable afterwards from
+    // lastProfile(); with a profiler attached they are also added to it,
+    // with trace events. Copies of the solver share the profiler, so one
+    // attached to a BatchPricer prototype aggregates all its threads.
+    // Without PDE_INSTRUMENT nothing is recorded. Default: none.
+    void setProfiler(std::shared_ptr<Profiler> profiler);
+    std::shared_ptr<Profiler> profiler() const;
+    SolveProfile lastProfile() const;
+
+    // Buffers of a price (SolverWorkspace.hpp). Every solver starts with a
+    // workspace of its own; solvers used from the same thread may share
+    // one, which is then sized for the largest of their grids. Copies of
+    // a solver get a fresh workspace, so BatchPricer workers never share
+    // one. Pass nullptr to go back to a private workspace.
+    void setWorkspace(std::shared_ptr<SolverWorkspace> workspace);
+    std::shared_ptr<SolverWorkspace> workspace() const;
+
+    // Splits each time step's tridiagonal solve across pool (see
+    // PartitionedTridiagonalLU) on grids of kMinRows nodes or more; smaller
+    // grids, pools of one thread and Brennan-Schwartz keep the Thomas
+    // solve. For single very fine grids: BatchPricer already keeps every
+    // core busy with one contract each. Copies of the solver share the
+    // pool, and its parallelFor runs one loop at a time. Default: none.
+    void setSolvePool(std::shared_ptr<WorkStealingPool> pool);
+    std::shared_ptr<WorkStealingPool> solvePool() const;
+
+    // Scalar type of the Crank-Nicolson sweeps of fixed-step European
+    // prices, priceEuropeanBatch() included (Precision, SetupCache.hpp).
+    // Americans and adaptive time stepping always run in double, and so
+    // do partitioned solves. Default: Double.
+    //
+    // Single applies to priceEuropeanBatch() only: a float lane group
+    // holds twice the options, about 1.8x the throughput. A scalar sweep
+    // is bound by the latency of its recurrence, which float does not
+    // shorten, so scalar prices run in double. The float error grows
+    // with both grid sizes, and Single is refused (std::invalid_argument)
+    // above kMaxSingleSpace x kMaxSingleTime, where it would exceed 1e-4
+    // relative to the double solve (~4e-4 at M = 2000). Mixed keeps the
+    // double result to ~1e-12 at about twice the cost, on any grid. See
+    // BM_Precision*.
+    void setPrecision(Precision precision);
+    Precision precision() const;
+    static constexpr int kMaxSingleSpace = 256;
+    static constexpr int kMaxSingleTime = 500;
+
     // Expose grid size for diagnostics (adaptive grid may differ from n_space).
     int gridSize() const;
 
 private:
     int M_, N_;
-    bool adaptive_;
+    GridType grid_type_;
+    AmericanMethod american_ = AmericanMethod::Projection;
+    int rannacher_ = 0;
+    double time_tol_ = 0.0;
+    SolveStats stats_ = {0, 0, 0};
+    double domain_ = 3.0;
+
+    // Shared so that copies of a solver (one per worker thread in
+    // BatchPricer) start cheaply. Points into the cache, the workspace's
+    // grid storage (sharing ownership of the workspace) or a refined grid.
+    std::shared_ptr<const Grid> grid_;
+
+    // Owning handle of the workspace whose copies start with a fresh one.
+    class WorkspaceHandle {
+    public:
+        WorkspaceHandle() : ws_(std::make_shared<SolverWorkspace>()) {}
+        WorkspaceHandle(const WorkspaceHandle&) : WorkspaceHandle() {}
+        WorkspaceHandle(WorkspaceHandle&&) = default;
+        WorkspaceHandle& operator=(const WorkspaceHandle&) {
+            ws_ = std::make_shared<SolverWorkspace>();
+            return *this;
+        }
+        WorkspaceHandle& operator=(WorkspaceHandle&&) = default;
+        WorkspaceHandle& operator=(std::shared_ptr<SolverWorkspace> ws) {
+            ws_ = ws ? std::move(ws) : std::make_shared<SolverWorkspace>();
+            return *this;
+        }
+
+        SolverWorkspace& operator*() const { return *ws_; }
+        SolverWorkspace* operator->() const { return ws_.get(); }
+        const std::shared_ptr<SolverWorkspace>& get() const { return ws_; }
+
+    private:
+        std::shared_ptr<SolverWorkspace> ws_;
+    };
+    WorkspaceHandle ws_;
 
-    // Per-node spatial operator coefficients: L*V_i = a_i*V_{i-1} + b_i*V_i + c_i*V_{i+1}
-    struct Coefficients { double a, b, c; };
+    // Crank-Nicolson step operator for a fixed dt. The coefficients are
+    // constant over the backward sweep, so the LHS is factored once per
+    // price and every step reuses it, from ws_->setup or, with a cache
+    // attached, from the cached setup (cached_ non-null).
+    std::shared_ptr<const SolverSetup> cached_;
+    std::shared_ptr<SetupCache> cache_;
 
-    std::unique_ptr<Grid> grid_;
+    // Pool of the partitioned solves; setups factor the partitioned form
+    // only when it has more than one thread.
+    std::shared_ptr<WorkStealingPool> pool_;
+    bool partition() const {
+        return pool_ && pool_->size() > 1 && loop_ == Precision::Double;
+    }
 
+    // Requested precision, and the one the current price's time loop
+    // runs in: Mixed for fixed-step Europeans in Mixed, else Double.
+    Precision precision_ = Precision::Double;
+    Precision loop_ = Precision::Double;
+
+    // Times to expiry at which the current sweep stores V in
+    // ws_->snapshots, increasing and ending at T; empty for a plain price.
+    std::vector<double> stops_;
+
+    // Contract and domain multiple of the grid and operator parts that
+    // priceAtVolatility() keeps in the workspace, and the volatility of
+    // the current price (0 for any other price).
+    struct VolContract {
+        double S, K, T, r;
+        OptionType type;
+        ExerciseType exercise;
+        double domain;
+    };
+    VolContract vol_contract_ = {};
+    double vol_sigma_ = 0.0;
+
+    // Time steps between t = 0 and the two levels before it kept by
+    // priceWithGreeks(): hist_dt_[0] and hist_dt_[0] + hist_dt_[1].
+    double hist_dt_[2] = {0.0, 0.0};
+
+    // Instrumentation of the current price.
+    std::shared_ptr<Profiler> profiler_;
+    SolveProfile profile_;
+    std::vector<TraceEvent> trace_;
+    std::vector<TraceEvent>* trace() { return profiler_ ? &trace_ : nullptr; }
+
+    // Elimination order of the current price, kept for refactoring when
+    // the adaptive integrator changes dt.
+    Elimination order_ = Elimination::Forward;
+
+    // ::gridShape() (Grid.hpp) for the option and this solver's grid.
+    GridShape gridShape(const Option& opt) const;
+
+    bool logSpace() const {
+        return grid_type_ == GridType::LogUniform || grid_type_ == GridType::LogSinh;
+    }
+    bool uniformSpacing() const {
+        return grid_type_ == GridType::Uniform || grid_type_ == GridType::LogUniform;
+    }
+
+    std::shared_ptr<const Grid> makeGrid(const Option& opt) const;
+    std::shared_ptr<const Grid> refineGrid(const Option& opt) const;
+    const Grid& assignGrid(GridStorage& storage, const Option& opt) const;
     void buildGrid(const Option& opt);
-    std::vector<Coefficients> computeCoefficients(const Option& opt) const;
-    void crankNicolsonStep(std::vector<double>& V,
-                           const std::vector<Coefficients>& coeff,
-                           double dt) const;
-    void applyEarlyExercise(std::vector<double>& V, const Option& opt) const;
+    template <class Spacing>
+    void fillOperator(const Grid& grid, const Option& opt, TridiagonalOperator& op) const;
+    void computeOperator(const Grid& grid, const Option& opt, TridiagonalOperator& op) const;
+    const SolverSetup& setup() const { return cached_ ? *cached_ : ws_->setup; }
+    template <class Spacing>
+    bool prepareStep(const Option& option);
+    void factorOwn(double dt);
+    template <class Exercise>
+    void countExercised();
+    void snapshot(std::size_t stop);
+    void buildRhs(const std::vector<double>& V);
+    void implicitSolve(const std::vector<double>& rhs, std::vector<double>& x);
+    void implicitStep(std::vector<double>& V);
+    void refinedSolve(const std::vector<double>& rhs, std::vector<double>& x);
+    void solveConstrained(std::vector<double>& V);
+    void applyEarlyExercise(std::vector<double>& V) const;
+    void penaltySolve(std::vector<double>& V);
+    void psorSolve(std::vector<double>& V);
+    void nodeGreeks(const Option& option, bool american, int i,
+                    double& delta, double& gamma) const;
     double interpolate(const std::vector<double>& V, double S) const;
 
-    static void solveTridiagonal(const std::vector<double>& lower,
-                                 const std::vector<double>& diag,
-                                 const std::vector<double>& upper,
-                                 const std::vector<double>& rhs,
-                                 std::vector<double>& x);
+    // Runtime dispatch to the solver body for the option's payoff,
+    // exercise style and the grid's spacing (see SolverKernels.hpp).
+    void solve(const Option& option, bool american, bool keep_history);
+    template <class Payoff>
+    void solveFor(const Option& option, bool american, bool keep_history);
+    template <class Payoff, class Exercise, class Spacing>
+    void solveWith(const Option& option, bool keep_history);
+    template <class Payoff, class Exercise>
+    void marchFixed(const Option& option, bool keep_history, bool factored);
+    template <class Payoff, class Exercise>
+    void marchAdaptive(const Option& option);
+    template <class Exercise>
+    void timeStep(std::vector<double>& V);
+    template <class Exercise>
+    void implicitHalfStep(std::vector<double>& V);
+    template <class Payoff>
+    void setBoundaries(std::vector<double>& V, const Option& option, double tau) const;
+
+    template <class Real>
+    void priceLaneGroups(const Option* options, std::size_t count, double* out);
+    template <class Real>
+    void priceLaneGroup(const Option* options, int used, double* out);
 };
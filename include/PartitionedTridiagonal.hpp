@@ -0,0 +1,82 @@
+#pragma once
+#include "ThreadPool.hpp"
+#include <vector>
+
+// Partitioned LU factorization of one large tridiagonal system, for
+// solving it on several threads.
+//
+// The Thomas recurrence is sequential in the row index: on a grid of tens
+// of thousands of nodes the solve is one chain of dependent multiply-adds
+// that no amount of cores can shorten. Here the rows are split into
+// blocks of about kBlockRows, separated by single separator rows.
+// Eliminating within each block expresses its unknowns as
+//
+//   x_i = y_i - alpha_i x_left - beta_i x_right,
+//
+// where y is the block's own solution with the separators set to zero,
+// and alpha, beta (the "spikes") its response to the separator on either
+// side. Substituting into the separator rows leaves a tridiagonal system
+// in the separators alone, one row per block. A solve is then three passes:
+//
+//   1. y for every block                                      (parallel)
+//   2. the reduced system for the separators                  (serial)
+//   3. x_i = y_i - alpha_i x_left - beta_i x_right            (parallel)
+//
+// The block LUs, the spikes and the reduced system depend only on the
+// matrix and are computed once in factor(). A task of pass 1 runs the
+// recurrences of kInterleave blocks in lockstep, so their latencies
+// overlap. Pass 3 is a plain vectorizable loop.
+//
+// The gain is in the threads. On one, the overlap is worth about 20% up
+// to some 16k rows; beyond that the extra pass and the spikes make it
+// the slower solve, since it streams about half as much memory again as
+// Thomas.
+//
+// The partition depends only on the size, so results are the same for
+// any pool and thread count. They differ from TridiagonalLU's by
+// rounding. There is no projected (Brennan-Schwartz) variant: its
+// substitution order is what enforces the constraint.
+class PartitionedTridiagonalLU {
+public:
+    static constexpr int kBlockRows = 512;
+    static constexpr int kInterleave = 4;
+    // Smallest system PDESolver partitions. A solve costs two parallelFor
+    // dispatches, some microseconds each, against a Thomas solve of about
+    // 8 ns per row; below a few thousand rows that leaves nothing to
+    // split. See BM_TridiagonalSolve.
+    static constexpr int kMinRows = 4096;
+
+    // Diagonals as for TridiagonalLU::factor(); n >= 2 (kBlockRows + 1).
+    // clear() leaves size() 0.
+    void factor(const std::vector<double>& lower,
+                const std::vector<double>& diag,
+                const std::vector<double>& upper);
+    void clear();
+
+    // Solve A x = rhs. x may alias rhs. `work` is scratch of any size; it
+    // is resized to size(). pool = nullptr runs every pass on the caller.
+    void solve(const std::vector<double>& rhs, std::vector<double>& x,
+               std::vector<double>& work, WorkStealingPool* pool = nullptr) const;
+
+    // Solve A x = B v for B given by its diagonals, as
+    // TridiagonalLU::solveProduct(); B v is formed inside pass 1. x may
+    // alias v.
+    void solveProduct(const double* b_lower, const double* b_diag, const double* b_upper,
+                      const std::vector<double>& v, std::vector<double>& x,
+                      std::vector<double>& work, WorkStealingPool* pool = nullptr) const;
+
+    int size() const;     // rows; 0 when not factored
+    int blocks() const;
+
+private:
+    int n_ = 0;
+    std::vector<int> start_;            // first row of each block, plus n + 1
+    std::vector<double> lower_, upper_, inv_piv_, modified_;
+    std::vector<double> alpha_, beta_;  // spikes, per row
+    // The reduced system, factored: one row per separator.
+    std::vector<double> red_lower_, red_inv_piv_, red_modified_;
+
+    template <class Rhs>
+    void run(const Rhs& rhs, std::vector<double>& x, std::vector<double>& work,
+             WorkStealingPool* pool) const;
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+enum class Interpolation { Linear, Cubic };
+
+// Option values V(S) at t = 0 on the nodes of a solve, evaluable at any
+// number of spots without re-solving.
+//
+// Owns copies of the nodes and values, so it outlives the solver that
+// produced it and is cheap to move. Lookup is O(1) inside runs of evenly
+// spaced nodes (a UniformGrid is one run, an AdaptiveGrid three) and
+// falls back to binary search on grids with many distinct spacings.
+// Outside [nodes.front(), nodes.back()] the end intervals are
+// extrapolated, like PDESolver's own interpolation.
+class PriceSurface {
+public:
+    PriceSurface(std::vector<double> nodes, std::vector<double> values);
+
+    double evaluate(double S, Interpolation method = Interpolation::Linear) const;
+    void evaluate(const double* spots, std::size_t count, double* out,
+                  Interpolation method = Interpolation::Linear) const;
+    std::vector<double> evaluate(const std::vector<double>& spots,
+                                 Interpolation method = Interpolation::Linear) const;
+
+    // Index i with nodes[i] <= S < nodes[i+1], clamped to [0, size()-2];
+    // same contract as Grid::findIndex.
+    int locate(double S) const;
+
+    int size() const;
+    const std::vector<double>& nodes() const;
+    const std::vector<double>& values() const;
+
+private:
+    // Run of evenly spaced intervals [first, first + count).
+    struct Segment {
+        double start, inv_h;
+        int first, count;
+    };
+
+    std::vector<double> nodes_, values_;
+    std::vector<double> second_;        // natural cubic spline V'' at nodes
+    std::vector<Segment> segments_;
+
+    void buildSegments();
+    void buildSpline();
+};
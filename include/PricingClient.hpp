@@ -0,0 +1,58 @@
+#pragma once
+#include "LatencyHistogram.hpp"
+#include "Option.hpp"
+#include "PricingProtocol.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Blocking client of a PricingServer. Requests may be pipelined with
+// send()/receive(); price() is one round trip. Not thread-safe; use one
+// client per thread.
+class PricingClient {
+public:
+    explicit PricingClient(const std::string& unix_path);
+    PricingClient(const std::string& host, int port);
+    ~PricingClient();
+
+    PricingClient(const PricingClient&) = delete;
+    PricingClient& operator=(const PricingClient&) = delete;
+
+    PriceReply price(const Option& option, std::uint32_t deadline_us = 0);
+
+    void send(std::uint64_t id, const Option& option, std::uint32_t deadline_us = 0);
+    PriceReply receive();
+
+    // The server's ServerStats::toJson(); no price replies may be pending.
+    std::string stats();
+
+private:
+    int fd_;
+    std::uint64_t next_id_ = 0;
+
+    std::uint32_t readFrame(std::string& payload);
+};
+
+// Closed-loop load generator for `pde_pricer loadgen`: `connections`
+// threads, each with its own client keeping `in_flight` requests
+// outstanding, cycling through `book` until `requests` replies are in.
+struct LoadConfig {
+    std::string unix_path;            // if empty, TCP to host:port
+    std::string host = "127.0.0.1";
+    int port = 0;
+    int connections = 4;
+    int in_flight = 16;
+    std::size_t requests = 10000;
+    std::uint32_t deadline_us = 0;
+};
+
+struct LoadReport {
+    std::size_t ok = 0, invalid = 0, expired = 0, overloaded = 0;
+    double seconds = 0.0;
+    LatencyHistogram latency;         // round trips seen by the client, ns
+
+    double requestsPerSecond() const;
+};
+
+LoadReport runLoad(const LoadConfig& config, const std::vector<Option>& book);
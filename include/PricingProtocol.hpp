@@ -0,0 +1,78 @@
+#pragma once
+#include "BatchFile.hpp"
+#include "Option.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Wire format of `pde_pricer serve` (PricingServer.hpp), over a Unix-domain
+// or TCP stream socket. Every message is a frame: a little-endian uint32
+// payload length, then the payload, whose first byte is its kind.
+//
+//   Price request   (kind 1, 61 bytes)
+//     uint64 id            echoed in the response
+//     uint32 deadline_us   answer DeadlineExceeded if pricing cannot start
+//                          within this many microseconds of arrival; 0 = none
+//     48-byte option record, as in the binary option file (BatchFile.hpp)
+//
+//   Price response  (kind 1, 18 bytes)
+//     uint64 id
+//     uint8  status        PriceStatus
+//     double price         NaN unless status is Ok
+//
+//   Stats request   (kind 2, 1 byte)
+//   Stats response  (kind 2) JSON text, see ServerStats::toJson()
+//
+// Responses to price requests on one connection may arrive in any order;
+// match them by id. A malformed frame closes the connection.
+namespace protocol {
+
+enum Kind : std::uint8_t { Price = 1, Stats = 2 };
+
+constexpr std::size_t kLengthSize = 4;
+constexpr std::size_t kPriceRequestSize = 1 + 8 + 4 + batchfile::kRecordSize;
+constexpr std::size_t kPriceResponseSize = 1 + 8 + 1 + 8;
+constexpr std::size_t kMaxRequestSize = 1024;
+
+}  // namespace protocol
+
+enum class PriceStatus : std::uint8_t {
+    Ok = 0,
+    Invalid = 1,            // the solver rejected the option
+    DeadlineExceeded = 2,
+    Overloaded = 3,         // request queue full
+};
+
+struct PriceRequest {
+    std::uint64_t id;
+    std::uint32_t deadline_us;
+    OptionRecord option;
+};
+
+struct PriceReply {
+    std::uint64_t id;
+    PriceStatus status;
+    double price;
+};
+
+namespace protocol {
+
+// Whole frames, length prefix included. `out` must hold
+// kLengthSize + kPriceRequestSize (kPriceResponseSize) bytes.
+void encodeRequest(std::uint64_t id, std::uint32_t deadline_us, const Option& option, char* out);
+void encodeReply(const PriceReply& reply, char* out);
+
+// Payloads (after the length prefix) of the given kind.
+void decodeRequest(const char* payload, PriceRequest& out);
+void decodeReply(const char* payload, PriceReply& out);
+
+// Reads or writes exactly `size` bytes on a blocking socket. read returns
+// false on end of stream; both throw std::runtime_error on errors.
+bool readFully(int fd, char* data, std::size_t size);
+void writeFully(int fd, const char* data, std::size_t size);
+
+// Connected stream sockets; throw std::runtime_error.
+int connectUnix(const std::string& path);
+int connectTcp(const std::string& host, int port);
+
+}  // namespace protocol
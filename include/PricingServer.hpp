@@ -0,0 +1,133 @@
+#pragma once
+#include "LatencyHistogram.hpp"
+#include "PDESolver.hpp"
+#include "PricingProtocol.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ServerConfig {
+    int threads = 0;                  // pricing workers; 0 = all cores
+    std::size_t max_batch = 64;       // requests per micro-batch
+    // How long the dispatcher holds the oldest queued request while a
+    // batch fills. 0 prices whatever is queued at once.
+    std::chrono::microseconds batch_window{100};
+    std::size_t max_queue = 65536;    // beyond this, requests are Overloaded
+    // Reply bytes a connection may have waiting for its client to read;
+    // a client that falls further behind is disconnected.
+    std::size_t max_outbound = 1 << 20;
+};
+
+// Counters since start, and latency (arrival of a request to its reply
+// being ready to write) in microseconds.
+struct ServerStats {
+    std::uint64_t requests = 0, priced = 0, invalid = 0, expired = 0, overloaded = 0;
+    std::uint64_t batches = 0;
+    std::uint64_t dropped = 0;        // connections closed for not reading
+    std::size_t queue_depth = 0, max_queue_depth = 0;
+    std::size_t connections = 0;
+    double p50_us = 0.0, p99_us = 0.0, p999_us = 0.0, max_us = 0.0;
+    SetupCacheStats cache;
+
+    double meanBatch() const;
+    std::string toJson() const;
+};
+
+// Long-running pricing service speaking the protocol in
+// PricingProtocol.hpp on Unix-domain and/or loopback TCP sockets.
+//
+// Each connection has a reader thread that decodes requests into one
+// shared queue. A dispatcher thread takes micro-batches off it: it waits
+// until max_batch requests are queued or the oldest has waited
+// batch_window, then takes up to max_batch. A batch is sorted so that
+// contracts sharing a grid shape (exercise, type, T, sigma, r, then K)
+// are adjacent, and priced on a work-stealing pool: Europeans
+// LaneTridiagonalLU::lanes at a time through priceEuropeanBatch(),
+// Americans one per task. Every worker keeps its own solver copy, whose
+// workspace stays warm across batches, and all share one SetupCache (the
+// prototype's, or a new one of 256 entries), so same-shape contracts
+// skip setup. While a batch is priced the next one queues up.
+//
+// A request whose deadline has passed when its task starts is answered
+// DeadlineExceeded without pricing; a request arriving at a full queue,
+// Overloaded. Responses are written per connection after the batch, in
+// batch order, one write per connection. Stats requests are answered by
+// the reader thread straight away.
+//
+// Sockets are non-blocking, so no thread ever waits on a client. A write
+// sends what the socket takes and leaves the rest in the connection's
+// outbound buffer, which its reader thread sends as the socket drains. A
+// client whose unread replies would exceed max_outbound is disconnected
+// and counted as dropped.
+class PricingServer {
+public:
+    explicit PricingServer(const PDESolver& prototype, ServerConfig config = {});
+    ~PricingServer();   // stop()
+
+    PricingServer(const PricingServer&) = delete;
+    PricingServer& operator=(const PricingServer&) = delete;
+
+    // Start accepting on a Unix-domain socket (an existing file at `path`
+    // is replaced, and removed on stop) or on 127.0.0.1:port (0 picks a
+    // free port; the bound port is returned). Throw std::runtime_error.
+    void listenUnix(const std::string& path);
+    int listenTcp(int port);
+
+    // Stops accepting, closes connections and joins every thread. Queued
+    // requests are dropped.
+    void stop();
+
+    ServerStats stats() const;
+
+private:
+    struct Connection;
+    struct Request {
+        std::shared_ptr<Connection> conn;
+        PriceRequest req;
+        std::chrono::steady_clock::time_point arrival, deadline;
+        PriceReply reply;
+    };
+    struct Reader {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> done;
+    };
+
+    ServerConfig config_;
+    WorkStealingPool pool_;
+    std::vector<PDESolver> solvers_;   // one per pool worker
+    std::shared_ptr<SetupCache> cache_;
+    std::vector<std::vector<Option>> scratch_;   // per worker: a task's options
+
+    std::atomic<bool> stopping_{false};
+    std::vector<int> listeners_;
+    std::vector<std::thread> acceptors_;
+    std::string unix_path_;
+    std::mutex readers_mutex_;
+    std::vector<Reader> readers_;
+    std::thread dispatcher_;
+
+    mutable std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::deque<Request> queue_;
+
+    mutable std::mutex stats_mutex_;
+    ServerStats counters_;
+    LatencyHistogram latency_;
+
+    void acceptLoop(int listener);
+    void readLoop(std::shared_ptr<Connection> conn, std::shared_ptr<std::atomic<bool>> done);
+    void dispatchLoop();
+    void priceBatch(std::vector<Request>& batch);
+    void enqueue(std::vector<Request>& requests);
+    void respond(std::vector<Request>& requests);
+    void send(Connection& conn, const char* data, std::size_t size);
+};
@@ -0,0 +1,146 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Opt-in instrumentation of PDESolver.
+//
+// Built with -DPDE_INSTRUMENT=ON (CMake), PDESolver times each phase of a
+// price with steady_clock and counts its work; a Profiler attached with
+// PDESolver::setProfiler() collects the results of every solver sharing
+// it, across threads. Without the option every timer and counter below
+// is an empty inline function, the solver carries no instrumentation
+// code, and profiles read as zero.
+#ifndef PDE_INSTRUMENT
+#define PDE_INSTRUMENT 0
+#endif
+
+namespace instrument {
+
+constexpr bool enabled = PDE_INSTRUMENT != 0;
+
+// Heap allocations made by the calling thread. Counted only when the
+// program links pde_alloc_counter, whose replacement operator new calls
+// noteAllocation(); otherwise always 0.
+void noteAllocation() noexcept;
+std::uint64_t threadAllocations() noexcept;
+
+}  // namespace instrument
+
+// Phases of a price. TimeLoop contains Solve, Exercise and, for adaptive
+// time stepping, the refactorizations counted under Factor.
+//
+//   Grid      grid construction (or setup-cache lookup)
+//   Assembly  spatial operator L on the grid
+//   Factor    Crank-Nicolson LHS assembly and LU factorization
+//   TimeLoop  the backward sweep as a whole
+//   Solve     tridiagonal solves of ordinary steps
+//   Exercise  early exercise: projection, or the whole constrained solve
+//             for Brennan-Schwartz, Penalty and PSOR
+enum class Phase { Grid, Assembly, Factor, TimeLoop, Solve, Exercise };
+constexpr int kPhaseCount = 6;
+const char* phaseName(Phase phase);
+
+// Counters of one or more prices. nodes counts space-time nodes solved
+// (grid size times accepted steps); exercised_nodes counts nodes held at
+// the payoff after a step, summed over steps.
+struct SolveProfile {
+    std::uint64_t phase_ns[kPhaseCount] = {};
+    std::uint64_t phase_calls[kPhaseCount] = {};
+    std::uint64_t prices = 0;
+    std::uint64_t time_steps = 0;
+    std::uint64_t nodes = 0;
+    std::uint64_t exercised_nodes = 0;
+    std::uint64_t allocations = 0;
+
+    std::uint64_t ns(Phase p) const { return phase_ns[static_cast<int>(p)]; }
+    std::uint64_t calls(Phase p) const { return phase_calls[static_cast<int>(p)]; }
+    SolveProfile& operator+=(const SolveProfile& o);
+};
+
+// One complete event ("ph": "X") of the Chrome trace: a price, or one of
+// its Grid, Assembly, Factor and TimeLoop phases. Solve and Exercise are
+// too fine-grained to trace per step; their totals are attached to the
+// enclosing TimeLoop event.
+struct TraceEvent {
+    const char* name;
+    std::uint64_t start_ns, duration_ns;   // steady_clock
+    std::thread::id thread;
+    std::uint64_t solve_ns, exercise_ns, steps;
+};
+
+// Aggregates profiles from any number of solvers and threads. Each
+// solver hands over its profile and trace events once per price, under
+// one lock. Events beyond max_events are dropped (and counted), so a
+// long run cannot exhaust memory.
+class Profiler {
+public:
+    explicit Profiler(std::size_t max_events = 1 << 20);
+
+    SolveProfile totals() const;
+    std::size_t events() const;
+    std::size_t droppedEvents() const;
+    void reset();
+
+    // Chrome trace-event JSON, loadable in chrome://tracing or Perfetto.
+    // Timestamps are microseconds since the Profiler was created; each
+    // thread gets its own track.
+    void writeChromeTrace(std::ostream& out) const;
+    void writeChromeTrace(const std::string& path) const;   // throws on I/O error
+
+    // Used by PDESolver.
+    void record(const SolveProfile& profile, const std::vector<TraceEvent>& events);
+
+private:
+    std::size_t max_events_;
+    std::uint64_t epoch_ns_;
+    mutable std::mutex mutex_;
+    SolveProfile totals_;
+    std::vector<TraceEvent> events_;
+    std::size_t dropped_ = 0;
+};
+
+namespace instrument {
+
+inline std::uint64_t nowNs() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Adds the lifetime of the scope to profile's phase and, given a trace,
+// appends it as an event.
+class ScopedPhase {
+public:
+#if PDE_INSTRUMENT
+    ScopedPhase(SolveProfile& profile, Phase phase, std::vector<TraceEvent>* trace = nullptr)
+        : profile_(profile), trace_(trace), phase_(phase), start_(nowNs()),
+          solve0_(profile.ns(Phase::Solve)), exercise0_(profile.ns(Phase::Exercise)) {}
+    ~ScopedPhase() {
+        std::uint64_t elapsed = nowNs() - start_;
+        int p = static_cast<int>(phase_);
+        profile_.phase_ns[p] += elapsed;
+        ++profile_.phase_calls[p];
+        if (trace_)
+            trace_->push_back({phaseName(phase_), start_, elapsed, std::this_thread::get_id(),
+                               profile_.ns(Phase::Solve) - solve0_,
+                               profile_.ns(Phase::Exercise) - exercise0_, 0});
+    }
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+private:
+    SolveProfile& profile_;
+    std::vector<TraceEvent>* trace_;
+    Phase phase_;
+    std::uint64_t start_, solve0_, exercise0_;
+#else
+    ScopedPhase(SolveProfile&, Phase, std::vector<TraceEvent>* = nullptr) {}
+#endif
+};
+
+}  // namespace instrument
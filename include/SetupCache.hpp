@@ -0,0 +1,124 @@
+#pragma once
+#include "Grid.hpp"
+#include "PartitionedTridiagonal.hpp"
+#include "Tridiagonal.hpp"
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+// Tridiagonal operator per node, L*V_i = a_i*V_{i-1} + b_i*V_i + c_i*V_{i+1},
+// stored as three contiguous arrays.
+struct TridiagonalOperator {
+    std::vector<double> a, b, c;
+    void resize(int n) { a.resize(n); b.resize(n); c.resize(n); }
+};
+
+// Scalar type of the Crank-Nicolson sweeps (PDESolver::setPrecision).
+//
+//   Double  every step in double.
+//   Single  the level, the explicit weights and both substitution sweeps
+//           in float; grids, coefficients and the factorization are
+//           computed in double and rounded once. priceEuropeanBatch()
+//           only: scalar sweeps gain nothing from float and run in
+//           double.
+//   Mixed   the level and the RHS product in double; each step solves in
+//           float, forms the residual in double and adds a float solve
+//           of it: one step of iterative refinement.
+enum class Precision { Double, Single, Mixed };
+
+// Everything a fixed-step Crank-Nicolson sweep needs before the first
+// step, none of which depends on the payoff or the spot value V is read
+// at: the grid, the spatial operator L, the explicit weights I + dt/2 L
+// and the factored LHS I - dt/2 L, for grids of
+// PartitionedTridiagonalLU::kMinRows nodes or more optionally also in
+// partitioned form.
+struct SolverSetup {
+    std::shared_ptr<const Grid> grid;
+    TridiagonalOperator coeff;               // L
+    TridiagonalOperator weights;             // I + dt/2 L
+    std::vector<double> lower, diag, upper;  // I - dt/2 L before factoring
+    TridiagonalLU implicit;                  // I - dt/2 L, factored
+    PartitionedTridiagonalLU partitioned;    // the same, or size() 0
+
+    // Float factored LHS of Mixed sweeps. Left as it is by a Double
+    // factor().
+    BasicTridiagonalLU<float> implicit_single;
+
+    // Fills weights, lower/diag/upper and implicit from coeff, with
+    // `partition` set also partitioned (when the grid is large enough),
+    // and for Mixed implicit_single. Boundary rows (i = 0, n-1) are
+    // identity, since their coefficients are zero: V is set there by the
+    // caller.
+    void factor(double dt, Elimination order, bool partition = false,
+                Precision precision = Precision::Double);
+};
+
+// Everything a SolverSetup is built from. Fields the grid family does
+// not depend on are zero: the spot and the maturity only shape Sinh
+// grids, so Uniform and Adaptive setups are shared across spots. Log
+// grids are the same for every strike up to scale: their setups leave K
+// zero, hold S_max / K in S_max, and are shared across strikes.
+struct SetupKey {
+    GridType grid;
+    int n_space;
+    double K, S_max, sigma, r, dt;
+    Elimination order;
+    double spot, T;
+    bool partition;
+    Precision precision;
+
+    bool operator<(const SetupKey& o) const {
+        return std::tie(grid, n_space, K, S_max, sigma, r, dt, order, spot, T, partition,
+                        precision) <
+               std::tie(o.grid, o.n_space, o.K, o.S_max, o.sigma, o.r, o.dt, o.order,
+                        o.spot, o.T, o.partition, o.precision);
+    }
+};
+
+struct SetupCacheStats {
+    std::size_t hits, misses, evictions, size;
+};
+
+// Bounded least-recently-used cache of SolverSetups, shared between
+// solvers and threads.
+//
+// A book typically holds many contracts with the same strike, vol, rate
+// and maturity; with a cache attached, PDESolver builds and factors their
+// setup once and every later price starts straight at the time loop.
+// Entries are immutable and handed out as shared_ptr, so an evicted
+// entry stays alive for as long as a solver is still using it. All
+// members are thread-safe; the lock covers only the lookup, never the
+// building of a setup, so two threads missing on the same key may both
+// build it.
+class SetupCache {
+public:
+    // capacity = maximum number of entries; at least 1.
+    explicit SetupCache(std::size_t capacity = 64);
+
+    // Entry for key, marked most recently used, or nullptr. Counts a hit
+    // or a miss.
+    std::shared_ptr<const SolverSetup> find(const SetupKey& key);
+
+    // Stores setup under key, evicting the least recently used entry when
+    // full. Replaces an existing entry for key.
+    void insert(const SetupKey& key, std::shared_ptr<const SolverSetup> setup);
+
+    SetupCacheStats stats() const;
+    std::size_t capacity() const;
+
+    // Drops all entries; the counters are kept.
+    void clear();
+
+private:
+    using Entry = std::pair<SetupKey, std::shared_ptr<const SolverSetup>>;
+
+    std::size_t capacity_;
+    mutable std::mutex mutex_;
+    std::list<Entry> entries_;   // most recently used first
+    std::map<SetupKey, std::list<Entry>::iterator> index_;
+    std::size_t hits_ = 0, misses_ = 0, evictions_ = 0;
+};
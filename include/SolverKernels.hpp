@@ -0,0 +1,185 @@
+#pragma once
+#include "Option.hpp"
+#include <algorithm>
+
+// Compile-time policies and the per-node kernels PDESolver instantiates
+// them with.
+//
+// PDESolver::solve() picks one of the eight (payoff x exercise x spacing)
+// combinations at run time and calls a solver body templated on them.
+// Inside it every choice below is an `if constexpr` or an inlined static
+// call: no branching on OptionType per node or per step, no Grid accessor
+// calls, and loops over plain contiguous arrays that the compiler can
+// unroll and vectorize.
+
+namespace kernels {
+
+// ----------------------------------------------------------------
+// Payoff: terminal value and Dirichlet boundary values at the ends of
+// the grid, S_min (0 except on log grids) and S_max, given the
+// discounted strike K exp(-r tau).
+// ----------------------------------------------------------------
+
+struct CallPayoff {
+    static constexpr OptionType type = OptionType::Call;
+    static double value(double S, double K) { return std::max(S - K, 0.0); }
+    static double lowerBoundary(double, double) { return 0.0; }
+    static double upperBoundary(double S_max, double K_disc) { return S_max - K_disc; }
+    // Sign of dV/dS inside the exercise region.
+    static constexpr double exerciseDelta = 1.0;
+};
+
+struct PutPayoff {
+    static constexpr OptionType type = OptionType::Put;
+    static double value(double S, double K) { return std::max(K - S, 0.0); }
+    static double lowerBoundary(double S_min, double K_disc) { return K_disc - S_min; }
+    static double upperBoundary(double, double) { return 0.0; }
+    static constexpr double exerciseDelta = -1.0;
+};
+
+// ----------------------------------------------------------------
+// Exercise style.
+// ----------------------------------------------------------------
+
+struct EuropeanExercise {
+    static constexpr bool early = false;
+};
+
+struct AmericanExercise {
+    static constexpr bool early = true;
+};
+
+// ----------------------------------------------------------------
+// Grid spacing. UniformSpacing lets the stencil use the closed form for
+// a constant h, with no divisions per node.
+// ----------------------------------------------------------------
+
+struct UniformSpacing {
+    static constexpr bool uniform = true;
+};
+
+struct GeneralSpacing {
+    static constexpr bool uniform = false;
+};
+
+// Diffusion operator
+//
+//   L V = 0.5 sigma_i^2 x^2 d2V/dx2 + mu x dV/dx - disc V
+//
+// as L V_i = a_i V_{i-1} + b_i V_i + c_i V_{i+1} at the interior nodes of
+// x[0..n); the boundary entries are set to zero. vol2(i) returns
+// sigma_i^2 at node i.
+//
+// General spacing, h+ = x_{i+1} - x_i, h- = x_i - x_{i-1}:
+//   d2V/dx2 ~ 2/(h+ h- (h+ + h-)) [h- V_{i+1} - (h+ + h-) V_i + h+ V_{i-1}]
+//   dV/dx   ~ 1/(h+ h- (h+ + h-)) [h-^2 V_{i+1} + (h+^2 - h-^2) V_i - h+^2 V_{i-1}]
+// Uniform spacing h: the same stencils reduce to 1/h^2 [1, -2, 1] and
+// 1/(2h) [-1, 0, 1].
+template <class Spacing, class Vol2>
+void fillDiffusion(const double* x, int n, const Vol2& vol2, double mu, double disc,
+                   double* a, double* b, double* c) {
+    a[0] = b[0] = c[0] = 0.0;
+    a[n - 1] = b[n - 1] = c[n - 1] = 0.0;
+
+    if constexpr (Spacing::uniform) {
+        double h = x[1] - x[0];
+        double inv_h2 = 1.0 / (h * h);
+        double inv_2h = 0.5 / h;
+        for (int i = 1; i < n - 1; ++i) {
+            double diff = 0.5 * vol2(i) * x[i] * x[i] * inv_h2;
+            double drift = mu * x[i] * inv_2h;
+            a[i] = diff - drift;
+            b[i] = -2.0 * diff - disc;
+            c[i] = diff + drift;
+        }
+    } else {
+        for (int i = 1; i < n - 1; ++i) {
+            double hp = x[i + 1] - x[i];
+            double hm = x[i] - x[i - 1];
+            double hsum = hp + hm;
+            double inv_denom = 1.0 / (hp * hm * hsum);
+
+            double half_sig2_x2 = 0.5 * vol2(i) * x[i] * x[i];
+            double mu_x = mu * x[i];
+
+            a[i] = (half_sig2_x2 * 2.0 * hp - mu_x * hp * hp) * inv_denom;
+            b[i] = (-half_sig2_x2 * 2.0 * hsum + mu_x * (hp * hp - hm * hm)) * inv_denom - disc;
+            c[i] = (half_sig2_x2 * 2.0 * hm + mu_x * hm * hm) * inv_denom;
+        }
+    }
+}
+
+// Black-Scholes operator in S: sigma constant, mu = disc = r.
+template <class Spacing>
+void fillOperator(const double* S, int n, double sigma, double r,
+                  double* a, double* b, double* c) {
+    double sig2 = sigma * sigma;
+    fillDiffusion<Spacing>(S, n, [sig2](int) { return sig2; }, r, r, a, b, c);
+}
+
+// Black-Scholes operator in the log-moneyness y = ln(S / K),
+//
+//   L V = 0.5 sigma^2 d2V/dy2 + (r - 0.5 sigma^2) dV/dy - r V,
+//
+// with the stencils of fillDiffusion. The coefficients do not depend on
+// y, so on a uniform grid every interior node gets the same a, b, c.
+template <class Spacing>
+void fillLogOperator(const double* y, int n, double sigma, double r,
+                     double* a, double* b, double* c) {
+    a[0] = b[0] = c[0] = 0.0;
+    a[n - 1] = b[n - 1] = c[n - 1] = 0.0;
+
+    double half_sig2 = 0.5 * sigma * sigma;
+    double mu = r - half_sig2;
+    if constexpr (Spacing::uniform) {
+        double h = y[1] - y[0];
+        double diff = half_sig2 / (h * h);
+        double drift = 0.5 * mu / h;
+        double ai = diff - drift, bi = -2.0 * diff - r, ci = diff + drift;
+        for (int i = 1; i < n - 1; ++i) {
+            a[i] = ai;
+            b[i] = bi;
+            c[i] = ci;
+        }
+    } else {
+        for (int i = 1; i < n - 1; ++i) {
+            double hp = y[i + 1] - y[i];
+            double hm = y[i] - y[i - 1];
+            double hsum = hp + hm;
+            double inv_denom = 1.0 / (hp * hm * hsum);
+
+            a[i] = (half_sig2 * 2.0 * hp - mu * hp * hp) * inv_denom;
+            b[i] = (-half_sig2 * 2.0 * hsum + mu * (hp * hp - hm * hm)) * inv_denom - r;
+            c[i] = (half_sig2 * 2.0 * hm + mu * hm * hm) * inv_denom;
+        }
+    }
+}
+
+// Dupire forward operator in the strike K for call or put prices
+// C(K, T): dC/dT = 0.5 sigma^2 K^2 d2C/dK2 - r K dC/dK, i.e. mu = -r and
+// no discounting term. vol2(i) is the (local) variance at node i.
+template <class Spacing, class Vol2>
+void fillForwardOperator(const double* K, int n, const Vol2& vol2, double r,
+                         double* a, double* b, double* c) {
+    fillDiffusion<Spacing>(K, n, vol2, -r, 0.0, a, b, c);
+}
+
+template <class Payoff>
+void fillPayoff(const double* S, int n, double K, double* out) {
+    for (int i = 0; i < n; ++i)
+        out[i] = Payoff::value(S[i], K);
+}
+
+template <class Payoff>
+void setBoundaries(double* V, int n, double S_min, double S_max, double K_disc) {
+    V[0] = Payoff::lowerBoundary(S_min, K_disc);
+    V[n - 1] = Payoff::upperBoundary(S_max, K_disc);
+}
+
+// V_i = max(V_i, floor_i)
+inline void project(double* V, const double* floor, int n) {
+    for (int i = 0; i < n; ++i)
+        V[i] = std::max(V[i], floor[i]);
+}
+
+}  // namespace kernels
@@ -0,0 +1,87 @@
+#pragma once
+#include "Grid.hpp"
+#include "SetupCache.hpp"
+#include "Tridiagonal.hpp"
+#include <memory>
+#include <vector>
+
+// Grids rebuilt in place price after price, one per grid family, so that
+// solvers of different grid types can share a workspace without
+// reallocating. SinhRefined grids come out of a coarse solve of their own
+// and are not kept.
+struct GridStorage {
+    std::unique_ptr<UniformGrid> uniform;
+    std::unique_ptr<AdaptiveGrid> adaptive;
+    std::unique_ptr<SinhGrid> sinh;
+    std::unique_ptr<LogGrid> log;
+};
+
+// Every buffer a PDESolver price touches: the grid, operator and factored
+// LHS, the solution levels, the American constraint and the state of the
+// iterative LCP methods, the operator parts of priceAtVolatility(), the
+// float scratch of mixed-precision sweeps and the lanes of
+// priceEuropeanBatch().
+//
+// Buffers grow to the largest grid priced and keep their capacity, so
+// once each grid family has been priced at its largest size, further
+// prices make no heap calls. The exceptions are SinhRefined grids, which
+// run a coarse solve per price, and entry points that return results by
+// value (priceSurface). reserve() sizes the buffers up front.
+//
+// A solver owns a workspace by default. Solvers used from one thread may
+// share one through PDESolver::setWorkspace(), e.g. the resolutions of a
+// TunedPricer, so that memory is sized once for the largest grid instead
+// of once per solver. A workspace is not thread-safe, and each price
+// overwrites what the previous one left in it.
+struct SolverWorkspace {
+    // Sizes every buffer for grids of up to `nodes` nodes. Grid storage is
+    // built by the first price of each family.
+    void reserve(int nodes);
+
+    GridStorage grid;
+    SolverSetup setup;                     // without a SetupCache
+    std::vector<double> rhs;               // per-step right-hand side
+    std::vector<double> partition_work;    // PartitionedTridiagonalLU scratch
+
+    // Solution at t = 0 and, for priceWithGreeks(), the two levels
+    // before it.
+    std::vector<double> V, V_prev, V_prev2;
+
+    // Operator parts of PDESolver::priceAtVolatility(), L(0) and
+    // L(1) - L(0), valid for the grid in storage while vol_owner is the
+    // solver that built them; any other price resets it.
+    TridiagonalOperator vol_base, vol_slope;
+    const void* vol_owner = nullptr;
+
+    // Levels stored by priceMaturities(), one grid's worth per maturity.
+    std::vector<double> snapshots;
+
+    // Candidate levels of an adaptive step: Crank-Nicolson and the
+    // embedded implicit-Euler pair.
+    std::vector<double> step_cn, step_ie;
+
+    // American constraint and the per-iteration state of the iterative
+    // LCP methods.
+    std::vector<double> payoff;
+    std::vector<double> iterate, penalty_diag, penalty_rhs;
+    TridiagonalLU penalty_lu;
+
+    // Float scratch of Mixed-precision sweeps.
+    std::vector<float> V_single;
+
+    // Interleaved counterparts for priceEuropeanBatch(): element (i, l)
+    // of lane l is stored at i * lanes + l, with the sweeps in Real
+    // (double for Precision::Double, float otherwise).
+    template <class Real>
+    struct Lanes {
+        static constexpr int lanes = BasicLaneTridiagonalLU<Real>::lanes;
+        GridStorage grid[lanes];
+        BasicLaneTridiagonalLU<Real> implicit;
+        std::vector<Real> ea, eb, ec;            // explicit weights
+        std::vector<double> lower, diag, upper;  // LHS before factoring
+        std::vector<Real> V, rhs;
+        std::vector<double> level, level_rhs;    // Mixed: V and B V in double
+    };
+    Lanes<double> lanes;
+    Lanes<float> lanes_single;
+};
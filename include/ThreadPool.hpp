@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent pool of worker threads running index-parallel loops with
+// work stealing.
+//
+// parallelFor(n, body) splits [0, n) into one contiguous range per worker.
+// A worker takes indices from the front of its own range; once that is
+// empty it steals the back half of the fullest remaining range. Uneven
+// item costs (American vs European contracts) therefore never leave a
+// thread idle while work remains, and contiguous ranges keep neighbouring
+// items on the same thread when costs are even.
+//
+// The calling thread participates as worker 0, so a pool of size 1 has
+// no background threads and runs loops inline.
+class WorkStealingPool {
+public:
+    // threads = 0 uses std::thread::hardware_concurrency().
+    explicit WorkStealingPool(int threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int size() const;
+
+    // Calls body(index, worker) once for every index in [0, n), where
+    // worker in [0, size()) identifies the executing thread. Blocks until
+    // all indices are done. The first exception thrown by body is
+    // rethrown here after the remaining items are abandoned.
+    // Calls from inside a body run serially on the calling worker.
+    void parallelFor(std::size_t n,
+                     const std::function<void(std::size_t, int)>& body);
+
+private:
+    struct Range {
+        std::mutex m;
+        std::size_t begin = 0, end = 0;
+    };
+
+    int size_;
+    std::vector<std::thread> threads_;
+    std::vector<std::unique_ptr<Range>> ranges_;
+
+    std::mutex run_mutex_;                 // one parallelFor at a time
+    std::mutex state_mutex_;
+    std::condition_variable wake_, done_;
+    const std::function<void(std::size_t, int)>* body_ = nullptr;
+    unsigned long generation_ = 0;
+    int active_ = 0;                       // background workers still running
+    bool stop_ = false;
+    std::atomic<bool> failed_{false};     // skip remaining items
+    std::exception_ptr error_;
+
+    void workerLoop(int worker);
+    void runWorker(int worker);
+    bool takeOwn(int worker, std::size_t& index);
+    bool steal(int thief);
+};
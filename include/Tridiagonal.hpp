@@ -0,0 +1,152 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Thomas algorithm for a general tridiagonal system
+//
+//   lower_i * x_{i-1} + diag_i * x_i + upper_i * x_{i+1} = rhs_i
+//
+// lower[0] and upper[n-1] are ignored. x may alias rhs.
+void solveTridiagonal(const std::vector<double>& lower,
+                      const std::vector<double>& diag,
+                      const std::vector<double>& upper,
+                      const std::vector<double>& rhs,
+                      std::vector<double>& x);
+
+// Order in which Thomas elimination runs through the rows.
+//   Forward:  eliminate rows 0 -> n-1, substitute n-1 -> 0 (A = LU).
+//   Backward: eliminate rows n-1 -> 0, substitute 0 -> n-1 (A = UL).
+// The direction matters for Brennan-Schwartz projection, which must
+// substitute from the end of the domain where the constraint binds.
+enum class Elimination { Forward, Backward };
+
+// LU factorization of a fixed tridiagonal matrix, with the solves in
+// scalar type Real (double or float).
+//
+// Thomas elimination splits into a matrix-only part (the pivots and the
+// modified off-diagonal) and a right-hand-side part. When the matrix is
+// constant over many solves, the matrix part is done once in factor() and
+// solve() only runs the two substitution sweeps: no divisions and no
+// temporary storage. Re-factoring a matrix of the same size reuses the
+// existing buffers.
+//
+// The matrix is always given, and factored, in double; a float
+// factorization stores the double pivots rounded once, so its error is
+// that of the float sweeps alone.
+template <class Real>
+class BasicTridiagonalLU {
+public:
+    void factor(const std::vector<double>& lower,
+                const std::vector<double>& diag,
+                const std::vector<double>& upper,
+                Elimination order = Elimination::Forward);
+
+    // Solve A x = rhs in two sweeps. x may alias rhs.
+    void solve(const std::vector<Real>& rhs, std::vector<Real>& x) const;
+
+    // Brennan-Schwartz: solve A x = rhs, applying x_i = max(x_i, floor_i)
+    // as each x_i is produced by the substitution sweep. This solves the
+    // linear complementarity problem  A x >= rhs, x >= floor, with
+    // equality in one or the other, exactly when the constrained nodes
+    // form a contiguous block at the end the substitution starts from
+    // (index n-1 for Forward, index 0 for Backward). x may alias rhs.
+    void solveProjected(const std::vector<Real>& rhs,
+                        const std::vector<Real>& floor,
+                        std::vector<Real>& x) const;
+
+    // Solve A x = B v for a second tridiagonal matrix B given by its
+    // diagonals (b_lower[0] and b_upper[n-1] are ignored). Each row of
+    // B v is formed inside the elimination sweep, so v is read once and
+    // no right-hand-side buffer is written: one pass instead of two for a
+    // Crank-Nicolson step. Same arithmetic, in the same order, as forming
+    // rhs = B v and calling solve(). x may alias v.
+    void solveProduct(const Real* b_lower, const Real* b_diag, const Real* b_upper,
+                      const std::vector<Real>& v, std::vector<Real>& x) const;
+
+    // Solve A X = B in place for `count` right-hand sides stored side by
+    // side: row i of column l at x[i * stride + l]. Every row of both
+    // sweeps is one contiguous loop over the columns, which vectorizes
+    // and reads memory in order, where solving the columns one at a time
+    // would stride through it. Each column gets the arithmetic of solve().
+    void solveColumns(Real* x, std::size_t stride, int count) const;
+
+    // Pre-sizes the buffers for systems of up to n rows, so that factoring
+    // them allocates nothing.
+    void reserve(int n);
+
+    int size() const;
+
+private:
+    Elimination order_ = Elimination::Forward;
+    std::vector<Real> couple_;    // off-diagonal used while eliminating
+    std::vector<Real> inv_piv_;   // 1 / pivot_i
+    std::vector<Real> modified_;  // off-diagonal / pivot, used while substituting
+
+    template <bool Project>
+    void sweep(const std::vector<Real>& rhs, const Real* floor,
+               std::vector<Real>& x) const;
+    template <bool Project>
+    void substitute(const Real* floor, Real* x) const;
+};
+
+using TridiagonalLU = BasicTridiagonalLU<double>;
+
+// Lane-interleaved LU factorization of `lanes` independent tridiagonal
+// systems of equal size, solved in scalar type Real.
+//
+// The Thomas recurrences are sequential in the row index, so a single
+// system cannot be vectorized. Storing several systems interleaved
+// (element (i, l) at index i * lanes + l) turns each row of the sweep into
+// one SIMD operation across systems. With AVX-512 a row is one 64-byte
+// register, with AVX2 one 32-byte register (8 or 4 doubles, 16 or 8
+// floats); without either, plain loops over the lanes are left to the
+// auto-vectorizer. Each lane performs the same operations, in the same
+// order, as BasicTridiagonalLU<Real> on its own system.
+template <class Real>
+class BasicLaneTridiagonalLU {
+public:
+#if defined(__AVX512F__)
+    static constexpr int lanes = 64 / sizeof(Real);
+#else
+    static constexpr int lanes = 32 / sizeof(Real);
+#endif
+
+    // Interleaved diagonals, each of size n * lanes, factored in double as
+    // for BasicTridiagonalLU.
+    void factor(const std::vector<double>& lower,
+                const std::vector<double>& diag,
+                const std::vector<double>& upper);
+
+    // Solve all lanes at once. rhs and x are interleaved; x may alias rhs.
+    void solve(const std::vector<Real>& rhs, std::vector<Real>& x) const;
+
+    // Pre-sizes the buffers for systems of up to n rows.
+    void reserve(int n);
+
+    int size() const;   // rows per system
+
+private:
+    std::vector<Real> lower_, inv_piv_, upper_;
+};
+
+using LaneTridiagonalLU = BasicLaneTridiagonalLU<double>;
+
+// Flushes subnormal results and operands to zero on the calling thread
+// for its lifetime, restoring the previous mode on destruction.
+//
+// Option values decay towards zero in the far field of the grid, and in
+// float they reach the subnormal range (below about 1e-38) within a few
+// hundred steps. Every operation on a subnormal then takes a microcode
+// assist of some hundred cycles, enough to make a float sweep slower
+// than the double one. The values flushed are far below float rounding
+// of any price. A no-op where SSE control is not available.
+class FlushDenormals {
+public:
+    FlushDenormals();
+    ~FlushDenormals();
+    FlushDenormals(const FlushDenormals&) = delete;
+    FlushDenormals& operator=(const FlushDenormals&) = delete;
+
+private:
+    unsigned int saved_ = 0;
+};
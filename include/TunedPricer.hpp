@@ -0,0 +1,97 @@
+#pragma once
+#include "Option.hpp"
+#include "PDESolver.hpp"
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <tuple>
+
+// Discretization chosen for a contract class.
+struct Resolution {
+    int n_space, n_time;
+    GridType grid;
+    double domain;   // S_max / K
+    // False when no shape met the tolerance within kMaxSpace; the
+    // resolution is then the finest SinhRefined level. Not part of the
+    // ordering.
+    bool converged = true;
+
+    bool operator<(const Resolution& o) const {
+        return std::tie(n_space, n_time, grid, domain) <
+               std::tie(o.n_space, o.n_time, o.grid, o.domain);
+    }
+};
+
+struct TunedPrice {
+    double price;
+    bool converged;   // Resolution::converged of the option's class
+};
+
+// Prices to a target accuracy instead of a caller-chosen grid.
+//
+// For the first contract of each class, the pricer solves a sequence of
+// doubling resolutions for every candidate shape (Adaptive, Sinh or
+// SinhRefined grid, N = M, M/2 or M/4) and estimates the error of each
+// level from the next: err(M) ~ 4/3 * |P(M) - P(2M)|, trusted only once
+// successive differences shrink at a second-order rate. Among the shapes
+// it keeps the coarsest level whose estimate is within half the
+// tolerance, and picks the cheapest (fewest space-time nodes, counting
+// SinhRefined's coarse pass) across shapes. The result is cached, so
+// later contracts in the class are priced with a single solve at that
+// resolution.
+//
+// A class is: call/put, European/American, log-moneyness ln(S/K) in
+// steps of 0.1, maturity in doublings from one month, volatility in
+// steps of 0.05, and strike in doublings (absolute errors scale with
+// K). Contracts within a class share their error behaviour closely
+// enough that the factor-2 safety margin covers the spread.
+//
+// All solves use Rannacher start-up, which keeps the refinement
+// sequence monotone even with few time steps. Only the solvers of cached
+// classes are kept; those of the other levels tried are dropped when a
+// search ends. Not thread-safe; use one per thread, as with PDESolver.
+class TunedPricer {
+public:
+    // Target |error| <= max(abs_tol, rel_tol * |price|). At least one
+    // tolerance must be positive.
+    explicit TunedPricer(double abs_tol, double rel_tol = 0.0);
+
+    // Dispatches on option.exercise. price() does not say whether the
+    // tolerance was met; priceWithStatus() does.
+    double price(const Option& option);
+    TunedPrice priceWithStatus(const Option& option);
+
+    // Resolution used for option's class, searching if not cached yet.
+    Resolution resolutionFor(const Option& option);
+
+    std::size_t cachedClasses() const;
+    std::size_t searches() const;   // cache misses so far
+    std::size_t solvers() const;    // solvers held, one per resolution in use
+
+    // Search limits on n_space.
+    static constexpr int kMinSpace = 25;
+    static constexpr int kMaxSpace = 3200;
+    // S_max = K * max(3, exp(kStdDevs * sigma * sqrt(T))).
+    static constexpr double kStdDevs = 3.0;
+
+private:
+    struct ClassKey {
+        bool put, american;
+        int moneyness, maturity, vol, scale;
+        bool operator<(const ClassKey& o) const {
+            return std::tie(put, american, moneyness, maturity, vol, scale) <
+                   std::tie(o.put, o.american, o.moneyness, o.maturity, o.vol, o.scale);
+        }
+    };
+
+    double abs_tol_, rel_tol_;
+    std::size_t searches_ = 0;
+    std::map<ClassKey, Resolution> classes_;
+    std::map<Resolution, PDESolver> solvers_;
+    std::shared_ptr<SolverWorkspace> workspace_;   // shared by solvers_
+
+    static ClassKey classify(const Option& option);
+    PDESolver& solverFor(const Resolution& res);
+    Resolution search(const Option& option);
+    void dropUnusedSolvers();
+};
@@ -5,6 +5,11 @@
 
 AdaptiveGrid::AdaptiveGrid(double S_max, int M_total, double K,
                            double frac, double width) {
+    assign(S_max, M_total, K, frac, width);
+}
+
+void AdaptiveGrid::assign(double S_max, int M_total, double K,
+                          double frac, double width) {
     if (M_total < 10 || S_max <= 0.0 || K <= 0.0)
         throw std::invalid_argument("AdaptiveGrid: invalid parameters");
 
@@ -24,6 +29,7 @@ AdaptiveGrid::AdaptiveGrid(double S_max, int M_total, double K,
         M_hi = std::max(1, M_outer - M_lo);
     }
 
+    nodes_.clear();
     nodes_.reserve(M_lo + M_mid + M_hi + 1);
 
     // Helper: push evenly spaced nodes for [a, b) with n intervals.
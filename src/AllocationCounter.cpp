@@ -0,0 +1,22 @@
+// Replacement global operator new that counts allocations per thread for
+// the instrumentation (instrument::threadAllocations). Linked only into
+// programs that ask for it through the pde_alloc_counter target: a
+// program can have one replacement operator new at most.
+#include "Profiler.hpp"
+#include <cstdlib>
+#include <new>
+
+void* operator new(std::size_t size) {
+    instrument::noteAllocation();
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
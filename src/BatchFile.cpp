@@ -0,0 +1,340 @@
+#include "BatchFile.hpp"
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PDE_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char* skipSpace(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t'))
+        ++p;
+    return p;
+}
+
+const char* trimEnd(const char* begin, const char* end) {
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t'))
+        --end;
+    return end;
+}
+
+bool equalsIgnoreCase(const char* begin, const char* end, const char* word) {
+    std::size_t n = std::strlen(word);
+    if (static_cast<std::size_t>(end - begin) != n)
+        return false;
+    for (std::size_t i = 0; i < n; ++i)
+        if (std::tolower(static_cast<unsigned char>(begin[i])) != word[i])
+            return false;
+    return true;
+}
+
+}  // namespace
+
+namespace batchfile {
+
+BatchFormat detect(const char* data, std::size_t size) {
+    return size >= sizeof(kMagic) && std::memcmp(data, kMagic, sizeof(kMagic)) == 0
+               ? BatchFormat::Binary
+               : BatchFormat::CSV;
+}
+
+std::size_t csvStart(const char* data, std::size_t size, std::uint64_t& lines) {
+    lines = 0;
+    const char* end = data + size;
+    std::uint64_t seen = 0;
+    for (const char* p = data; p < end;) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* line_end = nl ? nl : end;
+        ++seen;
+        OptionRecord record;
+        if (parseCsvLine(p, line_end, record)) {
+            const char* first = skipSpace(p, line_end);
+            if (record.error && std::isalpha(static_cast<unsigned char>(*first))) {
+                lines = seen;
+                return nl ? nl + 1 - data : size;
+            }
+            return 0;
+        }
+        p = nl ? nl + 1 : end;
+    }
+    return 0;
+}
+
+bool parseCsvLine(const char* begin, const char* end, OptionRecord& out) {
+    if (end > begin && end[-1] == '\r')
+        --end;
+    const char* p = skipSpace(begin, end);
+    if (p == end || *p == '#')
+        return false;
+
+    out.error = nullptr;
+    out.exercise = ExerciseType::European;
+    const char* fields[7][2];
+    int count = 0;
+    for (const char* f = p;;) {
+        const char* comma = static_cast<const char*>(std::memchr(f, ',', end - f));
+        const char* field_end = comma ? comma : end;
+        if (count == 7) {
+            out.error = "expected 6 or 7 fields";
+            return true;
+        }
+        fields[count][0] = skipSpace(f, field_end);
+        fields[count][1] = trimEnd(fields[count][0], field_end);
+        ++count;
+        if (!comma)
+            break;
+        f = comma + 1;
+    }
+    if (count < 6) {
+        out.error = "expected 6 or 7 fields";
+        return true;
+    }
+
+    double* values[5] = {&out.S, &out.K, &out.T, &out.r, &out.sigma};
+    for (int i = 0; i < 5; ++i) {
+        std::from_chars_result res = std::from_chars(fields[i][0], fields[i][1], *values[i]);
+        if (res.ec != std::errc() || res.ptr != fields[i][1] || !std::isfinite(*values[i])) {
+            out.error = "malformed number";
+            return true;
+        }
+    }
+
+    const char* tb = fields[5][0];
+    const char* te = fields[5][1];
+    if (equalsIgnoreCase(tb, te, "c") || equalsIgnoreCase(tb, te, "call")) {
+        out.type = OptionType::Call;
+    } else if (equalsIgnoreCase(tb, te, "p") || equalsIgnoreCase(tb, te, "put")) {
+        out.type = OptionType::Put;
+    } else {
+        out.error = "option type must be C or P";
+        return true;
+    }
+
+    if (count == 7) {
+        const char* eb = fields[6][0];
+        const char* ee = fields[6][1];
+        if (equalsIgnoreCase(eb, ee, "a") || equalsIgnoreCase(eb, ee, "american"))
+            out.exercise = ExerciseType::American;
+        else if (!equalsIgnoreCase(eb, ee, "e") && !equalsIgnoreCase(eb, ee, "european"))
+            out.error = "exercise must be E or A";
+    }
+    return true;
+}
+
+std::size_t recordCount(const char* data, std::size_t size) {
+    std::uint32_t record_size = 0;
+    if (size >= kHeaderSize)
+        std::memcpy(&record_size, data + sizeof(kMagic), sizeof(record_size));
+    if (size < kHeaderSize || record_size != kRecordSize)
+        throw std::runtime_error("binary option file: unsupported header");
+    if ((size - kHeaderSize) % kRecordSize != 0)
+        throw std::runtime_error("binary option file: truncated record");
+    return (size - kHeaderSize) / kRecordSize;
+}
+
+void decodeRecord(const char* data, OptionRecord& out) {
+    double v[5];
+    std::memcpy(v, data, sizeof(v));
+    out.S = v[0];
+    out.K = v[1];
+    out.T = v[2];
+    out.r = v[3];
+    out.sigma = v[4];
+    unsigned char type = static_cast<unsigned char>(data[40]);
+    unsigned char exercise = static_cast<unsigned char>(data[41]);
+    out.type = type == 0 ? OptionType::Call : OptionType::Put;
+    out.exercise = exercise == 0 ? ExerciseType::European : ExerciseType::American;
+    out.error = nullptr;
+    if (type > 1)
+        out.error = "option type must be 0 or 1";
+    else if (exercise > 1)
+        out.error = "exercise must be 0 or 1";
+    else if (!std::isfinite(v[0] + v[1] + v[2] + v[3] + v[4]))
+        out.error = "non-finite value";
+}
+
+void encodeRecord(const Option& option, char* out) {
+    double v[5] = {option.S, option.K, option.T, option.r, option.sigma};
+    std::memcpy(out, v, sizeof(v));
+    std::memset(out + sizeof(v), 0, kRecordSize - sizeof(v));
+    out[40] = option.type == OptionType::Call ? 0 : 1;
+    out[41] = option.exercise == ExerciseType::European ? 0 : 1;
+}
+
+}  // namespace batchfile
+
+// ----------------------------------------------------------------
+// MappedFile
+// ----------------------------------------------------------------
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef PDE_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("cannot stat " + path);
+    }
+    if (!S_ISREG(st.st_mode)) {
+        // Pipes and devices cannot be mapped, and reading them whole would
+        // give up the bounded memory the pipeline relies on.
+        ::close(fd);
+        throw std::runtime_error(path + " is not a regular file; batch input must be a file "
+                                        "that can be memory-mapped");
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ > 0) {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("cannot map " + path);
+        }
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+        mapped_ = true;
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("cannot open " + path);
+    buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef PDE_HAVE_MMAP
+    if (mapped_)
+        ::munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+const char* MappedFile::data() const {
+    return data_;
+}
+
+std::size_t MappedFile::size() const {
+    return size_;
+}
+
+void MappedFile::release(std::size_t begin, std::size_t end) {
+#ifdef PDE_HAVE_MMAP
+    if (!mapped_)
+        return;
+    std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    begin = (begin + page - 1) / page * page;
+    end = end / page * page;
+    if (end > begin)
+        ::madvise(const_cast<char*>(data_) + begin, end - begin, MADV_DONTNEED);
+#else
+    (void)begin;
+    (void)end;
+#endif
+}
+
+// ----------------------------------------------------------------
+// Whole-file helpers
+// ----------------------------------------------------------------
+
+namespace {
+
+Option toOption(const OptionRecord& rec, const std::string& path) {
+    std::string where = path + ":" + std::to_string(rec.line) + ": ";
+    if (rec.error)
+        throw std::runtime_error(where + rec.error);
+    try {
+        return Option(rec.S, rec.K, rec.T, rec.r, rec.sigma, rec.type, rec.exercise);
+    } catch (const std::invalid_argument& e) {
+        throw std::runtime_error(where + e.what());
+    }
+}
+
+}  // namespace
+
+std::vector<Option> readOptionFile(const std::string& path) {
+    MappedFile file(path);
+    const char* data = file.data();
+    std::size_t size = file.size();
+    std::vector<Option> options;
+    OptionRecord rec;
+
+    if (batchfile::detect(data, size) == BatchFormat::Binary) {
+        std::size_t count = batchfile::recordCount(data, size);
+        options.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            batchfile::decodeRecord(data + batchfile::kHeaderSize + i * batchfile::kRecordSize,
+                                    rec);
+            rec.line = i + 1;
+            options.push_back(toOption(rec, path));
+        }
+        return options;
+    }
+
+    std::uint64_t line = 0;
+    const char* end = data + size;
+    for (const char* p = data + batchfile::csvStart(data, size, line); p < end;) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* line_end = nl ? nl : end;
+        ++line;
+        if (batchfile::parseCsvLine(p, line_end, rec)) {
+            rec.line = line;
+            options.push_back(toOption(rec, path));
+        }
+        p = nl ? nl + 1 : end;
+    }
+    return options;
+}
+
+void writeOptionFile(const std::string& path, const std::vector<Option>& options,
+                     BatchFormat format) {
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out)
+        throw std::runtime_error("cannot create " + path);
+    bool ok = true;
+    if (format == BatchFormat::Binary) {
+        char header[batchfile::kHeaderSize] = {};
+        std::uint32_t record_size = batchfile::kRecordSize;
+        std::memcpy(header, batchfile::kMagic, sizeof(batchfile::kMagic));
+        std::memcpy(header + sizeof(batchfile::kMagic), &record_size, sizeof(record_size));
+        ok = std::fwrite(header, sizeof(header), 1, out) == 1;
+        for (const Option& o : options) {
+            char record[batchfile::kRecordSize];
+            batchfile::encodeRecord(o, record);
+            ok = ok && std::fwrite(record, sizeof(record), 1, out) == 1;
+        }
+    } else {
+        ok = std::fputs("S,K,T,r,sigma,type,exercise\n", out) >= 0;
+        char line[192];
+        for (const Option& o : options) {
+            char* p = line;
+            char* end = line + sizeof(line);
+            for (double v : {o.S, o.K, o.T, o.r, o.sigma}) {
+                p = std::to_chars(p, end, v).ptr;
+                *p++ = ',';
+            }
+            *p++ = o.type == OptionType::Call ? 'C' : 'P';
+            *p++ = ',';
+            *p++ = o.exercise == ExerciseType::European ? 'E' : 'A';
+            *p++ = '\n';
+            ok = ok && std::fwrite(line, 1, p - line, out) == static_cast<std::size_t>(p - line);
+        }
+    }
+    if (std::fclose(out) != 0 || !ok)
+        throw std::runtime_error("cannot write " + path);
+}
@@ -0,0 +1,344 @@
+#include "BatchPipeline.hpp"
+#include "BatchFile.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Blocks below this size are not worth a task of their own.
+constexpr std::size_t kMinBlockBytes = 16 * 1024;
+
+// Longest output line: a 20-digit index, a shortest-form double (at most
+// 24 characters), ',' and '\n'.
+constexpr std::size_t kMaxLine = 48;
+
+// One chunk in flight: its records and prices, and its output text, one
+// string per format block so that blocks are formatted in parallel.
+struct Chunk {
+    std::vector<OptionRecord> rows;
+    std::vector<double> prices;
+    std::vector<std::string> text;
+    std::size_t blocks = 0;
+};
+
+// Writes chunks in submission order on a thread of its own. Holds
+// depth + 1 chunks: the one being produced and up to depth queued.
+class Writer {
+public:
+    Writer(std::FILE* out, int depth) : out_(out), chunks_(depth + 1) {
+        for (Chunk& c : chunks_)
+            free_.push_back(&c);
+        thread_ = std::thread([this] { loop(); });
+    }
+
+    ~Writer() {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            done_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    // Next free chunk; waits while all are queued.
+    Chunk& acquire() {
+        std::unique_lock<std::mutex> lock(m_);
+        cv_.wait(lock, [this] { return !free_.empty() || failed_; });
+        if (failed_)
+            throw std::runtime_error("BatchPipeline: write failed");
+        Chunk* c = free_.front();
+        free_.pop_front();
+        return *c;
+    }
+
+    void submit(Chunk& c) {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            queue_.push_back(&c);
+        }
+        cv_.notify_all();
+    }
+
+    // Drains the queue and flushes; throws if any write failed.
+    void finish() {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            done_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+        if (failed_ || std::fflush(out_) != 0)
+            throw std::runtime_error("BatchPipeline: write failed");
+    }
+
+private:
+    std::FILE* out_;
+    std::vector<Chunk> chunks_;
+    std::thread thread_;
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::deque<Chunk*> free_, queue_;
+    bool done_ = false, failed_ = false;
+
+    void loop() {
+        for (;;) {
+            Chunk* c;
+            {
+                std::unique_lock<std::mutex> lock(m_);
+                cv_.wait(lock, [this] { return !queue_.empty() || done_; });
+                if (queue_.empty())
+                    return;
+                c = queue_.front();
+                queue_.pop_front();
+            }
+            bool ok = true;
+            for (std::size_t b = 0; b < c->blocks && ok; ++b) {
+                const std::string& s = c->text[b];
+                ok = std::fwrite(s.data(), 1, s.size(), out_) == s.size();
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_);
+                free_.push_back(c);
+                if (!ok) {
+                    failed_ = true;
+                    queue_.clear();
+                }
+            }
+            cv_.notify_all();
+        }
+    }
+};
+
+}  // namespace
+
+double PipelineStats::optionsPerSecond() const {
+    return seconds > 0.0 ? records / seconds : 0.0;
+}
+
+BatchPipeline::BatchPipeline(const PDESolver& prototype, int threads)
+    : pool_(threads), solvers_(pool_.size(), prototype) {}
+
+int BatchPipeline::threads() const {
+    return pool_.size();
+}
+
+void BatchPipeline::setChunkBytes(std::size_t bytes) {
+    if (bytes == 0)
+        throw std::invalid_argument("BatchPipeline: chunk size must be positive");
+    chunk_bytes_ = bytes;
+}
+
+void BatchPipeline::setQueueDepth(int chunks) {
+    if (chunks < 1)
+        throw std::invalid_argument("BatchPipeline: queue depth must be >= 1");
+    depth_ = chunks;
+}
+
+// ----------------------------------------------------------------
+// Chunk loop. Block boundaries are computed on the producing thread: for
+// CSV, nominal offsets moved forward to the next line start; for binary
+// files, whole records. Parse blocks double as format blocks.
+// ----------------------------------------------------------------
+
+PipelineStats BatchPipeline::run(const std::string& input, std::FILE* out) {
+    Clock::time_point start = Clock::now();
+    PipelineStats stats;
+    MappedFile file(input);
+    const char* data = file.data();
+    const std::size_t size = file.size();
+    const bool binary = batchfile::detect(data, size) == BatchFormat::Binary;
+
+    std::size_t pos;
+    std::uint64_t line_base = 0;   // CSV lines before pos
+    if (binary) {
+        batchfile::recordCount(data, size);
+        pos = batchfile::kHeaderSize;
+    } else {
+        pos = batchfile::csvStart(data, size, line_base);
+    }
+
+    if (std::fputs("index,price\n", out) < 0)
+        throw std::runtime_error("BatchPipeline: write failed");
+    Writer writer(out, depth_);
+
+    // Per-block parse results, reused across chunks.
+    std::vector<std::size_t> bounds;
+    std::vector<std::vector<OptionRecord>> block_rows;
+    std::vector<std::uint64_t> block_lines;
+    std::vector<std::size_t> row_begin;
+
+    const std::size_t max_blocks = 4 * static_cast<std::size_t>(pool_.size());
+    const std::size_t chunk_records = std::max<std::size_t>(1, chunk_bytes_ / batchfile::kRecordSize);
+    std::size_t index = 0;   // options before this chunk
+    std::mutex error_mutex;
+
+    while (pos < size) {
+        Clock::time_point t = Clock::now();
+        Chunk& chunk = writer.acquire();
+        stats.stall_seconds += since(t);
+
+        // Chunk and block boundaries.
+        t = Clock::now();
+        std::size_t end;
+        bounds.assign(1, pos);
+        if (binary) {
+            std::size_t records = std::min(chunk_records, (size - pos) / batchfile::kRecordSize);
+            end = pos + records * batchfile::kRecordSize;
+            std::size_t blocks = std::min(max_blocks,
+                std::max<std::size_t>(1, records * batchfile::kRecordSize / kMinBlockBytes));
+            for (std::size_t b = 1; b < blocks; ++b)
+                bounds.push_back(pos + records * b / blocks * batchfile::kRecordSize);
+        } else {
+            end = std::min(size, pos + chunk_bytes_);
+            if (end < size) {
+                const char* nl =
+                    static_cast<const char*>(std::memchr(data + end - 1, '\n', size - end + 1));
+                end = nl ? nl + 1 - data : size;
+            }
+            std::size_t blocks = std::min(max_blocks,
+                                          std::max<std::size_t>(1, (end - pos) / kMinBlockBytes));
+            for (std::size_t b = 1; b < blocks; ++b) {
+                std::size_t at = pos + (end - pos) * b / blocks;
+                const char* nl =
+                    static_cast<const char*>(std::memchr(data + at - 1, '\n', end - at + 1));
+                at = nl ? nl + 1 - data : end;
+                if (at > bounds.back() && at < end)
+                    bounds.push_back(at);
+            }
+        }
+        bounds.push_back(end);
+        const std::size_t blocks = bounds.size() - 1;
+        if (block_rows.size() < blocks) {
+            block_rows.resize(blocks);
+            block_lines.resize(blocks);
+        }
+
+        // Parse.
+        pool_.parallelFor(blocks, [&](std::size_t b, int) {
+            std::vector<OptionRecord>& rows = block_rows[b];
+            rows.clear();
+            OptionRecord rec;
+            if (binary) {
+                for (std::size_t at = bounds[b]; at < bounds[b + 1]; at += batchfile::kRecordSize) {
+                    batchfile::decodeRecord(data + at, rec);
+                    rec.line = (at - batchfile::kHeaderSize) / batchfile::kRecordSize + 1;
+                    rows.push_back(rec);
+                }
+                return;
+            }
+            std::uint64_t lines = 0;
+            const char* p = data + bounds[b];
+            const char* block_end = data + bounds[b + 1];
+            while (p < block_end) {
+                const char* nl = static_cast<const char*>(std::memchr(p, '\n', block_end - p));
+                const char* line_end = nl ? nl : block_end;
+                ++lines;
+                if (batchfile::parseCsvLine(p, line_end, rec)) {
+                    rec.line = lines;
+                    rows.push_back(rec);
+                }
+                p = nl ? nl + 1 : block_end;
+            }
+            block_lines[b] = lines;
+        });
+        chunk.rows.clear();
+        row_begin.assign(1, 0);
+        for (std::size_t b = 0; b < blocks; ++b) {
+            for (OptionRecord rec : block_rows[b]) {
+                if (!binary)
+                    rec.line += line_base;
+                chunk.rows.push_back(rec);
+            }
+            if (!binary)
+                line_base += block_lines[b];
+            row_begin.push_back(chunk.rows.size());
+        }
+        file.release(pos, end);
+        stats.parse_seconds += since(t);
+
+        // Price. Rows the solver rejects are marked like malformed ones;
+        // the message of the first is kept.
+        t = Clock::now();
+        const std::size_t n = chunk.rows.size();
+        chunk.prices.resize(n);
+        std::size_t invalid_at = n;
+        std::string invalid_message;
+        pool_.parallelFor(n, [&](std::size_t i, int worker) {
+            OptionRecord& rec = chunk.rows[i];
+            chunk.prices[i] = std::numeric_limits<double>::quiet_NaN();
+            if (rec.error)
+                return;
+            try {
+                chunk.prices[i] = solvers_[worker].price(
+                    Option(rec.S, rec.K, rec.T, rec.r, rec.sigma, rec.type, rec.exercise));
+            } catch (const std::invalid_argument& e) {
+                rec.error = "invalid option";
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (i < invalid_at) {
+                    invalid_at = i;
+                    invalid_message = e.what();
+                }
+            }
+        });
+        stats.price_seconds += since(t);
+
+        // Format.
+        t = Clock::now();
+        if (chunk.text.size() < blocks)
+            chunk.text.resize(blocks);
+        chunk.blocks = blocks;
+        pool_.parallelFor(blocks, [&](std::size_t b, int) {
+            std::string& s = chunk.text[b];
+            s.resize((row_begin[b + 1] - row_begin[b]) * kMaxLine);
+            char* p = &s[0];
+            char* s_end = p + s.size();
+            for (std::size_t i = row_begin[b]; i < row_begin[b + 1]; ++i) {
+                p = std::to_chars(p, s_end, index + i).ptr;
+                *p++ = ',';
+                double v = chunk.prices[i];
+                if (std::isnan(v)) {
+                    std::memcpy(p, "nan", 3);
+                    p += 3;
+                } else {
+                    p = std::to_chars(p, s_end, v).ptr;
+                }
+                *p++ = '\n';
+            }
+            s.resize(p - s.data());
+        });
+        for (std::size_t i = 0; i < n; ++i) {
+            const OptionRecord& rec = chunk.rows[i];
+            if (!rec.error)
+                continue;
+            if (stats.rejected++ == 0)
+                stats.first_error = (binary ? "record " : "line ") + std::to_string(rec.line) +
+                                    ": " + (i == invalid_at ? invalid_message : rec.error);
+        }
+        stats.format_seconds += since(t);
+
+        writer.submit(chunk);
+        index += n;
+        pos = end;
+    }
+
+    writer.finish();
+    stats.records = index;
+    stats.seconds = since(start);
+    return stats;
+}
@@ -0,0 +1,20 @@
+#include "BatchPricer.hpp"
+
+BatchPricer::BatchPricer(const PDESolver& prototype, int threads)
+    : pool_(threads), solvers_(pool_.size(), prototype) {}
+
+int BatchPricer::threads() const {
+    return pool_.size();
+}
+
+void BatchPricer::priceBatch(const Option* options, std::size_t count, double* out) {
+    pool_.parallelFor(count, [&](std::size_t i, int worker) {
+        out[i] = solvers_[worker].price(options[i]);
+    });
+}
+
+std::vector<double> BatchPricer::priceBatch(const std::vector<Option>& options) {
+    std::vector<double> out(options.size());
+    priceBatch(options.data(), options.size(), out.data());
+    return out;
+}
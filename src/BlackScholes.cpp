@@ -1,10 +1,21 @@
 #include "BlackScholes.hpp"
+#include "FastMath.hpp"
 #include <cmath>
 
 double BlackScholes::normalCDF(double x) {
     return 0.5 * std::erfc(-x * M_SQRT1_2);
 }
 
+double BlackScholes::normalPDF(double x) {
+    return 0.5 * M_2_SQRTPI * M_SQRT1_2 * std::exp(-0.5 * x * x);
+}
+
+double BlackScholes::d1(const Option& opt) {
+    return (std::log(opt.S / opt.K) +
+           (opt.r + 0.5 * opt.sigma * opt.sigma) * opt.T) /
+           (opt.sigma * std::sqrt(opt.T));
+}
+
 double BlackScholes::price(const Option& opt) {
     double d1 = (std::log(opt.S / opt.K) + 
                 (opt.r + 0.5 * opt.sigma * opt.sigma) * opt.T) /
@@ -26,3 +37,89 @@ double BlackScholes::delta(const Option& opt) {
         return normalCDF(d1);
     return normalCDF(d1) - 1.0;
 }
+
+double BlackScholes::gamma(const Option& opt) {
+    return normalPDF(d1(opt)) / (opt.S * opt.sigma * std::sqrt(opt.T));
+}
+
+double BlackScholes::vega(const Option& opt) {
+    return opt.S * normalPDF(d1(opt)) * std::sqrt(opt.T);
+}
+
+double BlackScholes::theta(const Option& opt) {
+    double sqrtT = std::sqrt(opt.T);
+    double d1v = d1(opt);
+    double d2v = d1v - opt.sigma * sqrtT;
+    double decay = -opt.S * normalPDF(d1v) * opt.sigma / (2.0 * sqrtT);
+    double rKdf = opt.r * opt.K * std::exp(-opt.r * opt.T);
+    if (opt.type == OptionType::Call)
+        return decay - rKdf * normalCDF(d2v);
+    return decay + rKdf * normalCDF(-d2v);
+}
+
+double BlackScholes::rho(const Option& opt) {
+    double d2v = d1(opt) - opt.sigma * std::sqrt(opt.T);
+    double KTdf = opt.K * opt.T * std::exp(-opt.r * opt.T);
+    if (opt.type == OptionType::Call)
+        return KTdf * normalCDF(d2v);
+    return -KTdf * normalCDF(-d2v);
+}
+
+// ----------------------------------------------------------------
+// Batch kernel. Calls and puts share one code path through the sign
+// w = +1 (call) / -1 (put):
+//
+//   price = w * (S*N(w*d1) - K*df*N(w*d2))
+//   delta = w * N(w*d1)
+//   theta = -S*phi(d1)*sigma/(2*sqrt(T)) - w*r*K*df*N(w*d2)
+//   rho   = w * K*T*df*N(w*d2)
+//
+// gamma, vega, vanna and volga do not depend on the option type.
+// ----------------------------------------------------------------
+
+namespace {
+
+// Inputs and outputs are distinct arrays. GCC only honours __restrict on
+// function parameters, hence the separate kernel; without it every pair
+// of streams needs a run-time overlap check and the loop stays scalar.
+void priceBatchKernel(std::size_t n,
+                      const double* __restrict S, const double* __restrict K,
+                      const double* __restrict T, const double* __restrict r,
+                      const double* __restrict sig, const OptionType* __restrict type,
+                      double* __restrict price, double* __restrict delta,
+                      double* __restrict gamma, double* __restrict vega_out,
+                      double* __restrict theta, double* __restrict rho,
+                      double* __restrict vanna, double* __restrict volga) {
+    for (std::size_t i = 0; i < n; ++i) {
+        double w = (type[i] == OptionType::Call) ? 1.0 : -1.0;
+        double sqrtT = std::sqrt(T[i]);
+        double vol_sqrtT = sig[i] * sqrtT;
+        double d1 = (fastLog(S[i] / K[i]) + (r[i] + 0.5 * sig[i] * sig[i]) * T[i]) / vol_sqrtT;
+        double d2 = d1 - vol_sqrtT;
+
+        double df = fastExp(-r[i] * T[i]);
+        double Nd1 = fastNormalCDF(w * d1);
+        double Nd2 = fastNormalCDF(w * d2);
+        double pdf = fastNormalPDF(d1);
+        double Kdf = K[i] * df;
+
+        double vega = S[i] * pdf * sqrtT;
+
+        price[i]    = w * (S[i] * Nd1 - Kdf * Nd2);
+        delta[i]    = w * Nd1;
+        gamma[i]    = pdf / (S[i] * vol_sqrtT);
+        vega_out[i] = vega;
+        theta[i]    = -S[i] * pdf * sig[i] / (2.0 * sqrtT) - w * r[i] * Kdf * Nd2;
+        rho[i]      = w * T[i] * Kdf * Nd2;
+        vanna[i]    = -pdf * d2 / sig[i];
+        volga[i]    = vega * d1 * d2 / sig[i];
+    }
+}
+
+}  // namespace
+
+void BlackScholes::priceBatch(const BSQuotes& in, const BSGreeks& out) {
+    priceBatchKernel(in.count, in.S, in.K, in.T, in.r, in.sigma, in.type,
+                     out.price, out.delta, out.gamma, out.vega,
+                     out.theta, out.rho, out.vanna, out.volga);
+}
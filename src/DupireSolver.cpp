@@ -0,0 +1,172 @@
+#include "DupireSolver.hpp"
+#include "SolverKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+DupireSolver::DupireSolver(int n_strike, int n_time, GridType grid)
+    : M_(n_strike), N_(n_time), grid_type_(grid) {
+    if (M_ < 10 || N_ < 1)
+        throw std::invalid_argument("DupireSolver: need n_strike >= 10, n_time >= 1");
+    if (grid != GridType::Uniform && grid != GridType::Adaptive && grid != GridType::Sinh)
+        throw std::invalid_argument("DupireSolver: only Uniform, Adaptive and Sinh grids");
+}
+
+void DupireSolver::setLocalVol(LocalVol vol) {
+    local_vol_ = std::move(vol);
+}
+
+void DupireSolver::setRannacherSteps(int steps) {
+    if (steps < 0)
+        throw std::invalid_argument("DupireSolver: Rannacher steps must be >= 0");
+    rannacher_ = steps;
+}
+
+void DupireSolver::setDomainMultiple(double multiple) {
+    if (!(multiple > 1.0))
+        throw std::invalid_argument("DupireSolver: domain multiple must be > 1");
+    domain_ = multiple;
+}
+
+int DupireSolver::lastSteps() const {
+    return steps_;
+}
+
+int DupireSolver::lastFactorizations() const {
+    return factorizations_;
+}
+
+// The initial condition has its kink at K = S0, so the strike grid is
+// the one PDESolver would build for a contract struck at the spot.
+void DupireSolver::buildGrid(double spot, double sigma, double T_max) {
+    GridShape shape = gridShape(grid_type_, domain_, spot, spot, sigma, T_max);
+    switch (grid_type_) {
+    case GridType::Uniform:
+        grid_ = std::make_shared<UniformGrid>(shape.S_max, M_);
+        break;
+    case GridType::Adaptive:
+        grid_ = std::make_shared<AdaptiveGrid>(shape.S_max, M_, spot);
+        break;
+    default:
+        grid_ = std::make_shared<SinhGrid>(shape.S_max, M_, std::vector<double>{spot},
+                                           shape.alpha);
+    }
+}
+
+// Forward operator at maturity T and the Crank-Nicolson step of size dt.
+void DupireSolver::assemble(double r, double sigma, double T, double dt) {
+    int n = grid_->size();
+    const double* K = grid_->nodes().data();
+    TridiagonalOperator& op = step_.coeff;
+    op.resize(n);
+    auto fill = [&](const auto& vol2) {
+        if (grid_type_ == GridType::Uniform)
+            kernels::fillForwardOperator<kernels::UniformSpacing>(K, n, vol2, r, op.a.data(),
+                                                                  op.b.data(), op.c.data());
+        else
+            kernels::fillForwardOperator<kernels::GeneralSpacing>(K, n, vol2, r, op.a.data(),
+                                                                  op.b.data(), op.c.data());
+    };
+
+    if (local_vol_) {
+        vol2_.assign(n, 0.0);
+        for (int i = 1; i < n - 1; ++i) {
+            double s = local_vol_(K[i], T);
+            if (!(s > 0.0))
+                throw std::invalid_argument("DupireSolver: local volatility must be positive");
+            vol2_[i] = s * s;
+        }
+        const double* v2 = vol2_.data();
+        fill([v2](int i) { return v2[i]; });
+    } else {
+        double sig2 = sigma * sigma;
+        fill([sig2](int) { return sig2; });
+    }
+    step_.factor(dt, Elimination::Forward);
+}
+
+// ----------------------------------------------------------------
+// Forward sweep from T = 0 to the longest maturity, in segments ending
+// at each requested maturity as in PDESolver::marchFixed. Each segment
+// gets a whole number of steps as close as possible to T_max / N_.
+// ----------------------------------------------------------------
+
+std::vector<StrikeSlice> DupireSolver::solve(double spot, double r, double sigma,
+                                             OptionType type,
+                                             const std::vector<double>& maturities) {
+    if (!(spot > 0.0) || !(sigma > 0.0))
+        throw std::invalid_argument("DupireSolver: need spot > 0, sigma > 0");
+    if (maturities.empty())
+        throw std::invalid_argument("DupireSolver: need at least one maturity");
+    for (double T : maturities)
+        if (!(T > 0.0))
+            throw std::invalid_argument("DupireSolver: maturities must be positive");
+
+    std::vector<double> stops = maturities;
+    std::sort(stops.begin(), stops.end());
+    stops.erase(std::unique(stops.begin(), stops.end()), stops.end());
+    double T_max = stops.back();
+
+    buildGrid(spot, sigma, T_max);
+    int n = grid_->size();
+    const double* K = grid_->nodes().data();
+    double K_max = K[n - 1];
+    bool call = type == OptionType::Call;
+
+    // Initial condition: the payoff as a function of the strike.
+    V_.resize(n);
+    for (int i = 0; i < n; ++i)
+        V_[i] = call ? std::max(spot - K[i], 0.0) : std::max(K[i] - spot, 0.0);
+    auto setBoundaries = [&](std::vector<double>& V, double T) {
+        V[0] = call ? spot : 0.0;
+        V[n - 1] = call ? 0.0 : K_max * std::exp(-r * T) - spot;
+    };
+    rhs_.resize(n);
+
+    std::vector<std::vector<double>> levels(stops.size());
+    const double nominal = T_max / N_;
+    double factored = 0.0;
+    steps_ = factorizations_ = 0;
+    double start = 0.0;
+    for (std::size_t seg = 0; seg < stops.size(); ++seg) {
+        double end = stops[seg];
+        int steps = std::max(1, static_cast<int>(std::lround((end - start) / nominal)));
+        double dt = (end - start) / steps;
+        for (int k = 1; k <= steps; ++k) {
+            double T = start + k * dt;
+            if (local_vol_ || dt != factored) {
+                assemble(r, sigma, T - 0.5 * dt, dt);
+                factored = dt;
+                ++factorizations_;
+            }
+            if (steps_ < rannacher_) {
+                setBoundaries(V_, T - 0.5 * dt);
+                step_.implicit.solve(V_, V_);
+                setBoundaries(V_, T);
+                step_.implicit.solve(V_, V_);
+            } else {
+                // The explicit half sees the old boundary values and only
+                // the solve the new ones, as in PDESolver's adaptive steps:
+                // the put's value at K_max moves every step, and setting it
+                // first would be a first-order error next to it.
+                const TridiagonalOperator& w = step_.weights;
+                for (int i = 1; i < n - 1; ++i)
+                    rhs_[i] = w.a[i] * V_[i - 1] + w.b[i] * V_[i] + w.c[i] * V_[i + 1];
+                setBoundaries(rhs_, T);
+                step_.implicit.solve(rhs_, V_);
+            }
+            ++steps_;
+        }
+        levels[seg] = V_;
+        start = end;
+    }
+
+    std::vector<StrikeSlice> out;
+    out.reserve(maturities.size());
+    for (double T : maturities) {
+        std::size_t k = std::lower_bound(stops.begin(), stops.end(), T) - stops.begin();
+        out.push_back({T, PriceSurface(grid_->nodes(), levels[k])});
+    }
+    return out;
+}
@@ -3,6 +3,19 @@
 #include <cmath>
 #include <stdexcept>
 
+GridShape gridShape(GridType grid, double domain, double K, double S, double sigma, double T) {
+    double S_max = domain * K;
+    double spread = sigma * std::sqrt(T);
+    if (grid == GridType::LogUniform || grid == GridType::LogSinh) {
+        double L = std::max(std::log(domain), std::abs(std::log(S / K)) + 3.0 * spread);
+        double alpha = grid == GridType::LogSinh ? kSinhWidth * spread : 0.0;
+        return {K * std::exp(L), alpha, L};
+    }
+    if (grid != GridType::Sinh && grid != GridType::SinhRefined)
+        return {S_max, 0.0, 0.0};
+    return {std::max(S_max, K * std::exp(3.0 * spread)), kSinhWidth * K * spread, 0.0};
+}
+
 // --- Grid base class ---
 
 int Grid::size() const {
@@ -10,11 +23,11 @@ int Grid::size() const {
 }
 
 double Grid::spot(int i) const {
-    return nodes_.at(i);
+    return nodes_[i];
 }
 
 double Grid::spacing(int i) const {
-    return nodes_.at(i + 1) - nodes_.at(i);
+    return nodes_[i + 1] - nodes_[i];
 }
 
 int Grid::findIndex(double S) const {
@@ -31,6 +44,10 @@ const std::vector<double>& Grid::nodes() const {
 // --- UniformGrid ---
 
 UniformGrid::UniformGrid(double S_max, int M) {
+    assign(S_max, M);
+}
+
+void UniformGrid::assign(double S_max, int M) {
     if (M < 2 || S_max <= 0.0)
         throw std::invalid_argument("UniformGrid: need M >= 2, S_max > 0");
     nodes_.resize(M + 1);
@@ -0,0 +1,445 @@
+#include "HestonSolver.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <utility>
+
+// ----------------------------------------------------------------
+// Semi-analytic price
+// ----------------------------------------------------------------
+
+namespace {
+
+using cplx = std::complex<double>;
+
+// e^{i phi ln S} E[e^{i phi ln S_T}]-type integrand of Heston's P_j, in
+// the little-trap form (g built from beta - d), which keeps the complex
+// logarithm on its principal branch for any maturity.
+cplx characteristic(double phi, double u, double b, const Option& o, const HestonParams& m) {
+    const cplx i(0.0, 1.0);
+    double xi2 = m.xi * m.xi;
+    cplx beta = b - m.rho * m.xi * i * phi;
+    cplx d = std::sqrt(beta * beta - xi2 * (2.0 * u * i * phi - phi * phi));
+    cplx g = (beta - d) / (beta + d);
+    cplx e = std::exp(-d * o.T);
+    cplx D = (beta - d) / xi2 * (1.0 - e) / (1.0 - g * e);
+    cplx C = o.r * i * phi * o.T +
+             m.kappa * m.theta / xi2 * ((beta - d) * o.T - 2.0 * std::log((1.0 - g * e) / (1.0 - g)));
+    return std::exp(C + D * m.v0 + i * phi * std::log(o.S));
+}
+
+void validate(const HestonParams& m) {
+    if (!(m.v0 >= 0.0) || !(m.kappa > 0.0) || !(m.theta > 0.0) || !(m.xi > 0.0) ||
+        !(m.rho >= -1.0 && m.rho <= 1.0))
+        throw std::invalid_argument(
+            "Heston: need v0 >= 0, kappa, theta, xi > 0 and -1 <= rho <= 1");
+}
+
+}  // namespace
+
+// C = (S - K e^{-rT}) / 2 + 1/pi int_0^inf Re[e^{-i phi ln K} (S f1 - K e^{-rT} f2) / (i phi)],
+// over panels of width 1/2 with 8-point Gauss-Legendre, until three
+// panels in a row contribute nothing.
+double hestonPrice(const Option& option, const HestonParams& model) {
+    validate(model);
+    static const double x[4] = {0.1834346424956498, 0.5255324099163290, 0.7966664774136267,
+                                0.9602898564975363};
+    static const double w[4] = {0.3626837833783620, 0.3137066458778873, 0.2223810344533745,
+                                0.1012285362903763};
+    const cplx i(0.0, 1.0);
+    double disc = option.K * std::exp(-option.r * option.T);
+    double lnK = std::log(option.K);
+    auto integrand = [&](double phi) {
+        cplx f1 = characteristic(phi, 0.5, model.kappa - model.rho * model.xi, option, model);
+        cplx f2 = characteristic(phi, -0.5, model.kappa, option, model);
+        return (std::exp(-i * phi * lnK) * (option.S * f1 - disc * f2) / (i * phi)).real();
+    };
+
+    const double width = 0.5;
+    double integral = 0.0;
+    int quiet = 0;
+    for (int p = 0; p < 4000 && quiet < 3; ++p) {
+        double mid = (p + 0.5) * width, half = 0.5 * width;
+        double panel = 0.0;
+        for (int k = 0; k < 4; ++k)
+            panel += w[k] * (integrand(mid - half * x[k]) + integrand(mid + half * x[k]));
+        panel *= half;
+        integral += panel;
+        quiet = std::abs(panel) < 1e-15 * option.S ? quiet + 1 : 0;
+    }
+    double call = 0.5 * (option.S - disc) + integral / M_PI;
+    return option.type == OptionType::Call ? call : call - option.S + disc;
+}
+
+// ----------------------------------------------------------------
+// HestonSolver
+// ----------------------------------------------------------------
+
+namespace {
+
+// Columns per v-sweep task: one cache line of doubles in each row.
+constexpr int kColumnBlock = 8;
+
+}  // namespace
+
+HestonSolver::HestonSolver(int n_spot, int n_var, int n_time, AdiScheme scheme, int threads)
+    : M_(n_spot), P_(n_var), N_(n_time), scheme_(scheme), pool_(threads),
+      line_(pool_.size()) {
+    if (M_ < 10 || P_ < 10 || N_ < 1)
+        throw std::invalid_argument("HestonSolver: need n_spot, n_var >= 10 and n_time >= 1");
+}
+
+void HestonSolver::setRannacherSteps(int steps) {
+    if (steps < 0)
+        throw std::invalid_argument("HestonSolver: Rannacher steps must be >= 0");
+    rannacher_ = steps;
+}
+
+void HestonSolver::setDomainMultiple(double multiple) {
+    if (!(multiple > 1.0))
+        throw std::invalid_argument("HestonSolver: domain multiple must be > 1");
+    domain_ = multiple;
+}
+
+void HestonSolver::setMaxVariance(double v_max) {
+    if (!(v_max > 0.0))
+        throw std::invalid_argument("HestonSolver: maximum variance must be positive");
+    v_max_ = v_max;
+}
+
+int HestonSolver::threads() const {
+    return pool_.size();
+}
+
+const Grid& HestonSolver::spotGrid() const {
+    return *s_grid_;
+}
+
+const Grid& HestonSolver::varianceGrid() const {
+    return *v_grid_;
+}
+
+const std::vector<double>& HestonSolver::values() const {
+    return U_;
+}
+
+// S clustered at the strike (and the spot), with In 't Hout and Foulon's
+// width K / 5; v clustered at 0, where the solution bends most, and v0.
+void HestonSolver::buildGrids(const Option& option, const HestonParams& model) {
+    double S_max = domain_ * std::max(option.K, option.S);
+    double V_max = std::max(v_max_, 2.0 * model.v0);
+    if (!s_grid_) {
+        s_grid_ = std::make_unique<SinhGrid>(S_max, M_, std::vector<double>{option.K, option.S},
+                                             0.2 * option.K);
+        v_grid_ = std::make_unique<SinhGrid>(V_max, P_, std::vector<double>{0.0, model.v0},
+                                             V_max / 500.0);
+    } else {
+        s_grid_->assign(S_max, M_, {option.K, option.S}, 0.2 * option.K);
+        v_grid_->assign(V_max, P_, {0.0, model.v0}, V_max / 500.0);
+    }
+    ns_ = s_grid_->size();
+    nv_ = v_grid_->size();
+}
+
+// Stencil coefficients; see the class comment for the operator split.
+void HestonSolver::assemble(const Option& option, const HestonParams& model) {
+    const double* S = s_grid_->nodes().data();
+    const double* v = v_grid_->nodes().data();
+    double r = option.r;
+    for (auto* a : {&pa_, &pb_, &pc_, &qa_, &qb_, &qc_, &wsa_, &wsb_, &wsc_})
+        a->assign(ns_, 0.0);
+    for (auto* a : {&a2a_, &a2b_, &a2c_, &wva_, &wvb_, &wvc_})
+        a->assign(nv_, 0.0);
+
+    for (int i = 1; i < ns_ - 1; ++i) {
+        double hp = S[i + 1] - S[i], hm = S[i] - S[i - 1];
+        double inv_denom = 1.0 / (hp * hm * (hp + hm));
+        double d1a = -hp * hp * inv_denom, d1b = (hp * hp - hm * hm) * inv_denom,
+               d1c = hm * hm * inv_denom;
+        double half_s2 = 0.5 * S[i] * S[i] * 2.0 * inv_denom;
+        pa_[i] = half_s2 * hp;
+        pb_[i] = -half_s2 * (hp + hm);
+        pc_[i] = half_s2 * hm;
+        qa_[i] = r * S[i] * d1a;
+        qb_[i] = r * S[i] * d1b - 0.5 * r;
+        qc_[i] = r * S[i] * d1c;
+        wsa_[i] = S[i] * d1a;
+        wsb_[i] = S[i] * d1b;
+        wsc_[i] = S[i] * d1c;
+    }
+
+    // v = 0: u_tau = r S u_S + kappa theta u_v - r u, forward in v.
+    double h0 = v[1] - v[0];
+    a2b_[0] = -model.kappa * model.theta / h0 - 0.5 * r;
+    a2c_[0] = model.kappa * model.theta / h0;
+    for (int j = 1; j < nv_ - 1; ++j) {
+        double hp = v[j + 1] - v[j], hm = v[j] - v[j - 1];
+        double inv_denom = 1.0 / (hp * hm * (hp + hm));
+        double d1a = -hp * hp * inv_denom, d1b = (hp * hp - hm * hm) * inv_denom,
+               d1c = hm * hm * inv_denom;
+        double diff = 0.5 * model.xi * model.xi * v[j] * 2.0 * inv_denom;
+        double mu = model.kappa * (model.theta - v[j]);
+        a2a_[j] = diff * hp + mu * d1a;
+        a2b_[j] = -diff * (hp + hm) + mu * d1b - 0.5 * r;
+        a2c_[j] = diff * hm + mu * d1c;
+        if (a2a_[j] < 0.0 || a2c_[j] < 0.0) {
+            // Drift-dominated: first-order upwind keeps the matrix an M-matrix.
+            a2a_[j] = diff * hp + (mu < 0.0 ? -mu / hm : 0.0);
+            a2c_[j] = diff * hm + (mu > 0.0 ? mu / hp : 0.0);
+            a2b_[j] = -diff * (hp + hm) - std::abs(mu) / (mu > 0.0 ? hp : hm) - 0.5 * r;
+        }
+        double c = model.rho * model.xi * v[j];
+        wva_[j] = c * d1a;
+        wvb_[j] = c * d1b;
+        wvc_[j] = c * d1c;
+    }
+}
+
+void HestonSolver::factor(double theta_dt) {
+    if (theta_dt == factored_)
+        return;
+    // S rows in groups of `lanes`, interleaved; lanes past the last row
+    // below v_max solve the identity.
+    const int W = LaneTridiagonalLU::lanes;
+    const double* v = v_grid_->nodes().data();
+    s_lu_.resize((nv_ - 1 + W - 1) / W);
+    std::vector<double> lower(ns_ * W), diag(ns_ * W), upper(ns_ * W);
+    for (std::size_t g = 0; g < s_lu_.size(); ++g) {
+        std::fill(lower.begin(), lower.end(), 0.0);
+        std::fill(diag.begin(), diag.end(), 1.0);
+        std::fill(upper.begin(), upper.end(), 0.0);
+        for (int l = 0; l < W; ++l) {
+            int j = static_cast<int>(g) * W + l;
+            if (j >= nv_ - 1)
+                break;
+            for (int i = 1; i < ns_ - 1; ++i) {
+                lower[i * W + l] = -theta_dt * (v[j] * pa_[i] + qa_[i]);
+                diag[i * W + l] = 1.0 - theta_dt * (v[j] * pb_[i] + qb_[i]);
+                upper[i * W + l] = -theta_dt * (v[j] * pc_[i] + qc_[i]);
+            }
+        }
+        s_lu_[g].factor(lower, diag, upper);
+    }
+
+    lower.assign(nv_, 0.0);
+    diag.assign(nv_, 1.0);
+    upper.assign(nv_, 0.0);
+    for (int j = 0; j < nv_ - 1; ++j) {
+        lower[j] = -theta_dt * a2a_[j];
+        diag[j] = 1.0 - theta_dt * a2b_[j];
+        upper[j] = -theta_dt * a2c_[j];
+    }
+    v_lu_.factor(lower, diag, upper);
+    factored_ = theta_dt;
+}
+
+namespace {
+
+// One row of constant v of A0 U, A1 U and A2 U, at nodes 1..n-2, given
+// the rows below (um), at (u) and above (up). Outputs and inputs are
+// distinct arrays; as in BlackScholes.cpp, __restrict on the parameters
+// is what lets GCC vectorize the loop without run-time overlap checks.
+struct HestonRow {
+    double v;                  // variance of the row
+    double ea, eb, ec;         // A2 stencil
+    double ma, mb, mc;         // A0 weights in v
+};
+
+void applyRow(int n, const HestonRow& row,
+              const double* __restrict pa, const double* __restrict pb,
+              const double* __restrict pc, const double* __restrict qa,
+              const double* __restrict qb, const double* __restrict qc,
+              const double* __restrict wsa, const double* __restrict wsb,
+              const double* __restrict wsc, const double* __restrict um,
+              const double* __restrict u, const double* __restrict up,
+              double* __restrict f0, double* __restrict f1, double* __restrict f2) {
+    const double v = row.v;
+    for (int i = 1; i < n - 1; ++i) {
+        f1[i] = (v * pa[i] + qa[i]) * u[i - 1] + (v * pb[i] + qb[i]) * u[i] +
+                (v * pc[i] + qc[i]) * u[i + 1];
+        f2[i] = row.ea * um[i] + row.eb * u[i] + row.ec * up[i];
+        f0[i] = row.ma * (wsa[i] * um[i - 1] + wsb[i] * um[i] + wsc[i] * um[i + 1]) +
+                row.mb * (wsa[i] * u[i - 1] + wsb[i] * u[i] + wsc[i] * u[i + 1]) +
+                row.mc * (wsa[i] * up[i - 1] + wsb[i] * up[i] + wsc[i] * up[i + 1]);
+    }
+}
+
+}  // namespace
+
+// A0 U, A1 U and A2 U at the interior nodes, by rows of constant v. The
+// boundary entries are never written and stay zero.
+void HestonSolver::apply(const std::vector<double>& U, std::vector<double>& A0U,
+                         std::vector<double>& A1U, std::vector<double>& A2U) {
+    const double* v = v_grid_->nodes().data();
+    pool_.parallelFor(nv_ - 1, [&](std::size_t jj, int) {
+        int j = static_cast<int>(jj);
+        std::size_t at = jj * ns_;
+        const double* u = U.data() + at;
+        const double* um = j > 0 ? u - ns_ : u;   // a2a_[0] = wv*_[0] = 0
+        HestonRow row{v[j], a2a_[j], a2b_[j], a2c_[j], wva_[j], wvb_[j], wvc_[j]};
+        applyRow(ns_, row, pa_.data(), pb_.data(), pc_.data(), qa_.data(), qb_.data(),
+                 qc_.data(), wsa_.data(), wsb_.data(), wsc_.data(), um, u, u + ns_,
+                 A0U.data() + at, A1U.data() + at, A2U.data() + at);
+    });
+}
+
+void HestonSolver::setBoundaries(std::vector<double>& U, const Option& option,
+                                 double tau) const {
+    const double* S = s_grid_->nodes().data();
+    double disc = option.K * std::exp(-option.r * tau);
+    bool call = option.type == OptionType::Call;
+    double* top = U.data() + static_cast<std::size_t>(nv_ - 1) * ns_;
+    for (int i = 0; i < ns_; ++i)
+        top[i] = call ? S[i] : disc;
+    for (int j = 0; j < nv_ - 1; ++j) {
+        double* row = U.data() + static_cast<std::size_t>(j) * ns_;
+        row[0] = call ? 0.0 : disc;
+        row[ns_ - 1] = call ? S[ns_ - 1] - disc : 0.0;
+    }
+}
+
+// One time step from tau to tau + dt with the factors for theta * dt.
+// `douglas` stops after the first pass whatever the scheme.
+void HestonSolver::step(const Option& option, double tau, double dt, double theta,
+                        bool douglas) {
+    std::size_t row_nv = static_cast<std::size_t>(nv_ - 1) * ns_;
+
+    // The S sweep: solve (I - theta dt A1) x = rhs(j) on every row below
+    // v_max, `lanes` rows at a time; rhs(j, line, stride) writes row j to
+    // line[i * stride]. The v_max row is copied from Y0.
+    auto sweepS = [&](std::vector<double>& out, const auto& rhs) {
+        const int W = LaneTridiagonalLU::lanes;
+        pool_.parallelFor(s_lu_.size(), [&](std::size_t g, int worker) {
+            std::vector<double>& lines = line_[worker];
+            int j0 = static_cast<int>(g) * W;
+            int rows = std::min(W, nv_ - 1 - j0);
+            if (rows < W)
+                lines.assign(static_cast<std::size_t>(ns_) * W, 0.0);
+            else
+                lines.resize(static_cast<std::size_t>(ns_) * W);
+            for (int l = 0; l < rows; ++l)
+                rhs(static_cast<std::size_t>(j0 + l) * ns_, lines.data() + l, W);
+            s_lu_[g].solve(lines, lines);
+            for (int l = 0; l < rows; ++l) {
+                double* o = out.data() + static_cast<std::size_t>(j0 + l) * ns_;
+                for (int i = 0; i < ns_; ++i)
+                    o[i] = lines[i * W + l];
+            }
+        });
+        std::copy(Y0_.begin() + row_nv, Y0_.end(), out.begin() + row_nv);
+    };
+    // The v sweep: out -= theta dt A2W, then (I - theta dt A2) on blocks
+    // of interior columns.
+    auto sweepV = [&](std::vector<double>& out, const std::vector<double>& A2W) {
+        int columns = ns_ - 2;
+        int blocks = (columns + kColumnBlock - 1) / kColumnBlock;
+        double c = theta * dt;
+        pool_.parallelFor(blocks, [&](std::size_t b, int) {
+            int i0 = 1 + static_cast<int>(b) * kColumnBlock;
+            int count = std::min(kColumnBlock, ns_ - 1 - i0);
+            for (int j = 0; j < nv_ - 1; ++j) {
+                double* o = out.data() + static_cast<std::size_t>(j) * ns_ + i0;
+                const double* w = A2W.data() + static_cast<std::size_t>(j) * ns_ + i0;
+                for (int l = 0; l < count; ++l)
+                    o[l] -= c * w[l];
+            }
+            v_lu_.solveColumns(out.data() + i0, ns_, count);
+        });
+    };
+
+    // Y0 = U + dt A U, with the boundaries at tau + dt, formed row by row
+    // inside the first S sweep.
+    apply(U_, F0_, F1_, F2_);
+    setBoundaries(Y0_, option, tau + dt);
+    double c = theta * dt;
+    sweepS(Y_, [&](std::size_t at, double* line, int stride) {
+        double* y0 = Y0_.data() + at;
+        const double* u = U_.data() + at;
+        const double* f0 = F0_.data() + at;
+        const double* f1 = F1_.data() + at;
+        const double* f2 = F2_.data() + at;
+        line[0] = y0[0];
+        line[(ns_ - 1) * stride] = y0[ns_ - 1];
+        for (int i = 1; i < ns_ - 1; ++i) {
+            y0[i] = u[i] + dt * (f0[i] + f1[i] + f2[i]);
+            line[i * stride] = y0[i] - c * f1[i];
+        }
+    });
+    sweepV(Y_, F2_);
+    if (douglas || scheme_ == AdiScheme::Douglas) {
+        std::swap(U_, Y_);
+        return;
+    }
+
+    // Second pass into U_, which is no longer needed.
+    apply(Y_, G0_, G1_, G2_);
+    if (scheme_ == AdiScheme::CraigSneyd) {
+        sweepS(U_, [&](std::size_t at, double* line, int stride) {
+            const double* y0 = Y0_.data() + at;
+            const double* g0 = G0_.data() + at;
+            const double* f0 = F0_.data() + at;
+            const double* f1 = F1_.data() + at;
+            for (int i = 0; i < ns_; ++i)
+                line[i * stride] = y0[i] + 0.5 * dt * (g0[i] - f0[i]) - c * f1[i];
+        });
+        sweepV(U_, F2_);
+    } else {
+        sweepS(U_, [&](std::size_t at, double* line, int stride) {
+            const double* y0 = Y0_.data() + at;
+            const double* g0 = G0_.data() + at;
+            const double* g1 = G1_.data() + at;
+            const double* g2 = G2_.data() + at;
+            const double* f0 = F0_.data() + at;
+            const double* f1 = F1_.data() + at;
+            const double* f2 = F2_.data() + at;
+            for (int i = 0; i < ns_; ++i)
+                line[i * stride] = y0[i] +
+                                   0.5 * dt * (g0[i] + g1[i] + g2[i] - f0[i] - f1[i] - f2[i]) -
+                                   c * g1[i];
+        });
+        sweepV(U_, G2_);
+    }
+}
+
+double HestonSolver::price(const Option& option, const HestonParams& model) {
+    if (option.exercise != ExerciseType::European)
+        throw std::invalid_argument("HestonSolver: European options only");
+    validate(model);
+
+    buildGrids(option, model);
+    assemble(option, model);
+    factored_ = 0.0;
+    std::size_t n = static_cast<std::size_t>(ns_) * nv_;
+    for (auto* a : {&Y0_, &Y_, &F0_, &F1_, &F2_, &G0_, &G1_, &G2_})
+        a->assign(n, 0.0);
+    U_.resize(n);
+    const double* S = s_grid_->nodes().data();
+    for (int j = 0; j < nv_; ++j)
+        for (int i = 0; i < ns_; ++i)
+            U_[static_cast<std::size_t>(j) * ns_ + i] = option.payoff(S[i]);
+
+    double theta = scheme_ == AdiScheme::HundsdorferVerwer ? 0.5 + std::sqrt(3.0) / 6.0 : 0.5;
+    double dt = option.T / N_;
+    for (int k = 0; k < N_; ++k) {
+        double tau = k * dt;
+        if (k < rannacher_) {
+            factor(0.5 * dt);
+            step(option, tau, 0.5 * dt, 1.0, true);
+            step(option, tau + 0.5 * dt, 0.5 * dt, 1.0, true);
+        } else {
+            factor(theta * dt);
+            step(option, tau, dt, theta, false);
+        }
+    }
+
+    // Bilinear in (S, v); exact when both are nodes, as they are here.
+    int i = std::min(s_grid_->findIndex(option.S), ns_ - 2);
+    int j = std::min(v_grid_->findIndex(model.v0), nv_ - 2);
+    const double* v = v_grid_->nodes().data();
+    double ws = (option.S - S[i]) / (S[i + 1] - S[i]);
+    double wv = (model.v0 - v[j]) / (v[j + 1] - v[j]);
+    auto u = [&](int a, int b) { return U_[static_cast<std::size_t>(b) * ns_ + a]; };
+    return (1.0 - wv) * ((1.0 - ws) * u(i, j) + ws * u(i + 1, j)) +
+           wv * ((1.0 - ws) * u(i, j + 1) + ws * u(i + 1, j + 1));
+}
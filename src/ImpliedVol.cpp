@@ -0,0 +1,198 @@
+#include "ImpliedVol.hpp"
+#include "BlackScholes.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Black-Scholes call on spot S with discounted strike X = K e^-rT, at
+// volatility s: price, vega and volga.
+struct CallValue {
+    double price, vega, volga;
+};
+
+CallValue callValue(double S, double X, double T, double s) {
+    double sqrtT = std::sqrt(T);
+    double v = s * sqrtT;
+    double d1 = std::log(S / X) / v + 0.5 * v;
+    double d2 = d1 - v;
+    double vega = S * BlackScholes::normalPDF(d1) * sqrtT;
+    double price = S * BlackScholes::normalCDF(d1) - X * BlackScholes::normalCDF(d2);
+    return {price, vega, vega * d1 * d2 / s};
+}
+
+// Corrado-Miller: inverting a quadratic expansion of the call price
+// around the money,
+//
+//   s sqrt(T) ~ sqrt(2 pi) / (S + X) * (C - (S - X)/2
+//               + sqrt((C - (S - X)/2)^2 - (S - X)^2 / pi)).
+//
+// Within a few percent near the money; far from it the square root can
+// go negative, and the guess is only a starting point for the bracket.
+double initialGuess(double C, double S, double X, double T) {
+    double m = C - 0.5 * (S - X);
+    double disc = m * m - (S - X) * (S - X) / M_PI;
+    double s = std::sqrt(2.0 * M_PI) / (S + X) * (m + std::sqrt(std::max(disc, 0.0))) /
+               std::sqrt(T);
+    return std::isfinite(s) && s > 1e-3 ? std::min(s, 5.0) : 0.2;
+}
+
+// Narrows [lo, hi] with the sign of f = model - quote (increasing in s)
+// and keeps `next` inside it: bisection once both ends are known,
+// doubling while the root is only bounded below.
+double bracketed(double next, double s, double f, double& lo, double& hi) {
+    if (f > 0.0)
+        hi = s;
+    else
+        lo = s;
+    if (next > lo && next < hi)
+        return next;
+    return std::isfinite(hi) ? 0.5 * (lo + hi) : 2.0 * s;
+}
+
+PDESolver defaultPrototype() {
+    PDESolver solver(200, 200, GridType::Sinh);
+    solver.setRannacherSteps(2);
+    solver.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+    return solver;
+}
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+}  // namespace
+
+ImpliedVolSolver::ImpliedVolSolver(int threads)
+    : ImpliedVolSolver(defaultPrototype(), threads) {}
+
+ImpliedVolSolver::ImpliedVolSolver(const PDESolver& prototype, int threads)
+    : pool_(threads), solvers_(pool_.size(), prototype) {}
+
+int ImpliedVolSolver::threads() const {
+    return pool_.size();
+}
+
+void ImpliedVolSolver::setTolerance(double european, double american) {
+    if (!(european > 0.0) || !(american > 0.0))
+        throw std::invalid_argument("ImpliedVolSolver: tolerances must be positive");
+    tol_european_ = european;
+    tol_american_ = american;
+}
+
+void ImpliedVolSolver::setMaxIterations(int iterations) {
+    if (iterations < 1)
+        throw std::invalid_argument("ImpliedVolSolver: need at least one iteration");
+    max_iter_ = iterations;
+}
+
+ImpliedVolResult ImpliedVolSolver::solve(const Option& option, double price) {
+    return option.exercise == ExerciseType::American ? solveAmerican(option, price, solvers_[0])
+                                                     : solveEuropean(option, price);
+}
+
+void ImpliedVolSolver::solveBatch(const Option* options, const double* prices,
+                                  std::size_t count, ImpliedVolResult* out) {
+    pool_.parallelFor(count, [&](std::size_t i, int worker) {
+        const Option& option = options[i];
+        out[i] = option.exercise == ExerciseType::American
+                     ? solveAmerican(option, prices[i], solvers_[worker])
+                     : solveEuropean(option, prices[i]);
+    });
+}
+
+std::vector<ImpliedVolResult> ImpliedVolSolver::solveBatch(const std::vector<Option>& options,
+                                                           const std::vector<double>& prices) {
+    if (options.size() != prices.size())
+        throw std::invalid_argument("ImpliedVolSolver: need one price per option");
+    std::vector<ImpliedVolResult> out(options.size());
+    solveBatch(options.data(), prices.data(), options.size(), out.data());
+    return out;
+}
+
+// ----------------------------------------------------------------
+// Europeans: Halley on the call price, f(s) = C(s) - quote, with
+//
+//   s' = s - (f / f') / (1 - f f'' / (2 f'^2)),  f' = vega, f'' = volga.
+//
+// Where the correction factor is small (far from the root, or past an
+// inflection of C(s)) the plain Newton step is taken instead.
+// ----------------------------------------------------------------
+
+ImpliedVolResult ImpliedVolSolver::solveEuropean(const Option& option, double price) const {
+    double S = option.S, T = option.T;
+    double X = option.K * std::exp(-option.r * T);
+    bool call = option.type == OptionType::Call;
+    double lower = call ? std::max(S - X, 0.0) : std::max(X - S, 0.0);
+    double upper = call ? S : X;
+    if (!(price > lower))
+        return {kNaN, 0, VolStatus::BelowBound};
+    if (!(price < upper))
+        return {kNaN, 0, VolStatus::AboveBound};
+
+    double C = call ? price : price + S - X;
+    double s = initialGuess(C, S, X, T);
+    double lo = 0.0, hi = std::numeric_limits<double>::infinity();
+    for (int it = 1; it <= max_iter_; ++it) {
+        CallValue v = callValue(S, X, T, s);
+        double f = v.price - C;
+        if (std::abs(f) <= 4.0 * DBL_EPSILON * S)
+            return {s, it, VolStatus::Converged};
+
+        double newton = f / v.vega;
+        double h = 1.0 - 0.5 * newton * v.volga / v.vega;
+        double next = bracketed(s - (h > 0.5 ? newton / h : newton), s, f, lo, hi);
+        if (std::abs(next - s) <= tol_european_)
+            return {next, it, VolStatus::Converged};
+        s = next;
+    }
+    return {s, max_iter_, VolStatus::NoConvergence};
+}
+
+// ----------------------------------------------------------------
+// Americans: secant steps on the PDE price, each costing one solve. The
+// first step has no previous iterate and uses the Black-Scholes vega,
+// which differs from the American one only by the vega of the
+// early-exercise premium.
+// ----------------------------------------------------------------
+
+ImpliedVolResult ImpliedVolSolver::solveAmerican(const Option& option, double price,
+                                                 PDESolver& solver) const {
+    double S = option.S, K = option.K, T = option.T;
+    double X = K * std::exp(-option.r * T);
+    bool call = option.type == OptionType::Call;
+    double lower = call ? std::max(S - X, 0.0) : std::max(K - S, 0.0);
+    double upper = call ? S : K;
+    if (!(price > lower))
+        return {kNaN, 0, VolStatus::BelowBound};
+    if (!(price < upper))
+        return {kNaN, 0, VolStatus::AboveBound};
+
+    Option european = option;
+    european.exercise = ExerciseType::European;
+    ImpliedVolResult guess = solveEuropean(european, price);
+    double s = guess.status == VolStatus::Converged ? std::min(std::max(guess.vol, 1e-3), 5.0)
+                                                    : 0.2;
+
+    // The grid is shaped for the first iterate and kept for the rest.
+    Option contract = option;
+    contract.sigma = s;
+    double f = solver.priceAtVolatility(contract, s) - price;
+    double slope = callValue(S, X, T, s).vega;
+    double lo = 0.0, hi = std::numeric_limits<double>::infinity();
+    for (int it = 1;; ++it) {
+        if (std::abs(f) <= 4.0 * DBL_EPSILON * upper)
+            return {s, it, VolStatus::Converged};
+        double next = bracketed(s - f / slope, s, f, lo, hi);
+        if (std::abs(next - s) <= tol_american_)
+            return {next, it, VolStatus::Converged};
+        if (it == max_iter_)
+            return {s, it, VolStatus::NoConvergence};
+
+        double f_next = solver.priceAtVolatility(contract, next) - price;
+        slope = (f_next - f) / (next - s);
+        s = next;
+        f = f_next;
+    }
+}
@@ -0,0 +1,66 @@
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Bucket b < 32 holds the value b. Above, a value v in [2^e, 2^(e+1)),
+// e >= 5, goes to (e - 4) * 32 + the 5 bits below its leading one.
+LatencyHistogram::LatencyHistogram() : buckets_((64 - kSubBits + 1) * kSub, 0) {}
+
+int LatencyHistogram::bucket(std::uint64_t ns) {
+    if (ns < static_cast<std::uint64_t>(kSub))
+        return static_cast<int>(ns);
+    int e = kSubBits;
+    while (ns >> (e + 1))
+        ++e;
+    int sub = static_cast<int>((ns >> (e - kSubBits)) & (kSub - 1));
+    return (e - kSubBits + 1) * kSub + sub;
+}
+
+double LatencyHistogram::midpoint(int bucket) {
+    if (bucket < kSub)
+        return bucket;
+    int e = bucket / kSub + kSubBits - 1;
+    int sub = bucket % kSub;
+    double width = std::ldexp(1.0, e - kSubBits);
+    return (kSub + sub) * width + 0.5 * width;
+}
+
+void LatencyHistogram::record(std::uint64_t ns) {
+    ++buckets_[bucket(ns)];
+    ++count_;
+    max_ = std::max(max_, ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (std::size_t i = 0; i < buckets_.size(); ++i)
+        buckets_[i] += other.buckets_[i];
+    count_ += other.count_;
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(buckets_.begin(), buckets_.end(), 0);
+    count_ = max_ = 0;
+}
+
+std::uint64_t LatencyHistogram::count() const {
+    return count_;
+}
+
+std::uint64_t LatencyHistogram::max() const {
+    return max_;
+}
+
+double LatencyHistogram::percentile(double q) const {
+    if (count_ == 0)
+        return 0.0;
+    q = std::min(std::max(q, 0.0), 1.0);
+    std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * count_)));
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b < buckets_.size(); ++b) {
+        seen += buckets_[b];
+        if (seen >= rank)
+            return std::min(midpoint(static_cast<int>(b)), static_cast<double>(max_));
+    }
+    return static_cast<double>(max_);
+}
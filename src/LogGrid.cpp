@@ -0,0 +1,38 @@
+#include "Grid.hpp"
+#include <cmath>
+#include <stdexcept>
+
+LogGrid::LogGrid(double K, double L, int M, double alpha) {
+    assign(K, L, M, alpha);
+}
+
+// The halves [-L, 0] and [0, L] get M / 2 and M - M / 2 intervals, each
+// uniform in xi = asinh(y / alpha), so y = 0 is a node and, for odd M,
+// the spacing changes by a factor 1 + O(1/M) across it.
+void LogGrid::assign(double K, double L, int M, double alpha) {
+    if (M < 2 || !(K > 0.0) || !(L > 0.0) || !(alpha >= 0.0))
+        throw std::invalid_argument("LogGrid: need M >= 2, K > 0, L > 0, alpha >= 0");
+    y_.resize(M + 1);
+    if (alpha == 0.0) {
+        for (int i = 0; i <= M; ++i)
+            y_[i] = L * (2 * i - M) / M;
+    } else {
+        int left = M / 2;
+        double A = std::asinh(L / alpha);
+        for (int i = 0; i < left; ++i)
+            y_[i] = -alpha * std::sinh(A * (left - i) / left);
+        y_[left] = 0.0;
+        for (int i = left + 1; i <= M; ++i)
+            y_[i] = alpha * std::sinh(A * (i - left) / (M - left));
+        y_[0] = -L;
+        y_[M] = L;
+    }
+
+    nodes_.resize(M + 1);
+    for (int i = 0; i <= M; ++i)
+        nodes_[i] = K * std::exp(y_[i]);
+}
+
+const std::vector<double>& LogGrid::logNodes() const {
+    return y_;
+}
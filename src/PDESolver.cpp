@@ -2,11 +2,115 @@
 #include <cmath>
 #include <algorithm>
 #include <stdexcept>
+#include <type_traits>
 
 PDESolver::PDESolver(int n_space, int n_time, bool use_adaptive)
-    : M_(n_space), N_(n_time), adaptive_(use_adaptive) {
+    : PDESolver(n_space, n_time, use_adaptive ? GridType::Adaptive : GridType::Uniform) {}
+
+PDESolver::PDESolver(int n_space, int n_time, GridType grid)
+    : M_(n_space), N_(n_time), grid_type_(grid) {
     if (M_ < 10 || N_ < 1)
         throw std::invalid_argument("PDESolver: need n_space >= 10, n_time >= 1");
+    if (grid == GridType::SinhRefined && M_ < 20)
+        throw std::invalid_argument("PDESolver: SinhRefined needs n_space >= 20");
+}
+
+GridType PDESolver::gridType() const {
+    return grid_type_;
+}
+
+void PDESolver::setAmericanMethod(AmericanMethod method) {
+    american_ = method;
+}
+
+AmericanMethod PDESolver::americanMethod() const {
+    return american_;
+}
+
+void PDESolver::setRannacherSteps(int steps) {
+    if (steps < 0)
+        throw std::invalid_argument("PDESolver: Rannacher steps must be >= 0");
+    rannacher_ = steps;
+}
+
+int PDESolver::rannacherSteps() const {
+    return rannacher_;
+}
+
+void PDESolver::setDomainMultiple(double multiple) {
+    if (!(multiple > 1.0))
+        throw std::invalid_argument("PDESolver: domain multiple must be > 1");
+    domain_ = multiple;
+}
+
+double PDESolver::domainMultiple() const {
+    return domain_;
+}
+
+void PDESolver::setTimeTolerance(double tol) {
+    if (!(tol >= 0.0))
+        throw std::invalid_argument("PDESolver: time tolerance must be >= 0");
+    time_tol_ = tol;
+}
+
+double PDESolver::timeTolerance() const {
+    return time_tol_;
+}
+
+SolveStats PDESolver::lastSolveStats() const {
+    return stats_;
+}
+
+void PDESolver::setSetupCache(std::shared_ptr<SetupCache> cache) {
+    cache_ = std::move(cache);
+    cached_.reset();
+}
+
+std::shared_ptr<SetupCache> PDESolver::setupCache() const {
+    return cache_;
+}
+
+void PDESolver::setProfiler(std::shared_ptr<Profiler> profiler) {
+    profiler_ = std::move(profiler);
+    trace_.reserve(8);
+}
+
+std::shared_ptr<Profiler> PDESolver::profiler() const {
+    return profiler_;
+}
+
+SolveProfile PDESolver::lastProfile() const {
+    return profile_;
+}
+
+void PDESolver::setWorkspace(std::shared_ptr<SolverWorkspace> workspace) {
+    ws_ = std::move(workspace);
+}
+
+std::shared_ptr<SolverWorkspace> PDESolver::workspace() const {
+    return ws_.get();
+}
+
+void PDESolver::setSolvePool(std::shared_ptr<WorkStealingPool> pool) {
+    pool_ = std::move(pool);
+    cached_.reset();
+}
+
+std::shared_ptr<WorkStealingPool> PDESolver::solvePool() const {
+    return pool_;
+}
+
+void PDESolver::setPrecision(Precision precision) {
+    if (precision == Precision::Single && (M_ > kMaxSingleSpace || N_ > kMaxSingleTime))
+        throw std::invalid_argument("PDESolver: Precision::Single needs n_space <= " +
+                                    std::to_string(kMaxSingleSpace) + " and n_time <= " +
+                                    std::to_string(kMaxSingleTime) + "; use Mixed");
+    precision_ = precision;
+    cached_.reset();
+}
+
+Precision PDESolver::precision() const {
+    return precision_;
 }
 
 int PDESolver::gridSize() const {
@@ -17,56 +121,169 @@ int PDESolver::gridSize() const {
 // Grid construction
 // ----------------------------------------------------------------
 
+// The solution varies on the scale of the diffusion length K sigma
+// sqrt(T): a short-dated option keeps a sharp kink, a long-dated one
+// spreads out and needs a wider domain.
+//
+// Log grids span [K / m, m K] for the domain multiple m, widened so that
+// the spot lies at least three diffusion lengths (sigma sqrt(T) in ln S)
+// from either end, where the Dirichlet values hold.
+GridShape PDESolver::gridShape(const Option& opt) const {
+    return ::gridShape(grid_type_, domain_, opt.K, opt.S, opt.sigma, opt.T);
+}
+
+// A grid of its own, e.g. for the setup cache.
+std::shared_ptr<const Grid> PDESolver::makeGrid(const Option& opt) const {
+    GridShape shape = gridShape(opt);
+    switch (grid_type_) {
+    case GridType::Uniform:
+        return std::make_shared<UniformGrid>(shape.S_max, M_);
+    case GridType::Adaptive:
+        return std::make_shared<AdaptiveGrid>(shape.S_max, M_, opt.K);
+    case GridType::Sinh:
+    case GridType::SinhRefined:
+        return std::make_shared<SinhGrid>(shape.S_max, M_, std::vector<double>{opt.K, opt.S},
+                                          shape.alpha);
+    case GridType::LogUniform:
+    case GridType::LogSinh:
+        return std::make_shared<LogGrid>(opt.K, shape.log_width, M_, shape.alpha);
+    }
+    return nullptr;
+}
+
+// The same grid, rebuilt in place in storage: only the first grid of each
+// family allocates.
+const Grid& PDESolver::assignGrid(GridStorage& storage, const Option& opt) const {
+    GridShape shape = gridShape(opt);
+    switch (grid_type_) {
+    case GridType::Uniform:
+        if (!storage.uniform)
+            storage.uniform = std::make_unique<UniformGrid>(shape.S_max, M_);
+        else
+            storage.uniform->assign(shape.S_max, M_);
+        return *storage.uniform;
+    case GridType::Adaptive:
+        if (!storage.adaptive)
+            storage.adaptive = std::make_unique<AdaptiveGrid>(shape.S_max, M_, opt.K);
+        else
+            storage.adaptive->assign(shape.S_max, M_, opt.K);
+        return *storage.adaptive;
+    case GridType::Sinh:
+    case GridType::SinhRefined:
+        if (!storage.sinh)
+            storage.sinh = std::make_unique<SinhGrid>(
+                shape.S_max, M_, std::vector<double>{opt.K, opt.S}, shape.alpha);
+        else
+            storage.sinh->assign(shape.S_max, M_, {opt.K, opt.S}, shape.alpha);
+        return *storage.sinh;
+    case GridType::LogUniform:
+    case GridType::LogSinh:
+        if (!storage.log)
+            storage.log = std::make_unique<LogGrid>(opt.K, shape.log_width, M_, shape.alpha);
+        else
+            storage.log->assign(opt.K, shape.log_width, M_, shape.alpha);
+        return *storage.log;
+    }
+    throw std::invalid_argument("PDESolver: unknown grid type");
+}
+
 void PDESolver::buildGrid(const Option& opt) {
-    double S_max = 3.0 * opt.K;
-    if (adaptive_)
-        grid_ = std::make_unique<AdaptiveGrid>(S_max, M_, opt.K);
-    else
-        grid_ = std::make_unique<UniformGrid>(S_max, M_);
+    if (grid_type_ == GridType::SinhRefined) {
+        grid_ = refineGrid(opt);
+        return;
+    }
+    // Shares ownership of the workspace, which needs no allocation.
+    grid_ = std::shared_ptr<const Grid>(ws_.get(), &assignGrid(ws_->grid, opt));
 }
 
 // ----------------------------------------------------------------
-// Spatial operator coefficients for the Black-Scholes PDE
-//
-//   dV/dt + 0.5*sig^2*S^2 * d2V/dS2 + r*S * dV/dS - r*V = 0
+// A-posteriori refinement. A Sinh solve at half the resolution gives
+// V(S, 0); the local truncation error of the three-point stencils is
 //
-// On a non-uniform grid with h+ = S_{i+1}-S_i, h- = S_i-S_{i-1}:
+//   tau(S) ~ h^2 * (sigma^2 S^2 / 24 * |V_SSSS| + r S / 6 * |V_SSS|),
 //
-//   d2V/dS2 ≈ 2/(h+*h-*(h++h-)) * [h-*V_{i+1} - (h++h-)*V_i + h+*V_{i-1}]
-//   dV/dS   ≈ 1/(h+*h-*(h++h-)) * [h-^2*V_{i+1} + (h+^2-h-^2)*V_i - h+^2*V_{i-1}]
+// with V_SSS and V_SSSS estimated by differencing the stencil gamma.
+// Equidistributing tau means h^2 * D(S) = const, i.e. node density
+// proportional to sqrt(D). A floor of 1% of the peak density keeps the
+// far field resolved, and light smoothing keeps the spacing regular.
 // ----------------------------------------------------------------
 
-std::vector<PDESolver::Coefficients>
-PDESolver::computeCoefficients(const Option& opt) const {
-    int n = grid_->size();
-    std::vector<Coefficients> coeff(n, {0.0, 0.0, 0.0});
-    double sig2 = opt.sigma * opt.sigma;
+std::shared_ptr<const Grid> PDESolver::refineGrid(const Option& opt) const {
+    PDESolver coarse(M_ / 2, std::max(1, N_ / 2), GridType::Sinh);
+    coarse.setRannacherSteps(rannacher_);
+    coarse.setTimeTolerance(2.0 * time_tol_);
+    coarse.setAmericanMethod(american_);
+    coarse.setDomainMultiple(domain_);
+    PriceSurface surface = coarse.priceSurface(opt);
+    const std::vector<double>& x = surface.nodes();
+    const std::vector<double>& V = surface.values();
+    int n = static_cast<int>(x.size());
 
+    std::vector<double> d2(n, 0.0), d3(n, 0.0), D(n, 0.0);
     for (int i = 1; i < n - 1; ++i) {
-        double Si = grid_->spot(i);
-        double hp = grid_->spacing(i);      // S_{i+1} - S_i
-        double hm = grid_->spacing(i - 1);  // S_i - S_{i-1}
-        double hsum = hp + hm;
-        double denom = hp * hm * hsum;
+        double hp = x[i + 1] - x[i], hm = x[i] - x[i - 1];
+        d2[i] = 2.0 * (hm * V[i + 1] - (hp + hm) * V[i] + hp * V[i - 1]) /
+                (hp * hm * (hp + hm));
+    }
+    for (int i = 1; i < n - 2; ++i)                     // at x_{i+1/2}
+        d3[i] = (d2[i + 1] - d2[i]) / (x[i + 1] - x[i]);
+    double sig2 = opt.sigma * opt.sigma;
+    for (int i = 2; i < n - 2; ++i) {
+        double d4 = 2.0 * (d3[i] - d3[i - 1]) / (x[i + 1] - x[i - 1]);
+        double d3_node = 0.5 * (d3[i] + d3[i - 1]);
+        D[i] = sig2 * x[i] * x[i] / 24.0 * std::abs(d4) + opt.r * x[i] / 6.0 * std::abs(d3_node);
+    }
 
-        // Second derivative stencil weights
-        double d2_lo =  2.0 * hp / denom;
-        double d2_mid = -2.0 * hsum / denom;
-        double d2_hi =  2.0 * hm / denom;
+    std::vector<double> density(n);
+    double peak = 0.0;
+    for (int i = 0; i < n; ++i) {
+        density[i] = std::sqrt(D[i]);
+        peak = std::max(peak, density[i]);
+    }
+    std::vector<double> smoothed(n);
+    for (int pass = 0; pass < 2; ++pass) {
+        smoothed[0] = density[0];
+        smoothed[n - 1] = density[n - 1];
+        for (int i = 1; i < n - 1; ++i)
+            smoothed[i] = 0.25 * density[i - 1] + 0.5 * density[i] + 0.25 * density[i + 1];
+        density.swap(smoothed);
+    }
+    double floor = peak > 0.0 ? 0.01 * peak : 1.0;
+    for (double& d : density)
+        d += floor;
 
-        // First derivative stencil weights
-        double d1_lo = -(hp * hp) / denom;
-        double d1_mid = (hp * hp - hm * hm) / denom;
-        double d1_hi =  (hm * hm) / denom;
+    return std::make_shared<DensityGrid>(x, density, M_, std::vector<double>{opt.K, opt.S});
+}
 
-        double half_sig2_S2 = 0.5 * sig2 * Si * Si;
-        double rS = opt.r * Si;
+// ----------------------------------------------------------------
+// Spatial operator of the Black-Scholes PDE
+//
+//   dV/dt + 0.5*sig^2*S^2 * d2V/dS2 + r*S * dV/dS - r*V = 0
+//
+// on the grid nodes; the stencils are in kernels::fillOperator. Log
+// grids solve the same PDE in y = ln(S / K) (kernels::fillLogOperator).
+// ----------------------------------------------------------------
 
-        coeff[i].a = half_sig2_S2 * d2_lo  + rS * d1_lo;
-        coeff[i].b = half_sig2_S2 * d2_mid + rS * d1_mid - opt.r;
-        coeff[i].c = half_sig2_S2 * d2_hi  + rS * d1_hi;
-    }
-    return coeff;
+template <class Spacing>
+void PDESolver::fillOperator(const Grid& grid, const Option& opt,
+                             TridiagonalOperator& op) const {
+    int n = grid.size();
+    op.resize(n);
+    if (logSpace())
+        kernels::fillLogOperator<Spacing>(static_cast<const LogGrid&>(grid).logNodes().data(),
+                                          n, opt.sigma, opt.r,
+                                          op.a.data(), op.b.data(), op.c.data());
+    else
+        kernels::fillOperator<Spacing>(grid.nodes().data(), n, opt.sigma, opt.r,
+                                       op.a.data(), op.b.data(), op.c.data());
+}
+
+void PDESolver::computeOperator(const Grid& grid, const Option& opt,
+                                TridiagonalOperator& op) const {
+    if (uniformSpacing())
+        fillOperator<kernels::UniformSpacing>(grid, opt, op);
+    else
+        fillOperator<kernels::GeneralSpacing>(grid, opt, op);
 }
 
 // ----------------------------------------------------------------
@@ -76,49 +293,244 @@ PDESolver::computeCoefficients(const Option& opt) const {
 //
 //   LHS:  -0.5*dt*a_i * V_{i-1} + (1 - 0.5*dt*b_i) * V_i - 0.5*dt*c_i * V_{i+1}
 //   RHS:   0.5*dt*a_i * V_{i-1} + (1 + 0.5*dt*b_i) * V_i + 0.5*dt*c_i * V_{i+1}
+//
+// Both sides depend only on the coefficients and dt, so
+// SolverSetup::factor() builds them once per price; timeStep() then
+// applies the RHS and runs the two substitution sweeps of the
+// pre-factored LHS.
 // ----------------------------------------------------------------
 
-void PDESolver::crankNicolsonStep(std::vector<double>& V,
-                                  const std::vector<Coefficients>& coeff,
-                                  double dt) const {
+void PDESolver::buildRhs(const std::vector<double>& V) {
     int n = grid_->size();
-    std::vector<double> lower(n, 0.0), diag(n, 0.0), upper(n, 0.0), rhs(n, 0.0);
+    const TridiagonalOperator& w = setup().weights;
+    const double* ea = w.a.data();
+    const double* eb = w.b.data();
+    const double* ec = w.c.data();
+    const double* v = V.data();
+    double* rhs = ws_->rhs.data();
 
-    // Boundary: i = 0
-    diag[0] = 1.0;
-    rhs[0] = V[0];
+    rhs[0] = v[0];
+    for (int i = 1; i < n - 1; ++i)
+        rhs[i] = ea[i] * v[i - 1] + eb[i] * v[i] + ec[i] * v[i + 1];
+    rhs[n - 1] = v[n - 1];
+}
 
-    // Interior nodes
-    for (int i = 1; i < n - 1; ++i) {
-        double ha = 0.5 * dt * coeff[i].a;
-        double hb = 0.5 * dt * coeff[i].b;
-        double hc = 0.5 * dt * coeff[i].c;
+// LHS x = rhs and, in place, LHS V = RHS V: the partitioned solve where
+// the setup was factored for it, else Thomas.
+void PDESolver::implicitSolve(const std::vector<double>& rhs, std::vector<double>& x) {
+    const SolverSetup& s = setup();
+    if (s.partitioned.size() > 0)
+        s.partitioned.solve(rhs, x, ws_->partition_work, pool_.get());
+    else
+        s.implicit.solve(rhs, x);
+}
+
+void PDESolver::implicitStep(std::vector<double>& V) {
+    const SolverSetup& s = setup();
+    const TridiagonalOperator& w = s.weights;
+    if (s.partitioned.size() > 0)
+        s.partitioned.solveProduct(w.a.data(), w.b.data(), w.c.data(), V, V,
+                                   ws_->partition_work, pool_.get());
+    else
+        s.implicit.solveProduct(w.a.data(), w.b.data(), w.c.data(), V, V);
+}
+
+// Mixed precision: LHS x = rhs with float sweeps, then one step of
+// iterative refinement. The residual rhs - LHS x is formed in double from
+// the unrounded LHS, so the correction, itself a float solve, leaves an
+// error of the order of (float rounding)^2 times the conditioning. x must
+// not alias rhs.
+void PDESolver::refinedSolve(const std::vector<double>& rhs, std::vector<double>& x) {
+    const SolverSetup& s = setup();
+    int n = grid_->size();
+    std::vector<float>& f = ws_->V_single;
+    f.assign(rhs.begin(), rhs.end());
+    s.implicit_single.solve(f, f);
+    x.assign(f.begin(), f.end());
+
+    const double* lo = s.lower.data();
+    const double* di = s.diag.data();
+    const double* up = s.upper.data();
+    const double* r = rhs.data();
+    const double* v = x.data();
+    float* res = f.data();
+    res[0] = static_cast<float>(r[0] - di[0] * v[0] - up[0] * v[1]);
+    for (int i = 1; i < n - 1; ++i)
+        res[i] = static_cast<float>(r[i] - lo[i] * v[i - 1] - di[i] * v[i] - up[i] * v[i + 1]);
+    res[n - 1] = static_cast<float>(r[n - 1] - lo[n - 1] * v[n - 2] - di[n - 1] * v[n - 1]);
+    s.implicit_single.solve(f, f);
+    for (int i = 0; i < n; ++i)
+        x[i] += f[i];
+}
+
+// ----------------------------------------------------------------
+// American time step: Crank-Nicolson subject to V >= payoff, i.e. the
+// linear complementarity problem
+//
+//   LHS V >= RHS V^{n+1},  V >= payoff,  one of the two with equality.
+//
+// On entry V holds the previous time level with this step's boundary
+// values; on exit it holds the new level.
+//
+// European steps and projected American steps form the RHS inside the
+// elimination sweep (TridiagonalLU::solveProduct); the other LCP methods
+// need it as a vector.
+// ----------------------------------------------------------------
+
+template <class Exercise>
+void PDESolver::timeStep(std::vector<double>& V) {
+    if constexpr (!Exercise::early) {
+        instrument::ScopedPhase timer(profile_, Phase::Solve);
+        if (loop_ == Precision::Mixed) {
+            buildRhs(V);
+            refinedSolve(ws_->rhs, V);
+        } else {
+            implicitStep(V);
+        }
+    } else if (american_ == AmericanMethod::Projection) {
+        {
+            instrument::ScopedPhase timer(profile_, Phase::Solve);
+            implicitStep(V);
+        }
+        instrument::ScopedPhase timer(profile_, Phase::Exercise);
+        kernels::project(V.data(), ws_->payoff.data(), grid_->size());
+    } else {
+        buildRhs(V);
+        solveConstrained(V);
+    }
+}
 
-        // LHS (tridiagonal matrix)
-        lower[i] = -ha;
-        diag[i]  = 1.0 - hb;
-        upper[i] = -hc;
+// Solves LHS V = rhs subject to V >= payoff with the selected method.
+// V enters holding the previous time level.
+void PDESolver::solveConstrained(std::vector<double>& V) {
+    instrument::ScopedPhase timer(profile_, Phase::Exercise);
+    switch (american_) {
+    case AmericanMethod::Projection:
+        implicitSolve(ws_->rhs, V);
+        applyEarlyExercise(V);
+        break;
+    case AmericanMethod::BrennanSchwartz:
+        // solve() factored the LHS in the direction that substitutes from
+        // the exercise region (low S for puts, high S for calls).
+        setup().implicit.solveProjected(ws_->rhs, ws_->payoff, V);
+        break;
+    case AmericanMethod::Penalty:
+        penaltySolve(V);
+        break;
+    case AmericanMethod::PSOR:
+        implicitSolve(ws_->rhs, V);
+        applyEarlyExercise(V);
+        psorSolve(V);
+        break;
+    }
+}
 
-        // RHS (explicit side)
-        rhs[i] = ha * V[i - 1] + (1.0 + hb) * V[i] + hc * V[i + 1];
+// Rannacher start-up half-step: implicit Euler over dt/2,
+//
+//   (I - dt/2 * L) V^{new} = V^{old}.
+//
+// The matrix is the Crank-Nicolson LHS for the full step dt, so the
+// factorization from SolverSetup::factor() is reused as is.
+template <class Exercise>
+void PDESolver::implicitHalfStep(std::vector<double>& V) {
+    if constexpr (Exercise::early) {
+        ws_->rhs.assign(V.begin(), V.end());
+        solveConstrained(V);
+    } else if (loop_ == Precision::Mixed) {
+        instrument::ScopedPhase timer(profile_, Phase::Solve);
+        ws_->rhs.assign(V.begin(), V.end());
+        refinedSolve(ws_->rhs, V);
+    } else {
+        instrument::ScopedPhase timer(profile_, Phase::Solve);
+        implicitSolve(V, V);
     }
+}
 
-    // Boundary: i = n-1
-    diag[n - 1] = 1.0;
-    rhs[n - 1] = V[n - 1];
+void PDESolver::factorOwn(double dt) {
+    instrument::ScopedPhase timer(profile_, Phase::Factor);
+    ws_->setup.factor(dt, order_, partition(), loop_);
+}
 
-    solveTridiagonal(lower, diag, upper, rhs, V);
+// Instrumentation: nodes held at the payoff after an accepted step. The
+// penalty method leaves them within O(1/rho) below it.
+template <class Exercise>
+void PDESolver::countExercised() {
+    if constexpr (instrument::enabled && Exercise::early) {
+        int n = grid_->size();
+        std::uint64_t held = 0;
+        for (int i = 0; i < n; ++i)
+            held += ws_->payoff[i] > 0.0 &&
+                    ws_->V[i] <= ws_->payoff[i] * (1.0 + 1e-12) + 1e-12;
+        profile_.exercised_nodes += held;
+    }
 }
 
-// ----------------------------------------------------------------
 // American early exercise: V_i = max(V_i, payoff(S_i))
-// ----------------------------------------------------------------
+void PDESolver::applyEarlyExercise(std::vector<double>& V) const {
+    kernels::project(V.data(), ws_->payoff.data(), grid_->size());
+}
 
-void PDESolver::applyEarlyExercise(std::vector<double>& V,
-                                   const Option& opt) const {
+// Policy iteration for the penalized system
+//
+//   (LHS + P^k) V^{k+1} = rhs + P^k payoff,  P^k_ii = rho if V^k_i < payoff_i
+//
+// starting from the previous time level. It stops once the penalized set
+// no longer changes, which is when V^{k+1} solves the penalized problem
+// exactly; the constraint then holds to O(1/rho).
+void PDESolver::penaltySolve(std::vector<double>& V) {
+    const double rho = 1e8;
+    const int max_iter = 50;
     int n = grid_->size();
-    for (int i = 0; i < n; ++i)
-        V[i] = std::max(V[i], opt.payoff(grid_->spot(i)));
+
+    SolverWorkspace& w = *ws_;
+    w.iterate = V;
+    for (int k = 0; k < max_iter; ++k) {
+        w.penalty_diag = setup().diag;
+        w.penalty_rhs = w.rhs;
+        for (int i = 0; i < n; ++i) {
+            if (w.iterate[i] < w.payoff[i]) {
+                w.penalty_diag[i] += rho;
+                w.penalty_rhs[i] += rho * w.payoff[i];
+            }
+        }
+        w.penalty_lu.factor(setup().lower, w.penalty_diag, setup().upper);
+        w.penalty_lu.solve(w.penalty_rhs, V);
+
+        bool same_set = true;
+        for (int i = 0; i < n && same_set; ++i)
+            same_set = (V[i] < w.payoff[i]) == (w.iterate[i] < w.payoff[i]);
+        if (same_set) return;
+        w.iterate = V;
+    }
+}
+
+// Projected SOR on LHS V = rhs, V >= payoff. V enters holding the
+// projected Crank-Nicolson solution, which differs from the answer only
+// near the exercise boundary, so few sweeps are needed per step.
+void PDESolver::psorSolve(std::vector<double>& V) {
+    const double omega = 1.3;
+    const double tol = 1e-10;
+    const int max_iter = 1000;
+    int n = grid_->size();
+    const double* lower = setup().lower.data();
+    const double* diag = setup().diag.data();
+    const double* upper = setup().upper.data();
+    const double* rhs = ws_->rhs.data();
+    const double* payoff = ws_->payoff.data();
+
+    for (int k = 0; k < max_iter; ++k) {
+        double change = 0.0;
+        for (int i = 0; i < n; ++i) {
+            double r = rhs[i];
+            if (i > 0)     r -= lower[i] * V[i - 1];
+            if (i < n - 1) r -= upper[i] * V[i + 1];
+            double gs = r / diag[i];
+            double v = std::max(payoff[i], V[i] + omega * (gs - V[i]));
+            change = std::max(change, std::abs(v - V[i]) / std::max(1.0, std::abs(v)));
+            V[i] = v;
+        }
+        if (change <= tol) return;
+    }
 }
 
 // ----------------------------------------------------------------
@@ -134,88 +546,803 @@ double PDESolver::interpolate(const std::vector<double>& V, double S) const {
 }
 
 // ----------------------------------------------------------------
-// Public pricing functions
+// Backward sweep from expiry to t = 0. Leaves V(S, 0) in ws_->V. With
+// keep_history (always, for adaptive steps), V_prev and V_prev2 hold
+// the two previous levels,
+// hist_dt_[0] and hist_dt_[1] time steps before t = 0, for the theta
+// estimate in priceWithGreeks().
 // ----------------------------------------------------------------
 
-double PDESolver::priceEuropean(const Option& option) {
-    buildGrid(option);
+template <class Payoff>
+void PDESolver::setBoundaries(std::vector<double>& V, const Option& option,
+                              double tau) const {
     int n = grid_->size();
-    double dt = option.T / N_;
+    kernels::setBoundaries<Payoff>(V.data(), n, grid_->nodes()[0], grid_->nodes()[n - 1],
+                                   option.K * std::exp(-option.r * tau));
+}
 
-    auto coeff = computeCoefficients(option);
+void PDESolver::solve(const Option& option, bool american, bool keep_history) {
+    if (vol_sigma_ == 0.0)
+        ws_->vol_owner = nullptr;
+    auto dispatch = [&] {
+        if (option.type == OptionType::Call)
+            solveFor<kernels::CallPayoff>(option, american, keep_history);
+        else
+            solveFor<kernels::PutPayoff>(option, american, keep_history);
+    };
+    if constexpr (!instrument::enabled) {
+        dispatch();
+    } else {
+        profile_ = SolveProfile();
+        trace_.clear();
+        std::uint64_t start = instrument::nowNs();
+        std::uint64_t allocations = instrument::threadAllocations();
+        dispatch();
+        profile_.prices = 1;
+        profile_.time_steps = static_cast<std::uint64_t>(stats_.steps);
+        profile_.nodes = profile_.time_steps * static_cast<std::uint64_t>(grid_->size());
+        profile_.allocations = instrument::threadAllocations() - allocations;
+        if (profiler_) {
+            for (TraceEvent& e : trace_)
+                if (e.name == phaseName(Phase::TimeLoop))
+                    e.steps = profile_.time_steps;
+            trace_.push_back({"price", start, instrument::nowNs() - start,
+                              std::this_thread::get_id(), 0, 0, 0});
+            profiler_->record(profile_, trace_);
+        }
+    }
+}
+
+template <class Payoff>
+void PDESolver::solveFor(const Option& option, bool american, bool keep_history) {
+    using namespace kernels;
+    bool uniform = uniformSpacing();
+    if (american) {
+        if (uniform)
+            solveWith<Payoff, AmericanExercise, UniformSpacing>(option, keep_history);
+        else
+            solveWith<Payoff, AmericanExercise, GeneralSpacing>(option, keep_history);
+    } else {
+        if (uniform)
+            solveWith<Payoff, EuropeanExercise, UniformSpacing>(option, keep_history);
+        else
+            solveWith<Payoff, EuropeanExercise, GeneralSpacing>(option, keep_history);
+    }
+}
+
+// Grid, operator and, for fixed steps, the factored Crank-Nicolson LHS:
+// from the cache when one is attached, otherwise rebuilt in the workspace.
+// Returns whether the LHS was factored here, i.e. not taken from the
+// cache.
+template <class Spacing>
+bool PDESolver::prepareStep(const Option& option) {
+    bool fixed = time_tol_ == 0.0;
+
+    // priceAtVolatility(): the first price of a contract builds the grid
+    // and the two operator parts, later ones only combine them.
+    if (vol_sigma_ > 0.0) {
+        cached_.reset();
+        if (ws_->vol_owner != this) {
+            {
+                instrument::ScopedPhase timer(profile_, Phase::Grid, trace());
+                buildGrid(option);
+            }
+            instrument::ScopedPhase timer(profile_, Phase::Assembly, trace());
+            Option at = option;
+            at.sigma = 0.0;
+            fillOperator<Spacing>(*grid_, at, ws_->vol_base);
+            at.sigma = 1.0;
+            fillOperator<Spacing>(*grid_, at, ws_->vol_slope);
+            TridiagonalOperator& base = ws_->vol_base;
+            TridiagonalOperator& slope = ws_->vol_slope;
+            for (int i = 0; i < grid_->size(); ++i) {
+                slope.a[i] -= base.a[i];
+                slope.b[i] -= base.b[i];
+                slope.c[i] -= base.c[i];
+            }
+            ws_->vol_owner = this;
+        }
+        {
+            instrument::ScopedPhase timer(profile_, Phase::Assembly, trace());
+            const TridiagonalOperator& base = ws_->vol_base;
+            const TridiagonalOperator& slope = ws_->vol_slope;
+            TridiagonalOperator& op = ws_->setup.coeff;
+            int n = grid_->size();
+            op.resize(n);
+            double sig2 = vol_sigma_ * vol_sigma_;
+            for (int i = 0; i < n; ++i) {
+                op.a[i] = base.a[i] + sig2 * slope.a[i];
+                op.b[i] = base.b[i] + sig2 * slope.b[i];
+                op.c[i] = base.c[i] + sig2 * slope.c[i];
+            }
+        }
+        if (fixed) {
+            instrument::ScopedPhase timer(profile_, Phase::Factor, trace());
+            ws_->setup.factor(option.T / N_, order_, partition(), loop_);
+        }
+        return fixed;
+    }
+
+    // Strips step with several dt, which the cache key does not cover.
+    if (cache_ && fixed && stops_.empty() && grid_type_ != GridType::SinhRefined) {
+        bool sinh = grid_type_ == GridType::Sinh;
+        bool log = logSpace();
+        double dt = option.T / N_;
+        // A log grid's operator is the same for every strike, so its key
+        // leaves K out; the grid itself is rebuilt per price in the
+        // workspace, which allocates nothing.
+        SetupKey key = log ? SetupKey{grid_type_, M_, 0.0, std::exp(gridShape(option).log_width),
+                                      option.sigma, option.r, dt, order_, 0.0,
+                                      grid_type_ == GridType::LogSinh ? option.T : 0.0,
+                                      partition(), loop_}
+                           : SetupKey{grid_type_, M_, option.K, domain_ * option.K, option.sigma,
+                                      option.r, dt, order_, sinh ? option.S : 0.0,
+                                      sinh ? option.T : 0.0, partition(), loop_};
+        std::shared_ptr<SolverSetup> setup;
+        bool factored = false;
+        {
+            instrument::ScopedPhase timer(profile_, Phase::Grid, trace());
+            cached_ = cache_->find(key);
+            if (log)
+                buildGrid(option);
+            if (!cached_) {
+                setup = std::make_shared<SolverSetup>();
+                if (!log)
+                    setup->grid = makeGrid(option);
+            }
+        }
+        if (setup) {
+            {
+                instrument::ScopedPhase timer(profile_, Phase::Assembly, trace());
+                fillOperator<Spacing>(log ? *grid_ : *setup->grid, option, setup->coeff);
+            }
+            {
+                instrument::ScopedPhase timer(profile_, Phase::Factor, trace());
+                setup->factor(dt, order_, partition(), loop_);
+                factored = true;
+            }
+            cache_->insert(key, setup);
+            cached_ = std::move(setup);
+        }
+        if (!log)
+            grid_ = cached_->grid;
+        return factored;
+    }
+
+    cached_.reset();
+    {
+        instrument::ScopedPhase timer(profile_, Phase::Grid, trace());
+        buildGrid(option);
+    }
+    {
+        instrument::ScopedPhase timer(profile_, Phase::Assembly, trace());
+        fillOperator<Spacing>(*grid_, option, ws_->setup.coeff);
+    }
+    if (fixed) {
+        instrument::ScopedPhase timer(profile_, Phase::Factor, trace());
+        ws_->setup.factor(option.T / N_, order_, partition(), loop_);
+    }
+    return fixed;
+}
+
+template <class Payoff, class Exercise, class Spacing>
+void PDESolver::solveWith(const Option& option, bool keep_history) {
+    // Brennan-Schwartz must substitute starting from the exercise region.
+    bool from_low_S = Exercise::early && Payoff::type == OptionType::Put &&
+                      american_ == AmericanMethod::BrennanSchwartz;
+    order_ = from_low_S ? Elimination::Backward : Elimination::Forward;
+    loop_ = !Exercise::early && time_tol_ == 0.0 && precision_ == Precision::Mixed
+                ? Precision::Mixed
+                : Precision::Double;
+    bool factored = prepareStep<Spacing>(option);
+    int n = grid_->size();
+    const double* S = grid_->nodes().data();
+    ws_->rhs.resize(n);
 
     // Terminal condition: V(S, T) = payoff(S)
-    std::vector<double> V(n);
-    for (int i = 0; i < n; ++i)
-        V[i] = option.payoff(grid_->spot(i));
+    ws_->payoff.resize(n);
+    kernels::fillPayoff<Payoff>(S, n, option.K, ws_->payoff.data());
+    ws_->V = ws_->payoff;
 
-    // Boundary conditions at S = 0 and S = S_max for each time step.
-    double S_max = grid_->spot(n - 1);
-    for (int step = N_ - 1; step >= 0; --step) {
-        double tau = (N_ - step) * dt;  // time remaining
-        if (option.type == OptionType::Call) {
-            V[0] = 0.0;
-            V[n - 1] = S_max - option.K * std::exp(-option.r * tau);
-        } else {
-            V[0] = option.K * std::exp(-option.r * tau);
-            V[n - 1] = 0.0;
+    if (time_tol_ > 0.0) {
+        marchAdaptive<Payoff, Exercise>(option);
+    } else if (loop_ == Precision::Mixed) {
+        FlushDenormals flush;
+        marchFixed<Payoff, Exercise>(option, keep_history, factored);
+    } else {
+        marchFixed<Payoff, Exercise>(option, keep_history, factored);
+    }
+}
+
+// The sweep runs in segments ending at the snapshot times (one segment,
+// ending at T, for a plain price). Each gets a whole number of steps as
+// close as possible to T / N_; the LHS is refactored when a segment's dt
+// differs from the one prepareStep() set up. `factored` is false when
+// prepareStep() took that LHS from the cache.
+template <class Payoff, class Exercise>
+void PDESolver::marchFixed(const Option& option, bool keep_history, bool factored) {
+    instrument::ScopedPhase timer(profile_, Phase::TimeLoop, trace());
+    const double nominal = option.T / N_;
+    double current = nominal;
+    stats_ = {0, 0, factored ? 1 : 0};
+
+    std::size_t segments = stops_.empty() ? 1 : stops_.size();
+    double start = 0.0;
+    for (std::size_t seg = 0; seg < segments; ++seg) {
+        double end = stops_.empty() ? option.T : stops_[seg];
+        int steps = stops_.empty() ? N_
+                  : std::max(1, static_cast<int>(std::lround((end - start) / nominal)));
+        double dt = (end - start) / steps;
+        if (dt != current) {
+            factorOwn(dt);
+            current = dt;
+            ++stats_.factorizations;
+        }
+        hist_dt_[0] = hist_dt_[1] = dt;
+
+        for (int k = 1; k <= steps; ++k) {
+            if (keep_history && seg + 1 == segments && k > steps - 2) {
+                ws_->V_prev2.swap(ws_->V_prev);
+                ws_->V_prev = ws_->V;
+            }
+            double tau = start + k * dt;
+            if (stats_.steps < rannacher_) {
+                setBoundaries<Payoff>(ws_->V, option, tau - 0.5 * dt);
+                implicitHalfStep<Exercise>(ws_->V);
+                setBoundaries<Payoff>(ws_->V, option, tau);
+                implicitHalfStep<Exercise>(ws_->V);
+            } else {
+                setBoundaries<Payoff>(ws_->V, option, tau);
+                timeStep<Exercise>(ws_->V);
+            }
+            countExercised<Exercise>();
+            ++stats_.steps;
         }
-        crankNicolsonStep(V, coeff, dt);
+        if (!stops_.empty())
+            snapshot(seg);
+        start = end;
     }
+}
 
-    return interpolate(V, option.S);
+// Stores the current level as snapshot `stop`.
+void PDESolver::snapshot(std::size_t stop) {
+    std::size_t n = ws_->V.size();
+    ws_->snapshots.resize(stops_.size() * n);
+    std::copy(ws_->V.begin(), ws_->V.end(), ws_->snapshots.begin() + stop * n);
 }
 
-double PDESolver::priceAmerican(const Option& option) {
-    buildGrid(option);
+// ----------------------------------------------------------------
+// Adaptive time stepping.
+//
+// Start-up (the first max(rannacher_, 3) steps): each step is taken both
+// as Crank-Nicolson and as two implicit-Euler half-steps, which share the
+// factored LHS I - dt/2 L. The damped implicit result is kept, so the
+// payoff kink never rings into the error estimate below, and the
+// difference of the pair estimates its O(dt^2) local error.
+//
+// Afterwards each step is plain Crank-Nicolson, with local error
+// dt^3/12 * V_ttt. V_ttt comes from the third divided difference of the
+// candidate and the last three accepted levels (Milne's device), so the
+// estimate costs no extra solves. American nodes at or next to the
+// exercise region are left out: V is only C^1 in time where the
+// constraint switches, and those spikes would stall the controller.
+//
+// The error is measured in the RMS norm over interior nodes and must stay
+// below tol * T / tau. Errors made close to expiry sit around the strike
+// and are largely damped by diffusion before t = 0, so the tolerance is
+// loosest there; far from expiry it tightens to tol. With err ~ dt^(p+1)
+// the next step is dt * 0.9 (target / err)^(1/(p+1)).
+//
+// Refactoring costs about one step, so dt changes only on a rejection,
+// when the estimate asks for a smaller step, or when it allows growth by
+// at least 1.5x (capped at 2x); otherwise the factorization is reused.
+// ----------------------------------------------------------------
+
+template <class Payoff, class Exercise>
+void PDESolver::marchAdaptive(const Option& option) {
+    instrument::ScopedPhase timer(profile_, Phase::TimeLoop, trace());
+    constexpr bool american = Exercise::early;
+    const double T = option.T;
+    const double dt_min = T * 1e-10;
+    const int startup = std::max(rannacher_, 3);
     int n = grid_->size();
-    double dt = option.T / N_;
 
-    auto coeff = computeCoefficients(option);
+    double dt = T * 1e-3;
+    factorOwn(dt);
+    stats_ = {0, 0, 1};
 
-    std::vector<double> V(n);
-    for (int i = 0; i < n; ++i)
-        V[i] = option.payoff(grid_->spot(i));
+    // Accepted levels: V_prev2, V_prev, V at tau - d1 - d0, tau - d0, tau.
+    double d0 = 0.0, d1 = 0.0;
+    double tau = 0.0;
+    std::size_t stop = 0;   // next snapshot
+    bool just_rejected = false;
+    while (tau < T) {
+        // Without this an unreachable tolerance settles at dt_min and
+        // would take T / dt_min steps.
+        if (stats_.steps + stats_.rejected >= kMaxAdaptiveSteps)
+            throw std::runtime_error("PDESolver: time tolerance not reached within "
+                                     "kMaxAdaptiveSteps steps");
+        // Land exactly on the next snapshot time or T; a truncated step
+        // refactors once.
+        double end = stops_.empty() ? T : stops_[stop];
+        double step = std::min(dt, end - tau);
+        if (step != dt) {
+            factorOwn(step);
+            ++stats_.factorizations;
+        }
 
-    double S_max = grid_->spot(n - 1);
-    for (int step = N_ - 1; step >= 0; --step) {
-        double tau = (N_ - step) * dt;
-        if (option.type == OptionType::Call) {
-            V[0] = 0.0;
-            V[n - 1] = S_max - option.K * std::exp(-option.r * tau);
+        // The explicit half sees the old boundary values and only the
+        // solve the new ones. (Setting them first, as marchFixed does, is
+        // a first-order error at the nodes next to the boundary, harmless
+        // for the price but it would dominate the estimate below.)
+        ws_->step_cn = ws_->V;
+        buildRhs(ws_->step_cn);
+        setBoundaries<Payoff>(ws_->rhs, option, tau + step);
+        if (american) {
+            solveConstrained(ws_->step_cn);
         } else {
-            V[0] = option.K * std::exp(-option.r * tau);
-            V[n - 1] = 0.0;
+            instrument::ScopedPhase timer(profile_, Phase::Solve);
+            implicitSolve(ws_->rhs, ws_->step_cn);
+        }
+
+        bool starting = stats_.steps < startup;
+        double sum = 0.0, err, order;
+        if (starting) {
+            ws_->step_ie = ws_->V;
+            setBoundaries<Payoff>(ws_->step_ie, option, tau + 0.5 * step);
+            implicitHalfStep<Exercise>(ws_->step_ie);
+            setBoundaries<Payoff>(ws_->step_ie, option, tau + step);
+            implicitHalfStep<Exercise>(ws_->step_ie);
+            for (int i = 1; i < n - 1; ++i) {
+                double e = ws_->step_cn[i] - ws_->step_ie[i];
+                sum += e * e;
+            }
+            err = std::sqrt(sum / (n - 2));
+            order = 1.0;
+        } else {
+            // Divided differences over tau - d1 - d0, tau - d0, tau, tau + step.
+            const double* v3 = ws_->step_cn.data();
+            const double* v2 = ws_->V.data();
+            const double* v1 = ws_->V_prev.data();
+            const double* v0 = ws_->V_prev2.data();
+            const double* g = ws_->payoff.data();
+            auto exercised = [&](int j) {
+                double lo = std::min(std::min(v0[j], v1[j]), std::min(v2[j], v3[j]));
+                return lo <= g[j] + 1e-12 * (1.0 + g[j]);
+            };
+            for (int i = 1; i < n - 1; ++i) {
+                if (american && (exercised(i - 1) || exercised(i) || exercised(i + 1)))
+                    continue;
+                double f01 = (v1[i] - v0[i]) / d1;
+                double f12 = (v2[i] - v1[i]) / d0;
+                double f23 = (v3[i] - v2[i]) / step;
+                double f012 = (f12 - f01) / (d1 + d0);
+                double f123 = (f23 - f12) / (d0 + step);
+                double f0123 = (f123 - f012) / (d1 + d0 + step);
+                sum += f0123 * f0123;
+            }
+            // dt^3/12 * V_ttt with V_ttt = 6 f[0123]
+            err = 0.5 * step * step * step * std::sqrt(sum / (n - 2));
+            order = 2.0;
+        }
+
+        double target = time_tol_ * T / (tau + step);
+        double ratio = err > 0.0 ? 0.9 * std::pow(target / err, 1.0 / (order + 1.0)) : 2.0;
+
+        if (err > target && step > dt_min) {
+            dt = std::max(dt_min, step * std::max(0.2, ratio));
+            factorOwn(dt);
+            ++stats_.factorizations;
+            ++stats_.rejected;
+            just_rejected = true;
+            continue;
+        }
+
+        ws_->V_prev2.swap(ws_->V_prev);
+        ws_->V_prev.swap(ws_->V);
+        ws_->V.swap(starting ? ws_->step_ie : ws_->step_cn);
+        countExercised<Exercise>();
+        d1 = d0;
+        d0 = step;
+        tau = step == end - tau ? end : tau + step;
+        ++stats_.steps;
+        if (!stops_.empty() && tau == end)
+            snapshot(stop++);
+
+        // No growth straight after a rejection: the step that failed was
+        // itself a growth step, and retrying it at once would just repeat
+        // the failure.
+        double limit = just_rejected ? 1.0 : 2.0;
+        just_rejected = false;
+        if (tau < T && ((ratio >= 1.5 && limit > 1.0) || ratio < 1.0 || step != dt)) {
+            dt = step * std::min(limit, std::max(ratio, 0.2));
+            factorOwn(dt);
+            ++stats_.factorizations;
         }
-        crankNicolsonStep(V, coeff, dt);
-        applyEarlyExercise(V, option);
     }
+    hist_dt_[0] = d0;
+    hist_dt_[1] = d1;
+}
+
+// ----------------------------------------------------------------
+// Public pricing functions
+// ----------------------------------------------------------------
+
+double PDESolver::priceEuropean(const Option& option) {
+    solve(option, false, false);
+    return interpolate(ws_->V, option.S);
+}
+
+double PDESolver::priceAmerican(const Option& option) {
+    solve(option, true, false);
+    return interpolate(ws_->V, option.S);
+}
+
+double PDESolver::price(const Option& option) {
+    return option.exercise == ExerciseType::American ? priceAmerican(option)
+                                                     : priceEuropean(option);
+}
+
+// Richardson extrapolation. Both grids put the strike on a node and
+// the fine grid roughly bisects the coarse one, so the leading error
+// terms C1*h^2 + C2*dt^2 shrink by 4 together and cancel in
+// (4 P_fine - P_coarse) / 3.
+double PDESolver::priceExtrapolated(const Option& option) {
+    double coarse = price(option);
+
+    int M = M_, N = N_;
+    M_ = 2 * M;
+    N_ = 2 * N;
+    double fine;
+    try {
+        fine = price(option);
+    } catch (...) {
+        M_ = M;
+        N_ = N;
+        throw;
+    }
+    M_ = M;
+    N_ = N;
+
+    return (4.0 * fine - coarse) / 3.0;
+}
+
+PriceSurface PDESolver::priceSurface(const Option& option) {
+    solve(option, option.exercise == ExerciseType::American, false);
+    return PriceSurface(grid_->nodes(), ws_->V);
+}
+
+double PDESolver::priceAtVolatility(const Option& option, double sigma) {
+    if (!(sigma > 0.0))
+        throw std::invalid_argument("priceAtVolatility: sigma must be positive");
+    const VolContract& c = vol_contract_;
+    bool same = c.S == option.S && c.K == option.K && c.T == option.T && c.r == option.r &&
+                c.type == option.type && c.exercise == option.exercise && c.domain == domain_;
+    if (!same)
+        ws_->vol_owner = nullptr;
+    vol_contract_ = {option.S, option.K, option.T, option.r, option.type, option.exercise,
+                     domain_};
+    vol_sigma_ = sigma;
+    try {
+        solve(option, option.exercise == ExerciseType::American, false);
+    } catch (...) {
+        vol_sigma_ = 0.0;
+        ws_->vol_owner = nullptr;
+        throw;
+    }
+    vol_sigma_ = 0.0;
+    return interpolate(ws_->V, option.S);
+}
+
+std::vector<MaturitySnapshot> PDESolver::priceMaturities(
+        const Option& option, const std::vector<double>& maturities) {
+    if (maturities.empty())
+        throw std::invalid_argument("priceMaturities: need at least one maturity");
+    for (double T : maturities)
+        if (!(T > 0.0))
+            throw std::invalid_argument("priceMaturities: maturities must be positive");
+
+    stops_ = maturities;
+    std::sort(stops_.begin(), stops_.end());
+    stops_.erase(std::unique(stops_.begin(), stops_.end()), stops_.end());
+    Option longest = option;
+    longest.T = stops_.back();
+    try {
+        solve(longest, option.exercise == ExerciseType::American, false);
+    } catch (...) {
+        stops_.clear();
+        throw;
+    }
+
+    std::vector<MaturitySnapshot> out;
+    out.reserve(maturities.size());
+    std::size_t n = static_cast<std::size_t>(grid_->size());
+    for (double T : maturities) {
+        std::size_t k = std::lower_bound(stops_.begin(), stops_.end(), T) - stops_.begin();
+        auto first = ws_->snapshots.begin() + k * n;
+        std::vector<double> values(first, first + n);
+        double price = interpolate(values, option.S);
+        out.push_back({T, price, PriceSurface(grid_->nodes(), std::move(values))});
+    }
+    stops_.clear();
+    return out;
+}
+
+// ----------------------------------------------------------------
+// Greeks from the solution of a single solve.
+//
+// delta and gamma come from the same non-uniform three-point stencils
+// as the spatial operator, evaluated at the two nodes bracketing the spot
+// and interpolated linearly. At American nodes inside the exercise
+// region (V == payoff > 0) the option is worth its intrinsic value, so
+// delta is the payoff slope and gamma is zero; this keeps the stencil
+// from smearing the jump in gamma at the free boundary into them.
+//
+// theta = dV/dt at t = 0 uses the second-order one-sided difference of
+// the levels t = 0, dt, 2*dt:  (-3 V0 + 4 V1 - V2) / (2 dt), or its
+// variable-step form when the last two steps differ. In the exercise
+// region all three levels equal the payoff, so theta is zero.
+// ----------------------------------------------------------------
+
+void PDESolver::nodeGreeks(const Option& option, bool american, int i,
+                           double& delta, double& gamma) const {
+    int n = grid_->size();
+    i = std::max(1, std::min(i, n - 2));
+    double Si = grid_->spot(i);
+
+    const std::vector<double>& V = ws_->V;
+    double intrinsic = option.payoff(Si);
+    if (american && intrinsic > 0.0 && V[i] <= intrinsic) {
+        delta = (option.type == OptionType::Call) ? 1.0 : -1.0;
+        gamma = 0.0;
+        return;
+    }
+
+    double hp = grid_->spacing(i);
+    double hm = grid_->spacing(i - 1);
+    double hsum = hp + hm;
+    double denom = hp * hm * hsum;
+
+    delta = (-(hp * hp) * V[i - 1] + (hp * hp - hm * hm) * V[i] + (hm * hm) * V[i + 1]) / denom;
+    gamma = 2.0 * (hp * V[i - 1] - hsum * V[i] + hm * V[i + 1]) / denom;
+}
+
+PricingResult PDESolver::priceWithGreeks(const Option& option) {
+    bool american = option.exercise == ExerciseType::American;
+    solve(option, american, true);
+
+    double S = option.S;
+    int i = grid_->findIndex(S);
+    double S_lo = grid_->spot(i);
+    double S_hi = grid_->spot(i + 1);
+    double w = (S - S_lo) / (S_hi - S_lo);
 
-    return interpolate(V, option.S);
+    double delta_lo, gamma_lo, delta_hi, gamma_hi;
+    nodeGreeks(option, american, i, delta_lo, gamma_lo);
+    nodeGreeks(option, american, i + 1, delta_hi, gamma_hi);
+
+    PricingResult result;
+    result.price = interpolate(ws_->V, S);
+    result.delta = (1.0 - w) * delta_lo + w * delta_hi;
+    result.gamma = (1.0 - w) * gamma_lo + w * gamma_hi;
+
+    // Levels at t = 0, a and a + b.
+    double a = hist_dt_[0], b = hist_dt_[1];
+    double V1 = interpolate(ws_->V_prev, S);
+    if (stats_.steps >= 2)
+        result.theta = -(2.0 * a + b) / (a * (a + b)) * result.price
+                       + (a + b) / (a * b) * V1
+                       - a / (b * (a + b)) * interpolate(ws_->V_prev2, S);
+    else
+        result.theta = (V1 - result.price) / a;
+    return result;
 }
 
 // ----------------------------------------------------------------
-// Thomas algorithm for tridiagonal systems.
+// Lane-batched European pricing
+//
+// Same scheme as priceEuropean(), run on LaneTridiagonalLU::lanes options
+// at once. All per-node arrays are interleaved so that every row of the
+// RHS assembly and of the substitution sweeps is one SIMD operation
+// across options. Options only need to share the node count; strikes,
+// maturities, rates and vols may all differ per lane.
 // ----------------------------------------------------------------
 
-void PDESolver::solveTridiagonal(const std::vector<double>& a,
-                                 const std::vector<double>& b,
-                                 const std::vector<double>& c,
-                                 const std::vector<double>& d,
-                                 std::vector<double>& x) {
-    int n = static_cast<int>(d.size());
-    std::vector<double> cp(n), dp(n);
+void PDESolver::priceEuropeanBatch(const Option* options, std::size_t count,
+                                   double* out) {
+    for (std::size_t i = 0; i < count; ++i)
+        if (options[i].exercise != ExerciseType::European)
+            throw std::invalid_argument("priceEuropeanBatch: options must be European");
+
+    // Refined grids depend on each option's own coarse solve, and
+    // adaptive time grids on each option's own error history.
+    if (grid_type_ == GridType::SinhRefined || time_tol_ > 0.0) {
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] = priceEuropean(options[i]);
+        return;
+    }
+
+    if (precision_ == Precision::Double) {
+        priceLaneGroups<double>(options, count, out);
+    } else {
+        FlushDenormals flush;
+        priceLaneGroups<float>(options, count, out);
+    }
+}
+
+template <class Real>
+void PDESolver::priceLaneGroups(const Option* options, std::size_t count, double* out) {
+    constexpr std::size_t W = BasicLaneTridiagonalLU<Real>::lanes;
+    for (std::size_t first = 0; first < count; first += W) {
+        int used = static_cast<int>(std::min(W, count - first));
+        priceLaneGroup<Real>(options + first, used, out + first);
+    }
+}
+
+// Mixed precision keeps the level in double (level, level_rhs) and runs
+// the refinement of refinedSolve() across the lanes. Its RHS uses
+// RHS = 2 I - LHS, so that only the double LHS is needed.
+template <class Real>
+void PDESolver::priceLaneGroup(const Option* options, int used, double* out) {
+    constexpr int W = BasicLaneTridiagonalLU<Real>::lanes;
+    constexpr bool single = std::is_same<Real, float>::value;
+    const bool mixed = single && precision_ == Precision::Mixed;
+
+    SolverWorkspace::Lanes<Real>& w = [this]() -> SolverWorkspace::Lanes<Real>& {
+        if constexpr (single)
+            return ws_->lanes_single;
+        else
+            return ws_->lanes;
+    }();
+
+    // Unused lanes repeat the last option; their results are discarded.
+    const Option* opt[W];
+    const Grid* grid[W];
+    for (int l = 0; l < W; ++l) {
+        opt[l] = &options[std::min(l, used - 1)];
+        grid[l] = &assignGrid(w.grid[l], *opt[l]);
+    }
+    int n = grid[0]->size();
+    for (int l = 1; l < W; ++l)
+        if (grid[l]->size() != n)
+            throw std::invalid_argument("priceEuropeanBatch: options do not share a grid shape");
+
+    std::size_t total = static_cast<std::size_t>(n) * W;
+    w.ea.assign(total, Real(0));
+    w.eb.assign(total, Real(1));
+    w.ec.assign(total, Real(0));
+    w.lower.assign(total, 0.0);
+    w.diag.assign(total, 1.0);
+    w.upper.assign(total, 0.0);
+    w.V.resize(total);
+    w.rhs.resize(total);
+    if (mixed) {
+        w.level.resize(total);
+        w.level_rhs.resize(total);
+    }
+
+    double dt[W], S_min[W], S_max[W];
+    for (int l = 0; l < W; ++l) {
+        const Option& o = *opt[l];
+        dt[l] = o.T / N_;
+        S_min[l] = grid[l]->spot(0);
+        S_max[l] = grid[l]->spot(n - 1);
+        computeOperator(*grid[l], o, ws_->setup.coeff);
+        for (int i = 1; i < n - 1; ++i) {
+            int k = i * W + l;
+            double ha = 0.5 * dt[l] * ws_->setup.coeff.a[i];
+            double hb = 0.5 * dt[l] * ws_->setup.coeff.b[i];
+            double hc = 0.5 * dt[l] * ws_->setup.coeff.c[i];
+            w.lower[k] = -ha;
+            w.diag[k]  = 1.0 - hb;
+            w.upper[k] = -hc;
+            w.ea[k] = static_cast<Real>(ha);
+            w.eb[k] = static_cast<Real>(1.0 + hb);
+            w.ec[k] = static_cast<Real>(hc);
+        }
+        for (int i = 0; i < n; ++i) {
+            double payoff = o.payoff(grid[l]->spot(i));
+            w.V[i * W + l] = static_cast<Real>(payoff);
+            if (mixed)
+                w.level[i * W + l] = payoff;
+        }
+    }
+    w.implicit.factor(w.lower, w.diag, w.upper);
+
+    Real* V = w.V.data();
+    Real* rhs = w.rhs.data();
+    const Real* ea = w.ea.data();
+    const Real* eb = w.eb.data();
+    const Real* ec = w.ec.data();
+    int last = (n - 1) * W;
+
+    // frac = position of the boundary values within the step, as for
+    // solve(): 1 at the end of a full step, 0.5 after a Rannacher half-step.
+    auto setBoundaries = [&](auto* X, int step, double frac) {
+        using T = std::remove_reference_t<decltype(*X)>;
+        for (int l = 0; l < W; ++l) {
+            const Option& o = *opt[l];
+            double tau = (N_ - step - 1 + frac) * dt[l];
+            if (o.type == OptionType::Call) {
+                X[l] = T(0);
+                X[last + l] = static_cast<T>(S_max[l] - o.K * std::exp(-o.r * tau));
+            } else {
+                X[l] = static_cast<T>(o.K * std::exp(-o.r * tau) - S_min[l]);
+                X[last + l] = T(0);
+            }
+        }
+    };
+
+    // Mixed: level = LHS^-1 level_rhs, float solve plus one correction.
+    double* level = w.level.data();
+    double* level_rhs = w.level_rhs.data();
+    const double* lo = w.lower.data();
+    const double* di = w.diag.data();
+    const double* up = w.upper.data();
+    auto refine = [&] {
+        for (std::size_t k = 0; k < total; ++k)
+            V[k] = static_cast<Real>(level_rhs[k]);
+        w.implicit.solve(w.V, w.V);
+        for (std::size_t k = 0; k < total; ++k)
+            level[k] = V[k];
+        for (int k = 0; k < W; ++k) {
+            V[k] = static_cast<Real>(level_rhs[k] - di[k] * level[k]);
+            V[last + k] = static_cast<Real>(level_rhs[last + k] - di[last + k] * level[last + k]);
+        }
+        for (int k = W; k < last; ++k)
+            V[k] = static_cast<Real>(level_rhs[k] - lo[k] * level[k - W] - di[k] * level[k] -
+                                     up[k] * level[k + W]);
+        w.implicit.solve(w.V, w.V);
+        for (std::size_t k = 0; k < total; ++k)
+            level[k] += V[k];
+    };
 
-    cp[0] = c[0] / b[0];
-    dp[0] = d[0] / b[0];
+    for (int step = N_ - 1; step >= 0; --step) {
+        if (N_ - 1 - step < rannacher_) {
+            for (double frac : {0.5, 1.0}) {
+                if (mixed) {
+                    setBoundaries(level, step, frac);
+                    std::copy(level, level + total, level_rhs);
+                    refine();
+                } else {
+                    setBoundaries(V, step, frac);
+                    w.implicit.solve(w.V, w.V);
+                }
+            }
+            continue;
+        }
+        if (mixed) {
+            setBoundaries(level, step, 1.0);
+            for (int l = 0; l < W; ++l) {
+                level_rhs[l] = level[l];
+                level_rhs[last + l] = level[last + l];
+            }
+            for (int k = W; k < last; ++k)
+                level_rhs[k] = 2.0 * level[k] - lo[k] * level[k - W] - di[k] * level[k] -
+                               up[k] * level[k + W];
+            refine();
+            continue;
+        }
+        setBoundaries(V, step, 1.0);
+        for (int l = 0; l < W; ++l) {
+            rhs[l] = V[l];
+            rhs[last + l] = V[last + l];
+        }
+        for (int k = W; k < last; ++k)
+            rhs[k] = ea[k] * V[k - W] + eb[k] * V[k] + ec[k] * V[k + W];
 
-    for (int i = 1; i < n; ++i) {
-        double m = 1.0 / (b[i] - a[i] * cp[i - 1]);
-        cp[i] = c[i] * m;
-        dp[i] = (d[i] - a[i] * dp[i - 1]) * m;
+        w.implicit.solve(w.rhs, w.V);
     }
 
-    x[n - 1] = dp[n - 1];
-    for (int i = n - 2; i >= 0; --i)
-        x[i] = dp[i] - cp[i] * x[i + 1];
+    for (int l = 0; l < used; ++l) {
+        const Grid& g = *grid[l];
+        double S = opt[l]->S;
+        int i = g.findIndex(S);
+        double S_lo = g.spot(i);
+        double S_hi = g.spot(i + 1);
+        double wgt = (S - S_lo) / (S_hi - S_lo);
+        double lo_v = mixed ? level[i * W + l] : V[i * W + l];
+        double hi_v = mixed ? level[(i + 1) * W + l] : V[(i + 1) * W + l];
+        out[l] = (1.0 - wgt) * lo_v + wgt * hi_v;
+    }
 }
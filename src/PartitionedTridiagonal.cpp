@@ -0,0 +1,216 @@
+#include "PartitionedTridiagonal.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Right-hand sides of pass 1 and of the separator rows, row by row.
+struct VectorRhs {
+    const double* r;
+    double operator()(int i) const { return r[i]; }
+};
+
+// Row i of B v, as in TridiagonalLU::solveProduct().
+struct ProductRhs {
+    const double *a, *b, *c, *v;
+    int n;
+    double operator()(int i) const {
+        double s = b[i] * v[i];
+        if (i > 0) s += a[i] * v[i - 1];
+        if (i < n - 1) s += c[i] * v[i + 1];
+        return s;
+    }
+};
+
+}  // namespace
+
+void PartitionedTridiagonalLU::factor(const std::vector<double>& a,
+                                      const std::vector<double>& b,
+                                      const std::vector<double>& c) {
+    int n = static_cast<int>(b.size());
+    if (static_cast<int>(a.size()) != n || static_cast<int>(c.size()) != n)
+        throw std::invalid_argument("PartitionedTridiagonalLU: inconsistent diagonal sizes");
+    if (n < 2 * (kBlockRows + 1))
+        throw std::invalid_argument("PartitionedTridiagonalLU: system too small to partition");
+
+    // P blocks of `base` or `base + 1` rows and P - 1 separators.
+    int P = n / (kBlockRows + 1);
+    int base = (n - (P - 1)) / P, extra = (n - (P - 1)) % P;
+    start_.resize(P + 1);
+    start_[0] = 0;
+    for (int k = 0; k < P; ++k)
+        start_[k + 1] = start_[k] + base + (k < extra ? 1 : 0) + 1;
+
+    n_ = n;
+    lower_.assign(a.begin(), a.end());
+    upper_.assign(c.begin(), c.end());
+    inv_piv_.resize(n);
+    modified_.resize(n);
+    alpha_.assign(n, 0.0);
+    beta_.assign(n, 0.0);
+
+    for (int k = 0; k < P; ++k) {
+        int lo = start_[k], hi = start_[k + 1] - 2;
+
+        // The block's own LU, as TridiagonalLU (Forward) on rows lo..hi.
+        inv_piv_[lo] = 1.0 / b[lo];
+        modified_[lo] = c[lo] * inv_piv_[lo];
+        for (int i = lo + 1; i <= hi; ++i) {
+            inv_piv_[i] = 1.0 / (b[i] - a[i] * modified_[i - 1]);
+            modified_[i] = c[i] * inv_piv_[i];
+        }
+
+        // alpha = A_k^-1 (a_lo e_first): the left separator's influence.
+        if (k > 0) {
+            alpha_[lo] = a[lo] * inv_piv_[lo];
+            for (int i = lo + 1; i <= hi; ++i)
+                alpha_[i] = -a[i] * alpha_[i - 1] * inv_piv_[i];
+            for (int i = hi - 1; i >= lo; --i)
+                alpha_[i] -= modified_[i] * alpha_[i + 1];
+        }
+        // beta = A_k^-1 (c_hi e_last): the forward sweep leaves only the
+        // last row nonzero.
+        if (k < P - 1) {
+            beta_[hi] = modified_[hi];
+            for (int i = hi - 1; i >= lo; --i)
+                beta_[i] = -modified_[i] * beta_[i + 1];
+        }
+    }
+
+    // Separator s between blocks k and k + 1 couples to x[s - 1] and
+    // x[s + 1]; substituting their spike expressions gives row k of the
+    // reduced system in x at the separators k - 1, k, k + 1.
+    red_lower_.resize(P - 1);
+    red_inv_piv_.resize(P - 1);
+    red_modified_.resize(P - 1);
+    for (int k = 0; k < P - 1; ++k) {
+        int s = start_[k + 1] - 1;
+        double lower = -a[s] * alpha_[s - 1];
+        double diag = b[s] - a[s] * beta_[s - 1] - c[s] * alpha_[s + 1];
+        double upper = -c[s] * beta_[s + 1];
+        red_lower_[k] = lower;
+        red_inv_piv_[k] = 1.0 / (k > 0 ? diag - lower * red_modified_[k - 1] : diag);
+        red_modified_[k] = upper * red_inv_piv_[k];
+    }
+}
+
+void PartitionedTridiagonalLU::clear() {
+    n_ = 0;
+    start_.clear();
+}
+
+int PartitionedTridiagonalLU::size() const { return n_; }
+
+int PartitionedTridiagonalLU::blocks() const {
+    return n_ > 0 ? static_cast<int>(start_.size()) - 1 : 0;
+}
+
+template <class Rhs>
+void PartitionedTridiagonalLU::run(const Rhs& rhs, std::vector<double>& x,
+                                   std::vector<double>& work, WorkStealingPool* pool) const {
+    const int P = blocks();
+    const int groups = (P + kInterleave - 1) / kInterleave;
+    work.resize(n_);
+    x.resize(n_);
+
+    const double* a = lower_.data();
+    const double* ip = inv_piv_.data();
+    const double* m = modified_.data();
+    double* w = work.data();
+
+    // Pass 1: y = A_k^-1 rhs for the blocks of group g, in lockstep. Their
+    // lengths differ by at most one row, handled outside the shared loop.
+    auto local = [&](int g) {
+        int k0 = g * kInterleave, count = std::min(kInterleave, P - k0);
+        int lo[kInterleave], len[kInterleave];
+        int common = n_;
+        for (int j = 0; j < count; ++j) {
+            lo[j] = start_[k0 + j];
+            len[j] = start_[k0 + j + 1] - 1 - lo[j];
+            common = std::min(common, len[j]);
+        }
+        for (int j = 0; j < count; ++j)
+            w[lo[j]] = rhs(lo[j]) * ip[lo[j]];
+        for (int i = 1; i < common; ++i)
+            for (int j = 0; j < count; ++j) {
+                int r = lo[j] + i;
+                w[r] = (rhs(r) - a[r] * w[r - 1]) * ip[r];
+            }
+        for (int j = 0; j < count; ++j)
+            if (len[j] > common) {
+                int r = lo[j] + common;
+                w[r] = (rhs(r) - a[r] * w[r - 1]) * ip[r];
+                w[r - 1] -= m[r - 1] * w[r];
+            }
+        for (int i = common - 2; i >= 0; --i)
+            for (int j = 0; j < count; ++j) {
+                int r = lo[j] + i;
+                w[r] -= m[r] * w[r + 1];
+            }
+    };
+
+    // Pass 3: x = y - alpha x_left - beta x_right, and the separator to
+    // the right of each block.
+    const double* al = alpha_.data();
+    const double* be = beta_.data();
+    double* xo = x.data();
+    auto correct = [&](int g) {
+        int k1 = std::min(P, (g + 1) * kInterleave);
+        for (int k = g * kInterleave; k < k1; ++k) {
+            int lo = start_[k], end = start_[k + 1] - 1;
+            double xl = k > 0 ? w[lo - 1] : 0.0;
+            double xr = k < P - 1 ? w[end] : 0.0;
+            for (int i = lo; i < end; ++i)
+                xo[i] = w[i] - al[i] * xl - be[i] * xr;
+            if (k < P - 1) xo[end] = w[end];
+        }
+    };
+
+    // Captured as one reference, so std::function stores it without
+    // allocating.
+    struct Passes {
+        decltype(local)& pass1;
+        decltype(correct)& pass3;
+    } passes{local, correct};
+
+    if (pool && pool->size() > 1)
+        pool->parallelFor(groups, [&passes](std::size_t g, int) {
+            passes.pass1(static_cast<int>(g));
+        });
+    else
+        for (int g = 0; g < groups; ++g) local(g);
+
+    // Pass 2: the reduced system over the separators, solved in place in
+    // w. x is not written before pass 3, so rhs is still intact if they
+    // alias.
+    const double* c = upper_.data();
+    int prev = -1;
+    for (int k = 0; k < P - 1; ++k) {
+        int s = start_[k + 1] - 1;
+        double d = rhs(s) - a[s] * w[s - 1] - c[s] * w[s + 1];
+        w[s] = (k > 0 ? d - red_lower_[k] * w[prev] : d) * red_inv_piv_[k];
+        prev = s;
+    }
+    for (int k = P - 3; k >= 0; --k)
+        w[start_[k + 1] - 1] -= red_modified_[k] * w[start_[k + 2] - 1];
+
+    if (pool && pool->size() > 1)
+        pool->parallelFor(groups, [&passes](std::size_t g, int) {
+            passes.pass3(static_cast<int>(g));
+        });
+    else
+        for (int g = 0; g < groups; ++g) correct(g);
+}
+
+void PartitionedTridiagonalLU::solve(const std::vector<double>& rhs, std::vector<double>& x,
+                                     std::vector<double>& work, WorkStealingPool* pool) const {
+    run(VectorRhs{rhs.data()}, x, work, pool);
+}
+
+void PartitionedTridiagonalLU::solveProduct(const double* b_lower, const double* b_diag,
+                                            const double* b_upper,
+                                            const std::vector<double>& v, std::vector<double>& x,
+                                            std::vector<double>& work,
+                                            WorkStealingPool* pool) const {
+    run(ProductRhs{b_lower, b_diag, b_upper, v.data(), n_}, x, work, pool);
+}
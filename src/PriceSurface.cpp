@@ -0,0 +1,127 @@
+#include "PriceSurface.hpp"
+#include "Tridiagonal.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Beyond this many runs, scanning them costs more than a binary search.
+static constexpr std::size_t kMaxScannedSegments = 8;
+
+PriceSurface::PriceSurface(std::vector<double> nodes, std::vector<double> values)
+    : nodes_(std::move(nodes)), values_(std::move(values)) {
+    if (nodes_.size() < 2 || nodes_.size() != values_.size())
+        throw std::invalid_argument("PriceSurface: need >= 2 nodes and one value per node");
+    buildSegments();
+    buildSpline();
+}
+
+int PriceSurface::size() const {
+    return static_cast<int>(nodes_.size());
+}
+
+const std::vector<double>& PriceSurface::nodes() const {
+    return nodes_;
+}
+
+const std::vector<double>& PriceSurface::values() const {
+    return values_;
+}
+
+// ----------------------------------------------------------------
+// Split the nodes into maximal runs of equal spacing (to a relative
+// 1e-9, which absorbs the rounding in the grid constructors).
+// ----------------------------------------------------------------
+
+void PriceSurface::buildSegments() {
+    int intervals = size() - 1;
+    int first = 0;
+    while (first < intervals) {
+        double h = nodes_[first + 1] - nodes_[first];
+        int last = first + 1;
+        while (last < intervals &&
+               std::abs((nodes_[last + 1] - nodes_[last]) - h) <= 1e-9 * h)
+            ++last;
+        segments_.push_back({nodes_[first], 1.0 / h, first, last - first});
+        first = last;
+    }
+}
+
+// ----------------------------------------------------------------
+// Natural cubic spline: for interior nodes, with h_i = S_{i+1} - S_i,
+//
+//   h_{i-1} M_{i-1} + 2 (h_{i-1} + h_i) M_i + h_i M_{i+1}
+//       = 6 [(V_{i+1} - V_i)/h_i - (V_i - V_{i-1})/h_{i-1}]
+//
+// and M_0 = M_{n-1} = 0.
+// ----------------------------------------------------------------
+
+void PriceSurface::buildSpline() {
+    int n = size();
+    std::vector<double> lower(n, 0.0), diag(n, 1.0), upper(n, 0.0), rhs(n, 0.0);
+    for (int i = 1; i < n - 1; ++i) {
+        double hm = nodes_[i] - nodes_[i - 1];
+        double hp = nodes_[i + 1] - nodes_[i];
+        lower[i] = hm;
+        diag[i]  = 2.0 * (hm + hp);
+        upper[i] = hp;
+        rhs[i] = 6.0 * ((values_[i + 1] - values_[i]) / hp -
+                        (values_[i] - values_[i - 1]) / hm);
+    }
+    solveTridiagonal(lower, diag, upper, rhs, second_);
+}
+
+// ----------------------------------------------------------------
+// Lookup
+// ----------------------------------------------------------------
+
+int PriceSurface::locate(double S) const {
+    int last = size() - 2;
+    if (S <= nodes_.front()) return 0;
+    if (S >= nodes_.back()) return last;
+
+    int i;
+    if (segments_.size() <= kMaxScannedSegments) {
+        std::size_t k = 0;
+        while (k + 1 < segments_.size() && S >= segments_[k + 1].start)
+            ++k;
+        const Segment& seg = segments_[k];
+        i = seg.first + static_cast<int>((S - seg.start) * seg.inv_h);
+        i = std::min(i, seg.first + seg.count - 1);
+        // The product above can land one interval off when S sits on a node.
+        if (S < nodes_[i]) --i;
+        else if (i < last && S >= nodes_[i + 1]) ++i;
+    } else {
+        auto it = std::upper_bound(nodes_.begin(), nodes_.end(), S);
+        i = static_cast<int>(it - nodes_.begin()) - 1;
+    }
+    return std::max(0, std::min(i, last));
+}
+
+double PriceSurface::evaluate(double S, Interpolation method) const {
+    int i = locate(S);
+    double S_lo = nodes_[i];
+    double S_hi = nodes_[i + 1];
+    double h = S_hi - S_lo;
+    double w = (S - S_lo) / h;
+    double linear = (1.0 - w) * values_[i] + w * values_[i + 1];
+    if (method == Interpolation::Linear)
+        return linear;
+
+    // Cubic spline correction on top of the linear interpolant.
+    double a = 1.0 - w;
+    return linear + (h * h / 6.0) *
+           ((a * a * a - a) * second_[i] + (w * w * w - w) * second_[i + 1]);
+}
+
+void PriceSurface::evaluate(const double* spots, std::size_t count, double* out,
+                            Interpolation method) const {
+    for (std::size_t k = 0; k < count; ++k)
+        out[k] = evaluate(spots[k], method);
+}
+
+std::vector<double> PriceSurface::evaluate(const std::vector<double>& spots,
+                                           Interpolation method) const {
+    std::vector<double> out(spots.size());
+    evaluate(spots.data(), spots.size(), out.data(), method);
+    return out;
+}
@@ -0,0 +1,137 @@
+#include "PricingClient.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+PricingClient::PricingClient(const std::string& unix_path)
+    : fd_(protocol::connectUnix(unix_path)) {}
+
+PricingClient::PricingClient(const std::string& host, int port)
+    : fd_(protocol::connectTcp(host, port)) {}
+
+PricingClient::~PricingClient() {
+    ::close(fd_);
+}
+
+void PricingClient::send(std::uint64_t id, const Option& option, std::uint32_t deadline_us) {
+    char frame[protocol::kLengthSize + protocol::kPriceRequestSize];
+    protocol::encodeRequest(id, deadline_us, option, frame);
+    protocol::writeFully(fd_, frame, sizeof(frame));
+}
+
+std::uint32_t PricingClient::readFrame(std::string& payload) {
+    std::uint32_t len;
+    if (!protocol::readFully(fd_, reinterpret_cast<char*>(&len), sizeof(len)) || len == 0)
+        throw std::runtime_error("PricingClient: connection closed");
+    payload.resize(len);
+    if (!protocol::readFully(fd_, &payload[0], len))
+        throw std::runtime_error("PricingClient: connection closed");
+    return len;
+}
+
+PriceReply PricingClient::receive() {
+    std::string payload;
+    std::uint32_t len = readFrame(payload);
+    if (payload[0] != protocol::Price || len != protocol::kPriceResponseSize)
+        throw std::runtime_error("PricingClient: unexpected response");
+    PriceReply reply;
+    protocol::decodeReply(payload.data(), reply);
+    return reply;
+}
+
+PriceReply PricingClient::price(const Option& option, std::uint32_t deadline_us) {
+    send(next_id_++, option, deadline_us);
+    return receive();
+}
+
+std::string PricingClient::stats() {
+    char frame[protocol::kLengthSize + 1];
+    std::uint32_t len = 1;
+    std::memcpy(frame, &len, sizeof(len));
+    frame[protocol::kLengthSize] = protocol::Stats;
+    protocol::writeFully(fd_, frame, sizeof(frame));
+    std::string payload;
+    readFrame(payload);
+    if (payload[0] != protocol::Stats)
+        throw std::runtime_error("PricingClient: unexpected response");
+    return payload.substr(1);
+}
+
+// ----------------------------------------------------------------
+// Load generator
+// ----------------------------------------------------------------
+
+double LoadReport::requestsPerSecond() const {
+    return seconds > 0.0 ? (ok + invalid + expired + overloaded) / seconds : 0.0;
+}
+
+LoadReport runLoad(const LoadConfig& config, const std::vector<Option>& book) {
+    using Clock = std::chrono::steady_clock;
+    if (book.empty() || config.connections < 1 || config.in_flight < 1)
+        throw std::invalid_argument("runLoad: need options, connections and in_flight >= 1");
+
+    LoadReport report;
+    std::mutex mutex;
+    std::exception_ptr error;
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int c = 0; c < config.connections; ++c) {
+        // Requests of this connection: an even share of the total.
+        std::size_t quota = config.requests / config.connections +
+                            (static_cast<std::size_t>(c) < config.requests % config.connections);
+        threads.emplace_back([&, c, quota] {
+            try {
+                auto client = config.unix_path.empty()
+                                  ? std::make_unique<PricingClient>(config.host, config.port)
+                                  : std::make_unique<PricingClient>(config.unix_path);
+                std::vector<Clock::time_point> sent(quota);
+                LoadReport local;
+                std::size_t next = 0;
+                auto sendNext = [&] {
+                    sent[next] = Clock::now();
+                    client->send(next, book[(next * config.connections + c) % book.size()],
+                                 config.deadline_us);
+                    ++next;
+                };
+                while (next < std::min<std::size_t>(quota, config.in_flight))
+                    sendNext();
+                for (std::size_t done = 0; done < quota; ++done) {
+                    PriceReply reply = client->receive();
+                    local.latency.record(static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                                             sent[reply.id])
+                            .count()));
+                    switch (reply.status) {
+                    case PriceStatus::Ok: ++local.ok; break;
+                    case PriceStatus::Invalid: ++local.invalid; break;
+                    case PriceStatus::DeadlineExceeded: ++local.expired; break;
+                    case PriceStatus::Overloaded: ++local.overloaded; break;
+                    }
+                    if (next < quota)
+                        sendNext();
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                report.ok += local.ok;
+                report.invalid += local.invalid;
+                report.expired += local.expired;
+                report.overloaded += local.overloaded;
+                report.latency.merge(local.latency);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& t : threads)
+        t.join();
+    if (error)
+        std::rethrow_exception(error);
+    report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return report;
+}
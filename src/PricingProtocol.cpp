@@ -0,0 +1,122 @@
+#include "PricingProtocol.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace protocol {
+
+namespace {
+
+template <class T>
+char* put(char* p, T value) {
+    std::memcpy(p, &value, sizeof(T));
+    return p + sizeof(T);
+}
+
+template <class T>
+const char* get(const char* p, T& value) {
+    std::memcpy(&value, p, sizeof(T));
+    return p + sizeof(T);
+}
+
+}  // namespace
+
+void encodeRequest(std::uint64_t id, std::uint32_t deadline_us, const Option& option, char* out) {
+    char* p = put(out, static_cast<std::uint32_t>(kPriceRequestSize));
+    p = put(p, static_cast<std::uint8_t>(Kind::Price));
+    p = put(p, id);
+    p = put(p, deadline_us);
+    batchfile::encodeRecord(option, p);
+}
+
+void encodeReply(const PriceReply& reply, char* out) {
+    char* p = put(out, static_cast<std::uint32_t>(kPriceResponseSize));
+    p = put(p, static_cast<std::uint8_t>(Kind::Price));
+    p = put(p, reply.id);
+    p = put(p, static_cast<std::uint8_t>(reply.status));
+    put(p, reply.price);
+}
+
+void decodeRequest(const char* payload, PriceRequest& out) {
+    const char* p = get(payload + 1, out.id);
+    p = get(p, out.deadline_us);
+    batchfile::decodeRecord(p, out.option);
+    out.option.line = 0;
+}
+
+void decodeReply(const char* payload, PriceReply& out) {
+    std::uint8_t status;
+    const char* p = get(payload + 1, out.id);
+    p = get(p, status);
+    get(p, out.price);
+    out.status = static_cast<PriceStatus>(status);
+}
+
+bool readFully(int fd, char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t got = ::recv(fd, data, size, 0);
+        if (got == 0)
+            return false;
+        if (got < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error(std::string("socket read: ") + std::strerror(errno));
+        }
+        data += got;
+        size -= static_cast<std::size_t>(got);
+    }
+    return true;
+}
+
+void writeFully(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error(std::string("socket write: ") + std::strerror(errno));
+        }
+        data += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+}
+
+int connectUnix(const std::string& path) {
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+        throw std::runtime_error("socket path too long: " + path);
+    std::strcpy(addr.sun_path, path.c_str());
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        if (fd >= 0)
+            ::close(fd);
+        throw std::runtime_error("cannot connect to " + path);
+    }
+    return fd;
+}
+
+int connectTcp(const std::string& host, int port) {
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<std::uint16_t>(port));
+    if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1)
+        throw std::runtime_error("not an IPv4 address: " + host);
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        if (fd >= 0)
+            ::close(fd);
+        throw std::runtime_error("cannot connect to " + host + ":" + std::to_string(port));
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+}  // namespace protocol
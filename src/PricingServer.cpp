@@ -0,0 +1,500 @@
+#include "PricingServer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Blocking calls wake this often to notice stop().
+constexpr int kPollMs = 100;
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+}  // namespace
+
+struct PricingServer::Connection {
+    int fd;
+    std::size_t max_outbound;
+    std::mutex write_mutex;
+    std::string outbound;   // unsent bytes from `sent` on
+    std::size_t sent = 0;
+    bool closed = false;    // dropped, or the client went away
+
+    Connection(int socket, std::size_t limit) : fd(socket), max_outbound(limit) {}
+    ~Connection() { ::close(fd); }
+
+    // Queues data and sends what the socket takes now. Returns false if
+    // this write pushed the backlog past max_outbound and the client was
+    // dropped. Writes to a closed connection are discarded.
+    bool write(const char* data, std::size_t size) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        if (closed)
+            return true;
+        if (outbound.size() - sent + size > max_outbound) {
+            close();
+            ::shutdown(fd, SHUT_RDWR);
+            return false;
+        }
+        outbound.erase(0, sent);
+        sent = 0;
+        outbound.append(data, size);
+        flushLocked();
+        return true;
+    }
+
+    // For the reader thread: whether to wait for the socket to drain, and
+    // sending once it has.
+    bool backlogged() {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        return sent < outbound.size();
+    }
+    void flush() {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        flushLocked();
+    }
+
+private:
+    void close() {
+        closed = true;
+        outbound.clear();
+        sent = 0;
+    }
+
+    void flushLocked() {
+        while (sent < outbound.size()) {
+            ssize_t n = ::send(fd, outbound.data() + sent, outbound.size() - sent, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK)
+                    close();
+                return;
+            }
+            sent += static_cast<std::size_t>(n);
+        }
+    }
+};
+
+double ServerStats::meanBatch() const {
+    return batches > 0 ? static_cast<double>(priced + invalid + expired) / batches : 0.0;
+}
+
+std::string ServerStats::toJson() const {
+    char buf[768];
+    std::snprintf(buf, sizeof(buf),
+                  "{\"requests\": %llu, \"priced\": %llu, \"invalid\": %llu, \"expired\": %llu, "
+                  "\"overloaded\": %llu, \"batches\": %llu, \"mean_batch\": %.2f, \"dropped\": %llu, "
+                  "\"queue_depth\": %zu, \"max_queue_depth\": %zu, \"connections\": %zu, "
+                  "\"latency_us\": {\"p50\": %.1f, \"p99\": %.1f, \"p999\": %.1f, \"max\": %.1f}, "
+                  "\"setup_cache\": {\"hits\": %zu, \"misses\": %zu}}",
+                  static_cast<unsigned long long>(requests), static_cast<unsigned long long>(priced),
+                  static_cast<unsigned long long>(invalid), static_cast<unsigned long long>(expired),
+                  static_cast<unsigned long long>(overloaded),
+                  static_cast<unsigned long long>(batches), meanBatch(),
+                  static_cast<unsigned long long>(dropped), queue_depth,
+                  max_queue_depth, connections, p50_us, p99_us, p999_us, max_us, cache.hits,
+                  cache.misses);
+    return buf;
+}
+
+PricingServer::PricingServer(const PDESolver& prototype, ServerConfig config)
+    : config_(config), pool_(config.threads) {
+    if (config_.max_batch < 1 || config_.max_queue < 1 || config_.max_outbound < 1)
+        throw std::invalid_argument(
+            "PricingServer: max_batch, max_queue and max_outbound must be >= 1");
+    PDESolver solver = prototype;
+    cache_ = solver.setupCache();
+    if (!cache_) {
+        cache_ = std::make_shared<SetupCache>(256);
+        solver.setSetupCache(cache_);
+    }
+    solvers_.assign(pool_.size(), solver);
+    scratch_.resize(pool_.size());
+    dispatcher_ = std::thread([this] { dispatchLoop(); });
+}
+
+PricingServer::~PricingServer() {
+    stop();
+}
+
+// ----------------------------------------------------------------
+// Listening and connections
+// ----------------------------------------------------------------
+
+void PricingServer::listenUnix(const std::string& path) {
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+        throw std::runtime_error("socket path too long: " + path);
+    std::strcpy(addr.sun_path, path.c_str());
+    ::unlink(path.c_str());
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, 64) != 0) {
+        if (fd >= 0)
+            ::close(fd);
+        throw std::runtime_error("cannot listen on " + path);
+    }
+    unix_path_ = path;
+    listeners_.push_back(fd);
+    acceptors_.emplace_back([this, fd] { acceptLoop(fd); });
+}
+
+int PricingServer::listenTcp(int port) {
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<std::uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    if (fd >= 0)
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    socklen_t len = sizeof(addr);
+    if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, 64) != 0 ||
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        if (fd >= 0)
+            ::close(fd);
+        throw std::runtime_error("cannot listen on 127.0.0.1:" + std::to_string(port));
+    }
+    listeners_.push_back(fd);
+    acceptors_.emplace_back([this, fd] { acceptLoop(fd); });
+    return ntohs(addr.sin_port);
+}
+
+void PricingServer::stop() {
+    if (stopping_.exchange(true))
+        return;
+    queue_cv_.notify_all();
+    for (std::thread& t : acceptors_)
+        t.join();
+    if (dispatcher_.joinable())
+        dispatcher_.join();
+    {
+        std::lock_guard<std::mutex> lock(readers_mutex_);
+        for (Reader& r : readers_)
+            r.thread.join();
+        readers_.clear();
+    }
+    for (int fd : listeners_)
+        ::close(fd);
+    if (!unix_path_.empty())
+        ::unlink(unix_path_.c_str());
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    queue_.clear();
+}
+
+void PricingServer::acceptLoop(int listener) {
+    while (!stopping_) {
+        pollfd p = {listener, POLLIN, 0};
+        if (::poll(&p, 1, kPollMs) <= 0)
+            continue;
+        int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));   // fails on Unix sockets
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        auto conn = std::make_shared<Connection>(fd, config_.max_outbound);
+        auto done = std::make_shared<std::atomic<bool>>(false);
+
+        std::lock_guard<std::mutex> lock(readers_mutex_);
+        // Reap readers of closed connections.
+        for (auto it = readers_.begin(); it != readers_.end();) {
+            if (*it->done) {
+                it->thread.join();
+                it = readers_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+            ++counters_.connections;
+        }
+        readers_.push_back({std::thread([this, conn, done] { readLoop(conn, done); }), done});
+    }
+}
+
+// Frames are at most kMaxRequestSize, so a partial one always fits the
+// buffer after the complete ones are consumed.
+void PricingServer::readLoop(std::shared_ptr<Connection> conn,
+                             std::shared_ptr<std::atomic<bool>> done) {
+    std::vector<char> buf(64 * 1024);
+    std::size_t have = 0;
+    std::vector<Request> requests;
+    bool open = true;
+    while (open && !stopping_) {
+        short events = conn->backlogged() ? POLLIN | POLLOUT : POLLIN;
+        pollfd p = {conn->fd, events, 0};
+        int ready = ::poll(&p, 1, kPollMs);
+        if (ready < 0 && errno != EINTR)
+            break;
+        if (ready <= 0)
+            continue;
+        if (p.revents & POLLOUT)
+            conn->flush();
+        if (!(p.revents & (POLLIN | POLLHUP | POLLERR)))
+            continue;
+        ssize_t got = ::recv(conn->fd, buf.data() + have, buf.size() - have, 0);
+        if (got < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+            continue;
+        if (got <= 0)
+            break;
+        have += static_cast<std::size_t>(got);
+
+        std::size_t pos = 0;
+        Clock::time_point now = Clock::now();
+        while (have - pos >= protocol::kLengthSize) {
+            std::uint32_t len;
+            std::memcpy(&len, buf.data() + pos, sizeof(len));
+            if (len == 0 || len > protocol::kMaxRequestSize) {
+                open = false;
+                break;
+            }
+            if (have - pos - protocol::kLengthSize < len)
+                break;
+            const char* payload = buf.data() + pos + protocol::kLengthSize;
+            if (payload[0] == protocol::Price && len == protocol::kPriceRequestSize) {
+                Request r;
+                r.conn = conn;
+                protocol::decodeRequest(payload, r.req);
+                r.arrival = now;
+                r.deadline = r.req.deadline_us > 0
+                                 ? now + std::chrono::microseconds(r.req.deadline_us)
+                                 : Clock::time_point::max();
+                requests.push_back(std::move(r));
+            } else if (payload[0] == protocol::Stats && len == 1) {
+                std::string json = stats().toJson();
+                std::string frame(protocol::kLengthSize + 1, '\0');
+                std::uint32_t size = static_cast<std::uint32_t>(json.size() + 1);
+                std::memcpy(&frame[0], &size, sizeof(size));
+                frame[protocol::kLengthSize] = protocol::Stats;
+                frame += json;
+                send(*conn, frame.data(), frame.size());
+            } else {
+                open = false;
+                break;
+            }
+            pos += protocol::kLengthSize + len;
+        }
+        enqueue(requests);
+        std::memmove(buf.data(), buf.data() + pos, have - pos);
+        have -= pos;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        --counters_.connections;
+    }
+    *done = true;
+}
+
+void PricingServer::enqueue(std::vector<Request>& requests) {
+    if (requests.empty())
+        return;
+    std::vector<Request> rejected;
+    std::size_t depth;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        for (Request& r : requests) {
+            if (queue_.size() < config_.max_queue) {
+                queue_.push_back(std::move(r));
+            } else {
+                r.reply = {r.req.id, PriceStatus::Overloaded, kNaN};
+                rejected.push_back(std::move(r));
+            }
+        }
+        depth = queue_.size();
+    }
+    queue_cv_.notify_one();
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        counters_.requests += requests.size();
+        counters_.overloaded += rejected.size();
+        counters_.max_queue_depth = std::max(counters_.max_queue_depth, depth);
+    }
+    requests.clear();
+    respond(rejected);
+}
+
+// ----------------------------------------------------------------
+// Batching and pricing
+// ----------------------------------------------------------------
+
+void PricingServer::dispatchLoop() {
+    std::vector<Request> batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (stopping_)
+                return;
+            Clock::time_point until = queue_.front().arrival + config_.batch_window;
+            queue_cv_.wait_until(lock, until, [this] {
+                return stopping_ || queue_.size() >= config_.max_batch;
+            });
+            if (stopping_)
+                return;
+            std::size_t n = std::min(config_.max_batch, queue_.size());
+            for (std::size_t i = 0; i < n; ++i) {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+        priceBatch(batch);
+        respond(batch);
+        batch.clear();
+    }
+}
+
+void PricingServer::priceBatch(std::vector<Request>& batch) {
+    auto shape = [](const Request& r) {
+        const OptionRecord& o = r.req.option;
+        return std::make_tuple(o.exercise, o.type, o.T, o.sigma, o.r, o.K, o.S);
+    };
+    std::sort(batch.begin(), batch.end(),
+              [&](const Request& a, const Request& b) { return shape(a) < shape(b); });
+
+    // Tasks: runs of up to `lanes` Europeans, single Americans.
+    constexpr std::size_t W = LaneTridiagonalLU::lanes;
+    std::vector<std::pair<std::size_t, std::size_t>> tasks;
+    for (std::size_t i = 0; i < batch.size();) {
+        std::size_t end = i + 1;
+        if (batch[i].req.option.exercise == ExerciseType::European)
+            while (end < batch.size() && end - i < W &&
+                   batch[end].req.option.exercise == ExerciseType::European)
+                ++end;
+        tasks.emplace_back(i, end);
+        i = end;
+    }
+
+    pool_.parallelFor(tasks.size(), [&](std::size_t t, int worker) {
+        PDESolver& solver = solvers_[worker];
+        std::vector<Option>& options = scratch_[worker];
+        options.clear();
+        std::size_t index[W];
+        Clock::time_point now = Clock::now();
+        for (std::size_t i = tasks[t].first; i < tasks[t].second; ++i) {
+            Request& r = batch[i];
+            const OptionRecord& o = r.req.option;
+            r.reply = {r.req.id, PriceStatus::Invalid, kNaN};
+            if (now > r.deadline) {
+                r.reply.status = PriceStatus::DeadlineExceeded;
+                continue;
+            }
+            if (o.error)
+                continue;
+            try {
+                options.emplace_back(o.S, o.K, o.T, o.r, o.sigma, o.type, o.exercise);
+                index[options.size() - 1] = i;
+            } catch (const std::invalid_argument&) {
+            }
+        }
+        if (options.empty())
+            return;
+
+        double prices[W];
+        bool priced = false;
+        if (options.size() > 1) {
+            try {
+                solver.priceEuropeanBatch(options.data(), options.size(), prices);
+                priced = true;
+            } catch (const std::invalid_argument&) {
+                // Grids of different sizes; price one at a time below.
+            }
+        }
+        for (std::size_t k = 0; k < options.size(); ++k) {
+            PriceReply& reply = batch[index[k]].reply;
+            if (!priced) {
+                try {
+                    prices[k] = solver.price(options[k]);
+                } catch (const std::invalid_argument&) {
+                    continue;
+                }
+            }
+            reply.status = PriceStatus::Ok;
+            reply.price = prices[k];
+        }
+    });
+}
+
+// Counters and latency are recorded before the replies go out, so a
+// client holding its reply sees it in stats. Replies are grouped by
+// connection, one write each.
+void PricingServer::respond(std::vector<Request>& requests) {
+    if (requests.empty())
+        return;
+    {
+        Clock::time_point now = Clock::now();
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        bool batched = false;
+        for (const Request& r : requests) {
+            latency_.record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - r.arrival).count()));
+            switch (r.reply.status) {
+            case PriceStatus::Ok: ++counters_.priced; batched = true; break;
+            case PriceStatus::Invalid: ++counters_.invalid; batched = true; break;
+            case PriceStatus::DeadlineExceeded: ++counters_.expired; batched = true; break;
+            case PriceStatus::Overloaded: break;
+            }
+        }
+        if (batched)
+            ++counters_.batches;
+    }
+
+    std::stable_sort(requests.begin(), requests.end(), [](const Request& a, const Request& b) {
+        return a.conn.get() < b.conn.get();
+    });
+    std::string frames;
+    for (std::size_t i = 0; i < requests.size();) {
+        std::size_t end = i;
+        frames.resize(0);
+        for (; end < requests.size() && requests[end].conn == requests[i].conn; ++end) {
+            char frame[protocol::kLengthSize + protocol::kPriceResponseSize];
+            protocol::encodeReply(requests[end].reply, frame);
+            frames.append(frame, sizeof(frame));
+        }
+        send(*requests[i].conn, frames.data(), frames.size());
+        i = end;
+    }
+}
+
+void PricingServer::send(Connection& conn, const char* data, std::size_t size) {
+    if (conn.write(data, size))
+        return;
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    ++counters_.dropped;
+}
+
+ServerStats PricingServer::stats() const {
+    ServerStats s;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        s = counters_;
+        s.p50_us = latency_.percentile(0.5) * 1e-3;
+        s.p99_us = latency_.percentile(0.99) * 1e-3;
+        s.p999_us = latency_.percentile(0.999) * 1e-3;
+        s.max_us = latency_.max() * 1e-3;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        s.queue_depth = queue_.size();
+    }
+    s.cache = cache_->stats();
+    return s;
+}
@@ -0,0 +1,127 @@
+#include "Profiler.hpp"
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+
+namespace instrument {
+
+namespace {
+thread_local std::uint64_t t_allocations = 0;
+}
+
+void noteAllocation() noexcept {
+    ++t_allocations;
+}
+
+std::uint64_t threadAllocations() noexcept {
+    return t_allocations;
+}
+
+}  // namespace instrument
+
+const char* phaseName(Phase phase) {
+    switch (phase) {
+    case Phase::Grid:     return "grid";
+    case Phase::Assembly: return "assembly";
+    case Phase::Factor:   return "factor";
+    case Phase::TimeLoop: return "time_loop";
+    case Phase::Solve:    return "solve";
+    case Phase::Exercise: return "exercise";
+    }
+    return "unknown";
+}
+
+SolveProfile& SolveProfile::operator+=(const SolveProfile& o) {
+    for (int p = 0; p < kPhaseCount; ++p) {
+        phase_ns[p] += o.phase_ns[p];
+        phase_calls[p] += o.phase_calls[p];
+    }
+    prices += o.prices;
+    time_steps += o.time_steps;
+    nodes += o.nodes;
+    exercised_nodes += o.exercised_nodes;
+    allocations += o.allocations;
+    return *this;
+}
+
+// ----------------------------------------------------------------
+// Profiler
+// ----------------------------------------------------------------
+
+Profiler::Profiler(std::size_t max_events)
+    : max_events_(max_events), epoch_ns_(instrument::nowNs()) {}
+
+SolveProfile Profiler::totals() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return totals_;
+}
+
+std::size_t Profiler::events() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_.size();
+}
+
+std::size_t Profiler::droppedEvents() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    totals_ = SolveProfile();
+    events_.clear();
+    dropped_ = 0;
+}
+
+void Profiler::record(const SolveProfile& profile, const std::vector<TraceEvent>& events) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    totals_ += profile;
+    for (const TraceEvent& e : events) {
+        if (events_.size() < max_events_)
+            events_.push_back(e);
+        else
+            ++dropped_;
+    }
+}
+
+void Profiler::writeChromeTrace(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::thread::id, int> tids;
+    auto us = [](std::uint64_t ns) { return static_cast<double>(ns) * 1e-3; };
+    // Nanosecond resolution whatever the offset: at the default six
+    // significant digits, timestamps past ~1 s round to 10 us and more,
+    // and events come out of order.
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (const TraceEvent& e : events_) {
+        int tid = tids.emplace(e.thread, static_cast<int>(tids.size())).first->second;
+        std::uint64_t start = e.start_ns > epoch_ns_ ? e.start_ns - epoch_ns_ : 0;
+        out << (first ? "\n" : ",\n")
+            << "{\"name\":\"" << e.name << "\",\"cat\":\"pde\",\"ph\":\"X\",\"pid\":0"
+            << ",\"tid\":" << tid << ",\"ts\":" << us(start) << ",\"dur\":" << us(e.duration_ns);
+        if (e.steps > 0)
+            out << ",\"args\":{\"steps\":" << e.steps << ",\"solve_us\":" << us(e.solve_ns)
+                << ",\"exercise_us\":" << us(e.exercise_ns) << "}";
+        out << "}";
+        first = false;
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":" << dropped_
+        << "}}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void Profiler::writeChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out)
+        throw std::runtime_error("Profiler: cannot open " + path);
+    writeChromeTrace(out);
+    if (!out)
+        throw std::runtime_error("Profiler: error writing " + path);
+}
@@ -0,0 +1,97 @@
+#include "SetupCache.hpp"
+#include <stdexcept>
+
+// ----------------------------------------------------------------
+// Crank-Nicolson step operator for a fixed dt:
+//
+//   LHS:  I - dt/2 L     RHS:  I + dt/2 L
+// ----------------------------------------------------------------
+
+void SolverSetup::factor(double dt, Elimination order, bool partition,
+                         Precision precision) {
+    int n = static_cast<int>(coeff.a.size());
+    weights.resize(n);
+    lower.resize(n);
+    diag.resize(n);
+    upper.resize(n);
+
+    const double* a = coeff.a.data();
+    const double* b = coeff.b.data();
+    const double* c = coeff.c.data();
+    double* ea = weights.a.data();
+    double* eb = weights.b.data();
+    double* ec = weights.c.data();
+    double h = 0.5 * dt;
+
+    for (int i = 0; i < n; ++i) {
+        lower[i] = -h * a[i];
+        diag[i]  = 1.0 - h * b[i];
+        upper[i] = -h * c[i];
+
+        ea[i] = h * a[i];
+        eb[i] = 1.0 + h * b[i];
+        ec[i] = h * c[i];
+    }
+
+    implicit.factor(lower, diag, upper, order);
+    if (partition && n >= PartitionedTridiagonalLU::kMinRows)
+        partitioned.factor(lower, diag, upper);
+    else
+        partitioned.clear();
+
+    if (precision == Precision::Mixed)
+        implicit_single.factor(lower, diag, upper, order);
+}
+
+// ----------------------------------------------------------------
+// SetupCache
+// ----------------------------------------------------------------
+
+SetupCache::SetupCache(std::size_t capacity) : capacity_(capacity) {
+    if (capacity < 1)
+        throw std::invalid_argument("SetupCache: capacity must be >= 1");
+}
+
+std::shared_ptr<const SolverSetup> SetupCache::find(const SetupKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    ++hits_;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+}
+
+void SetupCache::insert(const SetupKey& key, std::shared_ptr<const SolverSetup> setup) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        it->second->second = std::move(setup);
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+    if (entries_.size() == capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+        ++evictions_;
+    }
+    entries_.emplace_front(key, std::move(setup));
+    index_.emplace(key, entries_.begin());
+}
+
+SetupCacheStats SetupCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {hits_, misses_, evictions_, entries_.size()};
+}
+
+std::size_t SetupCache::capacity() const {
+    return capacity_;
+}
+
+void SetupCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+}
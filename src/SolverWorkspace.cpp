@@ -0,0 +1,25 @@
+#include "SolverWorkspace.hpp"
+#include <cstddef>
+#include <initializer_list>
+
+void SolverWorkspace::reserve(int nodes) {
+    std::size_t n = static_cast<std::size_t>(nodes);
+    for (TridiagonalOperator* op : {&setup.coeff, &setup.weights, &vol_base, &vol_slope}) {
+        op->a.reserve(n);
+        op->b.reserve(n);
+        op->c.reserve(n);
+    }
+    for (std::vector<double>* v : {&setup.lower, &setup.diag, &setup.upper, &rhs,
+                                   &partition_work, &V, &V_prev, &V_prev2, &step_cn,
+                                   &step_ie, &payoff, &iterate, &penalty_diag, &penalty_rhs})
+        v->reserve(n);
+    setup.implicit.reserve(nodes);
+    penalty_lu.reserve(nodes);
+    V_single.reserve(n);
+
+    std::size_t total = n * LaneTridiagonalLU::lanes;
+    for (std::vector<double>* v : {&lanes.ea, &lanes.eb, &lanes.ec, &lanes.lower, &lanes.diag,
+                                   &lanes.upper, &lanes.V, &lanes.rhs})
+        v->reserve(total);
+    lanes.implicit.reserve(nodes);
+}
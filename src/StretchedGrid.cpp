@@ -0,0 +1,157 @@
+#include "Grid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Places M intervals on [0, S_max] so that each covers an equal share of
+// the cumulative density F (F(0) = 0, F' = rho > 0), with every pin
+// strictly inside the domain on a node. Each segment between pins gets a
+// whole number of intervals in proportion to its share of F, so the
+// spacing only changes by a factor 1 + O(1/M) across a pin.
+//
+// The nodes are written to `nodes`, and `work` holds the sorted pins,
+// segment breaks, remainders and interval counts. Both keep their
+// capacity, so repeating a construction of the same size allocates
+// nothing.
+template <class CumDensity, class Density>
+void equidistribute(const CumDensity& F, const Density& rho, double S_max, int M,
+                    const std::vector<double>& pins, std::vector<double>& work,
+                    std::vector<double>& nodes) {
+    std::size_t n_pins = pins.size();
+    work.assign(pins.begin(), pins.end());
+    std::sort(work.begin(), work.end());
+    std::size_t first = n_pins;
+    work.push_back(0.0);
+    for (std::size_t j = 0; j < n_pins; ++j) {
+        double p = work[j];
+        if (p > work.back() && p < S_max)
+            work.push_back(p);
+    }
+    work.push_back(S_max);
+
+    int segments = static_cast<int>(work.size() - first) - 1;
+    if (M < 2 * segments)
+        throw std::invalid_argument("StretchedGrid: too few intervals for the pinned points");
+    work.resize(work.size() + 2 * segments);
+    const double* breaks = work.data() + first;
+    double* remainder = work.data() + first + segments + 1;
+    double* count = remainder + segments;   // whole numbers
+
+    // Largest-remainder apportionment of M intervals, at least 2 per segment.
+    double total = F(S_max);
+    int assigned = 0;
+    for (int s = 0; s < segments; ++s) {
+        double share = M * (F(breaks[s + 1]) - F(breaks[s])) / total;
+        count[s] = std::max(2, static_cast<int>(share));
+        remainder[s] = share - count[s];
+        assigned += static_cast<int>(count[s]);
+    }
+    while (assigned != M) {
+        int step = assigned < M ? 1 : -1;
+        int best = -1;
+        for (int s = 0; s < segments; ++s) {
+            if (step < 0 && count[s] <= 2) continue;
+            if (best < 0 || step * remainder[s] > step * remainder[best]) best = s;
+        }
+        count[best] += step;
+        remainder[best] -= step;
+        assigned += step;
+    }
+
+    // Invert F within each segment by safeguarded Newton.
+    nodes.clear();
+    nodes.reserve(M + 1);
+    for (int s = 0; s < segments; ++s) {
+        double a = breaks[s], b = breaks[s + 1];
+        double Fa = F(a), Fb = F(b);
+        nodes.push_back(a);
+        double x = a;
+        for (int j = 1; j < count[s]; ++j) {
+            double target = Fa + (Fb - Fa) * j / count[s];
+            double lo = x, hi = b;
+            for (int it = 0; it < 100; ++it) {
+                double f = F(x) - target;
+                if (std::abs(f) <= 1e-14 * total || hi - lo <= 1e-14 * b) break;
+                if (f > 0.0) hi = x; else lo = x;
+                double next = x - f / rho(x);
+                x = (next > lo && next < hi) ? next : 0.5 * (lo + hi);
+            }
+            nodes.push_back(x);
+        }
+    }
+    nodes.push_back(S_max);
+}
+
+}  // namespace
+
+// --- SinhGrid ---
+
+SinhGrid::SinhGrid(double S_max, int M, std::vector<double> centres, double alpha)
+    : centres_(std::move(centres)) {
+    build(S_max, M, alpha);
+}
+
+void SinhGrid::assign(double S_max, int M, std::initializer_list<double> centres,
+                      double alpha) {
+    centres_.assign(centres);
+    build(S_max, M, alpha);
+}
+
+void SinhGrid::build(double S_max, int M, double alpha) {
+    if (M < 10 || S_max <= 0.0 || alpha <= 0.0 || centres_.empty())
+        throw std::invalid_argument("SinhGrid: invalid parameters");
+
+    auto F = [&](double S) {
+        double sum = 0.0;
+        for (double c : centres_)
+            sum += std::asinh((S - c) / alpha) - std::asinh(-c / alpha);
+        return alpha * sum;
+    };
+    auto rho = [&](double S) {
+        double sum = 0.0;
+        for (double c : centres_) {
+            double z = (S - c) / alpha;
+            sum += 1.0 / std::sqrt(1.0 + z * z);
+        }
+        return sum;
+    };
+    equidistribute(F, rho, S_max, M, centres_, work_, nodes_);
+}
+
+// --- DensityGrid ---
+
+DensityGrid::DensityGrid(const std::vector<double>& at, const std::vector<double>& density,
+                         int M, std::vector<double> pins) {
+    std::size_t n = at.size();
+    if (M < 10 || n < 2 || density.size() != n || at.front() != 0.0)
+        throw std::invalid_argument("DensityGrid: invalid parameters");
+    for (std::size_t j = 0; j < n; ++j)
+        if (!(density[j] > 0.0) || (j > 0 && at[j] <= at[j - 1]))
+            throw std::invalid_argument("DensityGrid: need increasing points, positive density");
+
+    // Cumulative trapezoid integral at the sample points; within a sample
+    // interval the density is linear, so F is quadratic there.
+    std::vector<double> cum(n, 0.0);
+    for (std::size_t j = 1; j < n; ++j)
+        cum[j] = cum[j - 1] + 0.5 * (density[j - 1] + density[j]) * (at[j] - at[j - 1]);
+
+    auto segment = [&](double S) {
+        auto it = std::upper_bound(at.begin(), at.end(), S);
+        std::size_t j = static_cast<std::size_t>(it - at.begin());
+        return std::min(n - 2, j == 0 ? 0 : j - 1);
+    };
+    auto rho = [&](double S) {
+        std::size_t j = segment(S);
+        double w = (S - at[j]) / (at[j + 1] - at[j]);
+        return (1.0 - w) * density[j] + w * density[j + 1];
+    };
+    auto F = [&](double S) {
+        std::size_t j = segment(S);
+        return cum[j] + 0.5 * (density[j] + rho(S)) * (S - at[j]);
+    };
+    std::vector<double> work;
+    equidistribute(F, rho, at.back(), M, pins, work, nodes_);
+}
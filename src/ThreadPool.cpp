@@ -0,0 +1,177 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+// Pool (if any) whose worker the current thread is, and its index there.
+// Used to run nested parallelFor calls inline instead of deadlocking.
+static thread_local const WorkStealingPool* tls_pool = nullptr;
+static thread_local int tls_worker = 0;
+
+WorkStealingPool::WorkStealingPool(int threads) {
+    if (threads < 0)
+        throw std::invalid_argument("WorkStealingPool: threads must be >= 0");
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    size_ = threads;
+
+    for (int w = 0; w < size_; ++w)
+        ranges_.push_back(std::make_unique<Range>());
+    for (int w = 1; w < size_; ++w)
+        threads_.emplace_back([this, w] { workerLoop(w); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lk(state_mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_)
+        t.join();
+}
+
+int WorkStealingPool::size() const {
+    return size_;
+}
+
+// ----------------------------------------------------------------
+// Loop dispatch
+// ----------------------------------------------------------------
+
+void WorkStealingPool::parallelFor(std::size_t n,
+                                   const std::function<void(std::size_t, int)>& body) {
+    if (n == 0) return;
+
+    if (tls_pool == this || size_ == 1) {
+        int worker = (tls_pool == this) ? tls_worker : 0;
+        for (std::size_t i = 0; i < n; ++i)
+            body(i, worker);
+        return;
+    }
+
+    std::lock_guard<std::mutex> run(run_mutex_);
+
+    // Initial static partition: worker w owns [w*n/P, (w+1)*n/P).
+    for (int w = 0; w < size_; ++w) {
+        std::lock_guard<std::mutex> lk(ranges_[w]->m);
+        ranges_[w]->begin = n * w / size_;
+        ranges_[w]->end   = n * (w + 1) / size_;
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(state_mutex_);
+        body_ = &body;
+        failed_ = false;
+        error_ = nullptr;
+        active_ = size_ - 1;
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    const WorkStealingPool* outer_pool = tls_pool;
+    int outer_worker = tls_worker;
+    tls_pool = this;
+    tls_worker = 0;
+    runWorker(0);
+    tls_pool = outer_pool;
+    tls_worker = outer_worker;
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lk(state_mutex_);
+        done_.wait(lk, [this] { return active_ == 0; });
+        body_ = nullptr;
+        error = error_;
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void WorkStealingPool::workerLoop(int worker) {
+    tls_pool = this;
+    tls_worker = worker;
+    unsigned long seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(state_mutex_);
+            wake_.wait(lk, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        runWorker(worker);
+        {
+            std::lock_guard<std::mutex> lk(state_mutex_);
+            if (--active_ == 0)
+                done_.notify_one();
+        }
+    }
+}
+
+void WorkStealingPool::runWorker(int worker) {
+    const auto& body = *body_;
+    std::size_t index;
+    for (;;) {
+        if (takeOwn(worker, index)) {
+            if (failed_.load(std::memory_order_relaxed))
+                continue;  // drain remaining work after a failure
+            try {
+                body(index, worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(state_mutex_);
+                if (!error_)
+                    error_ = std::current_exception();
+                failed_ = true;
+            }
+            continue;
+        }
+        if (!steal(worker))
+            return;
+    }
+}
+
+// ----------------------------------------------------------------
+// Range operations. At most one range lock is held at a time.
+// ----------------------------------------------------------------
+
+bool WorkStealingPool::takeOwn(int worker, std::size_t& index) {
+    Range& r = *ranges_[worker];
+    std::lock_guard<std::mutex> lk(r.m);
+    if (r.begin >= r.end) return false;
+    index = r.begin++;
+    return true;
+}
+
+bool WorkStealingPool::steal(int thief) {
+    for (;;) {
+        // Pick the victim with the most remaining work.
+        int victim = -1;
+        std::size_t most = 0;
+        for (int w = 0; w < size_; ++w) {
+            if (w == thief) continue;
+            std::lock_guard<std::mutex> lk(ranges_[w]->m);
+            std::size_t left = ranges_[w]->end - ranges_[w]->begin;
+            if (left > most) {
+                most = left;
+                victim = w;
+            }
+        }
+        if (victim < 0) return false;
+
+        std::size_t lo, hi;
+        {
+            Range& v = *ranges_[victim];
+            std::lock_guard<std::mutex> lk(v.m);
+            std::size_t left = v.end - v.begin;
+            if (left == 0) continue;       // drained meanwhile; rescan
+            std::size_t half = (left + 1) / 2;
+            hi = v.end;
+            lo = v.end - half;
+            v.end = lo;
+        }
+        Range& own = *ranges_[thief];
+        std::lock_guard<std::mutex> lk(own.m);
+        own.begin = lo;
+        own.end = hi;
+        return true;
+    }
+}
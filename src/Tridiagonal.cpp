@@ -0,0 +1,389 @@
+#include "Tridiagonal.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define PDE_HAVE_MXCSR 1
+#endif
+
+// ----------------------------------------------------------------
+// Thomas algorithm. The forward sweep stores the eliminated RHS
+// directly in x, so no scratch buffer beyond cp is needed.
+// ----------------------------------------------------------------
+
+void solveTridiagonal(const std::vector<double>& a,
+                      const std::vector<double>& b,
+                      const std::vector<double>& c,
+                      const std::vector<double>& d,
+                      std::vector<double>& x) {
+    int n = static_cast<int>(d.size());
+    std::vector<double> cp(n);
+    x.resize(n);
+
+    cp[0] = c[0] / b[0];
+    x[0] = d[0] / b[0];
+
+    for (int i = 1; i < n; ++i) {
+        double m = 1.0 / (b[i] - a[i] * cp[i - 1]);
+        cp[i] = c[i] * m;
+        x[i] = (d[i] - a[i] * x[i - 1]) * m;
+    }
+
+    for (int i = n - 2; i >= 0; --i)
+        x[i] -= cp[i] * x[i + 1];
+}
+
+// ----------------------------------------------------------------
+// BasicTridiagonalLU. The pivot recurrence runs in double for every
+// Real; a float factorization stores its results rounded once.
+// ----------------------------------------------------------------
+
+template <class Real>
+void BasicTridiagonalLU<Real>::factor(const std::vector<double>& a,
+                                      const std::vector<double>& b,
+                                      const std::vector<double>& c,
+                                      Elimination order) {
+    int n = static_cast<int>(b.size());
+    if (n < 1 || static_cast<int>(a.size()) != n || static_cast<int>(c.size()) != n)
+        throw std::invalid_argument("TridiagonalLU: inconsistent diagonal sizes");
+
+    order_ = order;
+    inv_piv_.resize(n);
+    modified_.resize(n);
+
+    if (order == Elimination::Forward) {
+        // pivot_i = b_i - a_i * u_{i-1},  u_i = c_i / pivot_i
+        couple_.assign(a.begin(), a.end());
+        double ip = 1.0 / b[0], u = c[0] * ip;
+        inv_piv_[0] = static_cast<Real>(ip);
+        modified_[0] = static_cast<Real>(u);
+        for (int i = 1; i < n; ++i) {
+            ip = 1.0 / (b[i] - a[i] * u);
+            u = c[i] * ip;
+            inv_piv_[i] = static_cast<Real>(ip);
+            modified_[i] = static_cast<Real>(u);
+        }
+    } else {
+        // pivot_i = b_i - c_i * l_{i+1},  l_i = a_i / pivot_i
+        couple_.assign(c.begin(), c.end());
+        double ip = 1.0 / b[n - 1], l = a[n - 1] * ip;
+        inv_piv_[n - 1] = static_cast<Real>(ip);
+        modified_[n - 1] = static_cast<Real>(l);
+        for (int i = n - 2; i >= 0; --i) {
+            ip = 1.0 / (b[i] - c[i] * l);
+            l = a[i] * ip;
+            inv_piv_[i] = static_cast<Real>(ip);
+            modified_[i] = static_cast<Real>(l);
+        }
+    }
+}
+
+template <class Real>
+template <bool Project>
+void BasicTridiagonalLU<Real>::sweep(const std::vector<Real>& rhs, const Real* floor,
+                                     std::vector<Real>& x) const {
+    int n = size();
+    x.resize(n);
+
+    if (order_ == Elimination::Forward) {
+        // L y = rhs (rows 0 -> n-1), then U x = y (rows n-1 -> 0)
+        x[0] = rhs[0] * inv_piv_[0];
+        for (int i = 1; i < n; ++i)
+            x[i] = (rhs[i] - couple_[i] * x[i - 1]) * inv_piv_[i];
+    } else {
+        // U y = rhs (rows n-1 -> 0), then L x = y (rows 0 -> n-1)
+        x[n - 1] = rhs[n - 1] * inv_piv_[n - 1];
+        for (int i = n - 2; i >= 0; --i)
+            x[i] = (rhs[i] - couple_[i] * x[i + 1]) * inv_piv_[i];
+    }
+    substitute<Project>(floor, x.data());
+}
+
+template <class Real>
+template <bool Project>
+void BasicTridiagonalLU<Real>::substitute(const Real* floor, Real* x) const {
+    int n = size();
+    const Real* m = modified_.data();
+    if (order_ == Elimination::Forward) {
+        if (Project) x[n - 1] = std::max(x[n - 1], floor[n - 1]);
+        for (int i = n - 2; i >= 0; --i) {
+            x[i] -= m[i] * x[i + 1];
+            if (Project) x[i] = std::max(x[i], floor[i]);
+        }
+    } else {
+        if (Project) x[0] = std::max(x[0], floor[0]);
+        for (int i = 1; i < n; ++i) {
+            x[i] -= m[i] * x[i - 1];
+            if (Project) x[i] = std::max(x[i], floor[i]);
+        }
+    }
+}
+
+template <class Real>
+void BasicTridiagonalLU<Real>::solve(const std::vector<Real>& rhs,
+                                     std::vector<Real>& x) const {
+    sweep<false>(rhs, nullptr, x);
+}
+
+template <class Real>
+void BasicTridiagonalLU<Real>::solveProjected(const std::vector<Real>& rhs,
+                                              const std::vector<Real>& floor,
+                                              std::vector<Real>& x) const {
+    sweep<true>(rhs, floor.data(), x);
+}
+
+template <class Real>
+void BasicTridiagonalLU<Real>::solveProduct(const Real* bl, const Real* bd, const Real* bu,
+                                            const std::vector<Real>& v,
+                                            std::vector<Real>& x) const {
+    int n = size();
+    if (static_cast<int>(v.size()) != n)
+        throw std::invalid_argument("TridiagonalLU: vector size does not match the matrix");
+    x.resize(n);
+    const Real* src = v.data();
+    Real* out = x.data();
+    const Real* cp = couple_.data();
+    const Real* ip = inv_piv_.data();
+
+    // The row being eliminated still needs its neighbours' old values,
+    // which may already be overwritten when x aliases v: carry them.
+    if (n == 1) {
+        out[0] = bd[0] * src[0] * ip[0];
+        return;
+    }
+    if (order_ == Elimination::Forward) {
+        Real v_prev = src[0], v_cur = src[1];
+        out[0] = (bd[0] * v_prev + bu[0] * v_cur) * ip[0];
+        for (int i = 1; i < n - 1; ++i) {
+            Real v_next = src[i + 1];
+            Real r = bl[i] * v_prev + bd[i] * v_cur + bu[i] * v_next;
+            out[i] = (r - cp[i] * out[i - 1]) * ip[i];
+            v_prev = v_cur;
+            v_cur = v_next;
+        }
+        out[n - 1] = (bl[n - 1] * v_prev + bd[n - 1] * v_cur - cp[n - 1] * out[n - 2]) *
+                     ip[n - 1];
+    } else {
+        Real v_next = src[n - 1], v_cur = src[n - 2];
+        out[n - 1] = (bl[n - 1] * v_cur + bd[n - 1] * v_next) * ip[n - 1];
+        for (int i = n - 2; i > 0; --i) {
+            Real v_prev = src[i - 1];
+            Real r = bl[i] * v_prev + bd[i] * v_cur + bu[i] * v_next;
+            out[i] = (r - cp[i] * out[i + 1]) * ip[i];
+            v_next = v_cur;
+            v_cur = v_prev;
+        }
+        out[0] = (bd[0] * v_cur + bu[0] * v_next - cp[0] * out[1]) * ip[0];
+    }
+    substitute<false>(nullptr, out);
+}
+
+template <class Real>
+void BasicTridiagonalLU<Real>::solveColumns(Real* x, std::size_t stride, int count) const {
+    int n = size();
+    const Real* cp = couple_.data();
+    const Real* ip = inv_piv_.data();
+    const Real* m = modified_.data();
+    auto row = [x, stride](int i) { return x + i * stride; };
+    int first = order_ == Elimination::Forward ? 0 : n - 1;
+    int step = order_ == Elimination::Forward ? 1 : -1;
+
+    Real* cur = row(first);
+    for (int l = 0; l < count; ++l)
+        cur[l] *= ip[first];
+    for (int k = 1, i = first + step; k < n; ++k, i += step) {
+        const Real* prev = row(i - step);
+        cur = row(i);
+        for (int l = 0; l < count; ++l)
+            cur[l] = (cur[l] - cp[i] * prev[l]) * ip[i];
+    }
+    for (int k = 1, i = first + (n - 2) * step; k < n; ++k, i -= step) {
+        const Real* next = row(i + step);
+        cur = row(i);
+        for (int l = 0; l < count; ++l)
+            cur[l] -= m[i] * next[l];
+    }
+}
+
+template <class Real>
+void BasicTridiagonalLU<Real>::reserve(int n) {
+    couple_.reserve(n);
+    inv_piv_.reserve(n);
+    modified_.reserve(n);
+}
+
+template <class Real>
+int BasicTridiagonalLU<Real>::size() const {
+    return static_cast<int>(inv_piv_.size());
+}
+
+template class BasicTridiagonalLU<double>;
+template class BasicTridiagonalLU<float>;
+
+// ----------------------------------------------------------------
+// BasicLaneTridiagonalLU
+// ----------------------------------------------------------------
+
+namespace {
+
+// One row of the forward sweep across all lanes:
+//   x[i] = (rhs[i] - lower[i] * x[i-1]) * inv_piv[i]
+inline void forwardRow(const double* rhs, const double* lower, const double* inv_piv,
+                       const double* x_prev, double* x) {
+#if defined(__AVX512F__)
+    __m512d t = _mm512_sub_pd(_mm512_loadu_pd(rhs),
+                              _mm512_mul_pd(_mm512_loadu_pd(lower), _mm512_loadu_pd(x_prev)));
+    _mm512_storeu_pd(x, _mm512_mul_pd(t, _mm512_loadu_pd(inv_piv)));
+#elif defined(__AVX2__)
+    __m256d t = _mm256_sub_pd(_mm256_loadu_pd(rhs),
+                              _mm256_mul_pd(_mm256_loadu_pd(lower), _mm256_loadu_pd(x_prev)));
+    _mm256_storeu_pd(x, _mm256_mul_pd(t, _mm256_loadu_pd(inv_piv)));
+#else
+    for (int l = 0; l < LaneTridiagonalLU::lanes; ++l)
+        x[l] = (rhs[l] - lower[l] * x_prev[l]) * inv_piv[l];
+#endif
+}
+
+inline void forwardRow(const float* rhs, const float* lower, const float* inv_piv,
+                       const float* x_prev, float* x) {
+#if defined(__AVX512F__)
+    __m512 t = _mm512_sub_ps(_mm512_loadu_ps(rhs),
+                             _mm512_mul_ps(_mm512_loadu_ps(lower), _mm512_loadu_ps(x_prev)));
+    _mm512_storeu_ps(x, _mm512_mul_ps(t, _mm512_loadu_ps(inv_piv)));
+#elif defined(__AVX2__)
+    __m256 t = _mm256_sub_ps(_mm256_loadu_ps(rhs),
+                             _mm256_mul_ps(_mm256_loadu_ps(lower), _mm256_loadu_ps(x_prev)));
+    _mm256_storeu_ps(x, _mm256_mul_ps(t, _mm256_loadu_ps(inv_piv)));
+#else
+    for (int l = 0; l < BasicLaneTridiagonalLU<float>::lanes; ++l)
+        x[l] = (rhs[l] - lower[l] * x_prev[l]) * inv_piv[l];
+#endif
+}
+
+// One row of the backward sweep across all lanes:
+//   x[i] -= upper[i] * x[i+1]
+inline void backwardRow(const double* upper, const double* x_next, double* x) {
+#if defined(__AVX512F__)
+    _mm512_storeu_pd(x, _mm512_sub_pd(_mm512_loadu_pd(x),
+                                      _mm512_mul_pd(_mm512_loadu_pd(upper),
+                                                    _mm512_loadu_pd(x_next))));
+#elif defined(__AVX2__)
+    _mm256_storeu_pd(x, _mm256_sub_pd(_mm256_loadu_pd(x),
+                                      _mm256_mul_pd(_mm256_loadu_pd(upper),
+                                                    _mm256_loadu_pd(x_next))));
+#else
+    for (int l = 0; l < LaneTridiagonalLU::lanes; ++l)
+        x[l] -= upper[l] * x_next[l];
+#endif
+}
+
+inline void backwardRow(const float* upper, const float* x_next, float* x) {
+#if defined(__AVX512F__)
+    _mm512_storeu_ps(x, _mm512_sub_ps(_mm512_loadu_ps(x),
+                                      _mm512_mul_ps(_mm512_loadu_ps(upper),
+                                                    _mm512_loadu_ps(x_next))));
+#elif defined(__AVX2__)
+    _mm256_storeu_ps(x, _mm256_sub_ps(_mm256_loadu_ps(x),
+                                      _mm256_mul_ps(_mm256_loadu_ps(upper),
+                                                    _mm256_loadu_ps(x_next))));
+#else
+    for (int l = 0; l < BasicLaneTridiagonalLU<float>::lanes; ++l)
+        x[l] -= upper[l] * x_next[l];
+#endif
+}
+
+}  // namespace
+
+template <class Real>
+void BasicLaneTridiagonalLU<Real>::factor(const std::vector<double>& a,
+                                          const std::vector<double>& b,
+                                          const std::vector<double>& c) {
+    constexpr int W = lanes;
+    std::size_t total = b.size();
+    if (total == 0 || total % W != 0 || a.size() != total || c.size() != total)
+        throw std::invalid_argument("LaneTridiagonalLU: inconsistent diagonal sizes");
+    int n = static_cast<int>(total / W);
+
+    lower_.assign(a.begin(), a.end());
+    inv_piv_.resize(total);
+    upper_.resize(total);
+
+    // The previous row's modified upper diagonal, in double.
+    double u[W];
+    for (int l = 0; l < W; ++l) {
+        double ip = 1.0 / b[l];
+        u[l] = c[l] * ip;
+        inv_piv_[l] = static_cast<Real>(ip);
+        upper_[l] = static_cast<Real>(u[l]);
+    }
+    for (int i = 1; i < n; ++i) {
+        for (int l = 0; l < W; ++l) {
+            int k = i * W + l;
+            double ip = 1.0 / (b[k] - a[k] * u[l]);
+            u[l] = c[k] * ip;
+            inv_piv_[k] = static_cast<Real>(ip);
+            upper_[k] = static_cast<Real>(u[l]);
+        }
+    }
+}
+
+template <class Real>
+void BasicLaneTridiagonalLU<Real>::solve(const std::vector<Real>& rhs,
+                                         std::vector<Real>& x) const {
+    constexpr int W = lanes;
+    int n = size();
+    x.resize(inv_piv_.size());
+    const Real* r = rhs.data();
+    const Real* lo = lower_.data();
+    const Real* ip = inv_piv_.data();
+    const Real* up = upper_.data();
+    Real* xp = x.data();
+
+    for (int l = 0; l < W; ++l)
+        xp[l] = r[l] * ip[l];
+    for (int i = 1; i < n; ++i) {
+        int k = i * W;
+        forwardRow(r + k, lo + k, ip + k, xp + k - W, xp + k);
+    }
+    for (int i = n - 2; i >= 0; --i) {
+        int k = i * W;
+        backwardRow(up + k, xp + k + W, xp + k);
+    }
+}
+
+template <class Real>
+void BasicLaneTridiagonalLU<Real>::reserve(int n) {
+    std::size_t total = static_cast<std::size_t>(n) * lanes;
+    lower_.reserve(total);
+    inv_piv_.reserve(total);
+    upper_.reserve(total);
+}
+
+template <class Real>
+int BasicLaneTridiagonalLU<Real>::size() const {
+    return static_cast<int>(inv_piv_.size() / lanes);
+}
+
+template class BasicLaneTridiagonalLU<double>;
+template class BasicLaneTridiagonalLU<float>;
+
+// ----------------------------------------------------------------
+// FlushDenormals: the FTZ (bit 15) and DAZ (bit 6) flags of MXCSR.
+// ----------------------------------------------------------------
+
+FlushDenormals::FlushDenormals() {
+#if defined(PDE_HAVE_MXCSR)
+    saved_ = _mm_getcsr();
+    _mm_setcsr(saved_ | 0x8040u);
+#endif
+}
+
+FlushDenormals::~FlushDenormals() {
+#if defined(PDE_HAVE_MXCSR)
+    _mm_setcsr(saved_);
+#endif
+}
@@ -0,0 +1,137 @@
+#include "TunedPricer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+TunedPricer::TunedPricer(double abs_tol, double rel_tol)
+    : abs_tol_(abs_tol), rel_tol_(rel_tol), workspace_(std::make_shared<SolverWorkspace>()) {
+    if (abs_tol < 0.0 || rel_tol < 0.0 || (abs_tol == 0.0 && rel_tol == 0.0))
+        throw std::invalid_argument("TunedPricer: need a positive tolerance");
+}
+
+std::size_t TunedPricer::cachedClasses() const {
+    return classes_.size();
+}
+
+std::size_t TunedPricer::searches() const {
+    return searches_;
+}
+
+std::size_t TunedPricer::solvers() const {
+    return solvers_.size();
+}
+
+TunedPricer::ClassKey TunedPricer::classify(const Option& opt) {
+    ClassKey key;
+    key.put = opt.type == OptionType::Put;
+    key.american = opt.exercise == ExerciseType::American;
+    key.moneyness = static_cast<int>(std::lround(std::log(opt.S / opt.K) / 0.1));
+    key.maturity = static_cast<int>(std::floor(std::log2(opt.T * 12.0)));
+    key.vol = static_cast<int>(std::floor(opt.sigma / 0.05));
+    key.scale = static_cast<int>(std::floor(std::log2(opt.K)));
+    return key;
+}
+
+PDESolver& TunedPricer::solverFor(const Resolution& res) {
+    auto it = solvers_.find(res);
+    if (it == solvers_.end()) {
+        PDESolver solver(res.n_space, res.n_time, res.grid);
+        solver.setRannacherSteps(2);
+        solver.setDomainMultiple(res.domain);
+        solver.setWorkspace(workspace_);
+        it = solvers_.emplace(res, std::move(solver)).first;
+    }
+    return it->second;
+}
+
+Resolution TunedPricer::resolutionFor(const Option& option) {
+    ClassKey key = classify(option);
+    auto it = classes_.find(key);
+    if (it != classes_.end())
+        return it->second;
+    Resolution res = search(option);
+    classes_.emplace(key, res);
+    dropUnusedSolvers();
+    return res;
+}
+
+// A search prices up to nine shapes at several levels each; only the
+// levels cached for some class are priced again.
+void TunedPricer::dropUnusedSolvers() {
+    for (auto it = solvers_.begin(); it != solvers_.end();) {
+        bool used = std::any_of(classes_.begin(), classes_.end(), [&](const auto& c) {
+            return !(c.second < it->first) && !(it->first < c.second);
+        });
+        it = used ? std::next(it) : solvers_.erase(it);
+    }
+}
+
+double TunedPricer::price(const Option& option) {
+    return solverFor(resolutionFor(option)).price(option);
+}
+
+TunedPrice TunedPricer::priceWithStatus(const Option& option) {
+    Resolution res = resolutionFor(option);
+    return {solverFor(res).price(option), res.converged};
+}
+
+// ----------------------------------------------------------------
+// Resolution search. For each shape, walk M = kMinSpace, 2*kMinSpace, ...
+// and stop at the first level whose Richardson error estimate is within
+// half the tolerance. The estimate is only trusted once the sequence is
+// in its asymptotic range, i.e. two successive ratios of differences lie
+// between 2 and 8 (4 for a clean second-order expansion); on coarse
+// grids poor prices can agree by accident. A shape is
+// abandoned as soon as its current level already costs more than the
+// best candidate found so far.
+// ----------------------------------------------------------------
+
+Resolution TunedPricer::search(const Option& option) {
+    ++searches_;
+
+    // Truncation at S_max is an error refinement cannot see, so the
+    // domain is sized up front to put S_max kStdDevs of log-spot above K.
+    double domain = std::max(3.0, std::exp(kStdDevs * option.sigma * std::sqrt(option.T)));
+
+    Resolution best{kMaxSpace, kMaxSpace, GridType::SinhRefined, domain, false};
+    double best_cost = std::numeric_limits<double>::infinity();
+
+    for (GridType grid : {GridType::Adaptive, GridType::Sinh, GridType::SinhRefined}) {
+        for (int ratio : {1, 2, 4}) {
+            auto shape = [&](int M) {
+                return Resolution{M, std::max(4, M / ratio), grid, domain};
+            };
+            auto cost = [](const Resolution& r) {
+                double nodes = static_cast<double>(r.n_space) * r.n_time;
+                return r.grid == GridType::SinhRefined ? 1.25 * nodes : nodes;
+            };
+
+            Resolution coarse = shape(kMinSpace);
+            double P_coarse = solverFor(coarse).price(option);
+            double prev_diff = -1.0;
+            int asymptotic = 0;   // consecutive levels converging at ~2nd order
+            while (coarse.n_space * 2 <= kMaxSpace && cost(coarse) < best_cost) {
+                Resolution fine = shape(coarse.n_space * 2);
+                double P_fine = solverFor(fine).price(option);
+                double diff = std::abs(P_fine - P_coarse);
+                double tol = std::max(abs_tol_, rel_tol_ * std::abs(P_fine));
+                bool rate_ok = prev_diff >= 0.0 && diff * 2.0 <= prev_diff &&
+                               diff * 8.0 >= prev_diff;
+                asymptotic = rate_ok ? asymptotic + 1 : 0;
+                if (asymptotic >= 2 && 2.0 * (4.0 / 3.0) * diff <= tol) {
+                    best = coarse;
+                    best_cost = cost(coarse);
+                    break;
+                }
+                coarse = fine;
+                P_coarse = P_fine;
+                prev_diff = diff;
+            }
+        }
+    }
+    // If no shape met the tolerance within kMaxSpace, best stays at the
+    // finest refined resolution, marked unconverged.
+    return best;
+}
@@ -1,11 +1,23 @@
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
 #include "Option.hpp"
 #include "PDESolver.hpp"
 #include "BlackScholes.hpp"
+#include "BatchFile.hpp"
+#include "BatchPipeline.hpp"
+#ifdef PDE_HAVE_SOCKETS
+#include <csignal>
+#include <pthread.h>
+#include "PricingClient.hpp"
+#include "PricingServer.hpp"
+#endif
 
-int main() {
+static int runDemo() {
     std::cout << "Adaptive PDE Options Pricer\n";
     std::cout << "============================\n\n";
     std::cout << std::fixed << std::setprecision(6);
@@ -55,3 +67,279 @@ int main() {
 
     return 0;
 }
+
+static void usage() {
+    std::cerr <<
+        "usage: pde_pricer                      three demo prices\n"
+        "       pde_pricer batch <input> [options]\n"
+        "           -o <file>         output (default: stdout)\n"
+        "           --threads <n>     pricing threads (default: all cores)\n"
+        "           --grid <type>     uniform, adaptive, sinh, sinh-refined,\n"
+        "                             log-uniform, log-sinh (default: sinh)\n"
+        "           --space <M>       space intervals (default: 200)\n"
+        "           --time <N>        time steps (default: 200)\n"
+        "           --chunk <KiB>     input per chunk (default: 1024)\n"
+        "           --depth <n>       chunks queued for output (default: 2)\n"
+        "       pde_pricer convert <input> <output>\n"
+        "           rewrites an option file; .csv output is CSV, any other binary\n"
+        "       pde_pricer serve (--unix <path> | --tcp <port>)... [options]\n"
+        "           --threads, --grid, --space, --time as for batch\n"
+        "           --batch <n>       requests per micro-batch (default: 64)\n"
+        "           --window <us>     wait for a batch to fill (default: 100)\n"
+        "           --queue <n>       queued requests before Overloaded (default: 65536)\n"
+        "           --outbound <n>    unread reply bytes before a client is dropped\n"
+        "                             (default: 1048576)\n"
+        "       pde_pricer loadgen (--unix <path> | --tcp <port>) [options]\n"
+        "           --connections <n> client connections (default: 4)\n"
+        "           --in-flight <n>   outstanding requests per connection (default: 16)\n"
+        "           --requests <n>    total requests (default: 10000)\n"
+        "           --deadline <us>   per-request deadline (default: none)\n"
+        "           --american <f>    fraction of American options (default: 0.2)\n";
+}
+
+static GridType parseGrid(const std::string& name) {
+    const char* names[] = {"uniform", "adaptive", "sinh", "sinh-refined", "log-uniform", "log-sinh"};
+    const GridType types[] = {GridType::Uniform, GridType::Adaptive, GridType::Sinh,
+                              GridType::SinhRefined, GridType::LogUniform, GridType::LogSinh};
+    for (int i = 0; i < 6; ++i)
+        if (name == names[i])
+            return types[i];
+    throw std::invalid_argument("unknown grid type '" + name + "'");
+}
+
+// pde_pricer batch: prices go to the output, the summary to stderr.
+static int runBatch(int argc, char** argv) {
+    if (argc < 3) {
+        usage();
+        return 2;
+    }
+    std::string input = argv[2], output;
+    int threads = 0, M = 200, N = 200, depth = 2;
+    std::size_t chunk_kib = 1024;
+    GridType grid = GridType::Sinh;
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        std::string value = argv[++i];
+        if (arg == "-o")
+            output = value;
+        else if (arg == "--threads")
+            threads = std::stoi(value);
+        else if (arg == "--grid")
+            grid = parseGrid(value);
+        else if (arg == "--space")
+            M = std::stoi(value);
+        else if (arg == "--time")
+            N = std::stoi(value);
+        else if (arg == "--chunk")
+            chunk_kib = std::stoul(value);
+        else if (arg == "--depth")
+            depth = std::stoi(value);
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    PDESolver prototype(M, N, grid);
+    prototype.setRannacherSteps(2);
+    prototype.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+    BatchPipeline pipeline(prototype, threads);
+    pipeline.setChunkBytes(chunk_kib * 1024);
+    pipeline.setQueueDepth(depth);
+
+    std::FILE* out = stdout;
+    if (!output.empty() && !(out = std::fopen(output.c_str(), "wb")))
+        throw std::runtime_error("cannot create " + output);
+    PipelineStats stats;
+    try {
+        stats = pipeline.run(input, out);
+    } catch (...) {
+        if (out != stdout)
+            std::fclose(out);
+        throw;
+    }
+    if (out != stdout && std::fclose(out) != 0)
+        throw std::runtime_error("cannot write " + output);
+
+    std::cerr << std::fixed << std::setprecision(3)
+              << "priced " << stats.records << " options in " << stats.seconds << " s: "
+              << std::setprecision(0) << stats.optionsPerSecond() << " options/s on "
+              << pipeline.threads() << " threads\n"
+              << std::setprecision(3) << "  parse " << stats.parse_seconds
+              << " s, price " << stats.price_seconds << " s, format " << stats.format_seconds
+              << " s, output stall " << stats.stall_seconds << " s\n";
+    if (stats.rejected > 0)
+        std::cerr << "  " << stats.rejected << " rows rejected (priced nan); first: "
+                  << stats.first_error << "\n";
+    return 0;
+}
+
+static int runConvert(int argc, char** argv) {
+    if (argc != 4) {
+        usage();
+        return 2;
+    }
+    std::string output = argv[3];
+    bool csv = output.size() >= 4 && output.compare(output.size() - 4, 4, ".csv") == 0;
+    std::vector<Option> options = readOptionFile(argv[2]);
+    writeOptionFile(output, options, csv ? BatchFormat::CSV : BatchFormat::Binary);
+    std::cerr << "wrote " << options.size() << " options to " << output << "\n";
+    return 0;
+}
+
+#ifdef PDE_HAVE_SOCKETS
+// pde_pricer serve: runs until SIGINT or SIGTERM, then prints its stats.
+static int runServe(int argc, char** argv) {
+    std::vector<std::string> unix_paths;
+    std::vector<int> tcp_ports;
+    int M = 200, N = 200;
+    GridType grid = GridType::Sinh;
+    ServerConfig config;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        std::string value = argv[++i];
+        if (arg == "--unix")
+            unix_paths.push_back(value);
+        else if (arg == "--tcp")
+            tcp_ports.push_back(std::stoi(value));
+        else if (arg == "--threads")
+            config.threads = std::stoi(value);
+        else if (arg == "--grid")
+            grid = parseGrid(value);
+        else if (arg == "--space")
+            M = std::stoi(value);
+        else if (arg == "--time")
+            N = std::stoi(value);
+        else if (arg == "--batch")
+            config.max_batch = std::stoul(value);
+        else if (arg == "--window")
+            config.batch_window = std::chrono::microseconds(std::stol(value));
+        else if (arg == "--queue")
+            config.max_queue = std::stoul(value);
+        else if (arg == "--outbound")
+            config.max_outbound = std::stoul(value);
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (unix_paths.empty() && tcp_ports.empty()) {
+        usage();
+        return 2;
+    }
+
+    // Server threads inherit the mask, so the signals reach sigwait below.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    PDESolver prototype(M, N, grid);
+    prototype.setRannacherSteps(2);
+    prototype.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+    PricingServer server(prototype, config);
+    for (const std::string& path : unix_paths) {
+        server.listenUnix(path);
+        std::cerr << "listening on " << path << "\n";
+    }
+    for (int port : tcp_ports)
+        std::cerr << "listening on 127.0.0.1:" << server.listenTcp(port) << "\n";
+
+    int sig = 0;
+    sigwait(&signals, &sig);
+    server.stop();
+    std::cerr << server.stats().toJson() << "\n";
+    return 0;
+}
+
+// pde_pricer loadgen: a closed-loop client over a synthetic book.
+static int runLoadgen(int argc, char** argv) {
+    LoadConfig config;
+    double american = 0.2;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        std::string value = argv[++i];
+        if (arg == "--unix")
+            config.unix_path = value;
+        else if (arg == "--tcp")
+            config.port = std::stoi(value);
+        else if (arg == "--connections")
+            config.connections = std::stoi(value);
+        else if (arg == "--in-flight")
+            config.in_flight = std::stoi(value);
+        else if (arg == "--requests")
+            config.requests = std::stoul(value);
+        else if (arg == "--deadline")
+            config.deadline_us = static_cast<std::uint32_t>(std::stoul(value));
+        else if (arg == "--american")
+            american = std::stod(value);
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (config.unix_path.empty() && config.port == 0) {
+        usage();
+        return 2;
+    }
+
+    // 1000 contracts: strikes 80..120, maturities 3M..2Y, vols 15%..45%.
+    std::vector<Option> book;
+    for (int i = 0; i < 1000; ++i) {
+        bool am = (i * 0.618034 - std::floor(i * 0.618034)) < american;
+        book.emplace_back(100.0, 80.0 + (i * 7) % 41, 0.25 * (1 + i % 8), 0.03,
+                          0.15 + 0.01 * (i % 31), i % 2 ? OptionType::Call : OptionType::Put,
+                          am ? ExerciseType::American : ExerciseType::European);
+    }
+    LoadReport report = runLoad(config, book);
+    std::cout << std::fixed << std::setprecision(0)
+              << report.requestsPerSecond() << " requests/s over " << config.connections
+              << " connections x " << config.in_flight << " in flight\n"
+              << std::setprecision(1) << "latency us: p50 " << report.latency.percentile(0.5) * 1e-3
+              << ", p99 " << report.latency.percentile(0.99) * 1e-3 << ", p999 "
+              << report.latency.percentile(0.999) * 1e-3 << ", max "
+              << report.latency.max() * 1e-3 << "\n"
+              << "ok " << report.ok << ", invalid " << report.invalid << ", expired "
+              << report.expired << ", overloaded " << report.overloaded << "\n";
+    PricingClient client = config.unix_path.empty()
+                               ? PricingClient(config.host, config.port)
+                               : PricingClient(config.unix_path);
+    std::cout << "server: " << client.stats() << "\n";
+    return 0;
+}
+#endif
+
+int main(int argc, char** argv) {
+    try {
+        if (argc == 1)
+            return runDemo();
+        if (std::strcmp(argv[1], "batch") == 0)
+            return runBatch(argc, argv);
+        if (std::strcmp(argv[1], "convert") == 0)
+            return runConvert(argc, argv);
+#ifdef PDE_HAVE_SOCKETS
+        if (std::strcmp(argv[1], "serve") == 0)
+            return runServe(argc, argv);
+        if (std::strcmp(argv[1], "loadgen") == 0)
+            return runLoadgen(argc, argv);
+#endif
+        usage();
+        return 2;
+    } catch (const std::exception& e) {
+        std::cerr << "pde_pricer: " << e.what() << "\n";
+        return 1;
+    }
+}
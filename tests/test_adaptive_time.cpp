@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "Option.hpp"
+#include "PDESolver.hpp"
+
+// Fixed-step Rannacher + Crank-Nicolson with very fine steps on the same
+// spatial grid: isolates the time-discretization error.
+static double fineReference(const Option& opt, int n_space, GridType grid) {
+    PDESolver ref(n_space, 20000, grid);
+    ref.setRannacherSteps(2);
+    return ref.price(opt);
+}
+
+TEST(AdaptiveTime, DefaultIsFixedSteps) {
+    Option opt(100, 100, 1.0, 0.05, 0.2, OptionType::Put);
+    PDESolver solver(100, 80, true);
+    EXPECT_EQ(solver.timeTolerance(), 0.0);
+    EXPECT_THROW(solver.setTimeTolerance(-1e-4), std::invalid_argument);
+    EXPECT_THROW(solver.setTimeTolerance(std::nan("")), std::invalid_argument);
+
+    solver.priceEuropean(opt);
+    SolveStats stats = solver.lastSolveStats();
+    EXPECT_EQ(stats.steps, 80);
+    EXPECT_EQ(stats.rejected, 0);
+    EXPECT_EQ(stats.factorizations, 1);
+}
+
+TEST(AdaptiveTime, EuropeanWithinTolerance) {
+    for (double T : {0.25, 1.0, 5.0}) {
+        Option opt(100, 100, T, 0.05, 0.2, OptionType::Put);
+        double ref = fineReference(opt, 200, GridType::Sinh);
+
+        PDESolver solver(200, 1, GridType::Sinh);
+        solver.setTimeTolerance(1e-4);
+        EXPECT_NEAR(solver.priceEuropean(opt), ref, 1e-3) << "T = " << T;
+    }
+}
+
+TEST(AdaptiveTime, UnreachableToleranceThrows) {
+    Option opt(100, 100, 1.0, 0.05, 0.2, OptionType::Put);
+    PDESolver solver(50, 1, GridType::Sinh);
+    solver.setTimeTolerance(1e-300);
+    EXPECT_THROW(solver.priceEuropean(opt), std::runtime_error);
+
+    solver.setTimeTolerance(1e-4);   // usable again afterwards
+    EXPECT_GT(solver.priceEuropean(opt), 0.0);
+}
+
+TEST(AdaptiveTime, RefactorsOnlyWhenStepChanges) {
+    Option opt(100, 100, 1.0, 0.05, 0.2, OptionType::Call);
+    PDESolver solver(200, 1, GridType::Sinh);
+    solver.setTimeTolerance(1e-5);
+    solver.priceEuropean(opt);
+
+    SolveStats stats = solver.lastSolveStats();
+    EXPECT_GT(stats.steps, 20);
+    EXPECT_LE(stats.factorizations, stats.steps / 2);
+    EXPECT_LE(stats.factorizations, 1 + 2 * stats.rejected + stats.steps);
+}
+
+TEST(AdaptiveTime, LongDatedNeedsFewSteps) {
+    // Ten years: the controller spends its steps near expiry. Plain
+    // Crank-Nicolson with the same number of uniform steps rings at the
+    // kink and is far less accurate.
+    Option opt(100, 100, 10.0, 0.05, 0.2, OptionType::Put);
+    double ref = fineReference(opt, 200, GridType::Sinh);
+
+    PDESolver adaptive(200, 1, GridType::Sinh);
+    adaptive.setTimeTolerance(1e-3);
+    double adaptive_err = std::abs(adaptive.priceEuropean(opt) - ref);
+    int steps = adaptive.lastSolveStats().steps;
+    EXPECT_LT(steps, 40);
+    EXPECT_LT(adaptive_err, 1e-2);
+
+    PDESolver fixed(200, steps, GridType::Sinh);
+    EXPECT_GT(std::abs(fixed.priceEuropean(opt) - ref), 10.0 * adaptive_err);
+}
+
+TEST(AdaptiveTime, AmericanMatchesReference) {
+    Option am(100, 100, 1.0, 0.05, 0.20, OptionType::Put, ExerciseType::American);
+    for (AmericanMethod method : {AmericanMethod::Projection,
+                                  AmericanMethod::BrennanSchwartz}) {
+        PDESolver solver(200, 1, true);
+        solver.setAmericanMethod(method);
+        solver.setTimeTolerance(1e-4);
+        EXPECT_NEAR(solver.priceAmerican(am), 6.0904, 0.03);
+    }
+}
+
+TEST(AdaptiveTime, ThetaFromUnequalSteps) {
+    Option opt(100, 100, 1.0, 0.05, 0.2, OptionType::Put);
+    PDESolver ref(200, 4000, GridType::Sinh);
+    ref.setRannacherSteps(2);
+    double theta_ref = ref.priceWithGreeks(opt).theta;
+
+    PDESolver solver(200, 1, GridType::Sinh);
+    solver.setTimeTolerance(1e-5);
+    EXPECT_NEAR(solver.priceWithGreeks(opt).theta, theta_ref, 1e-3);
+}
+
+TEST(AdaptiveTime, BatchMatchesScalar) {
+    std::vector<Option> book;
+    for (int k = 0; k < 6; ++k)
+        book.emplace_back(90 + 4 * k, 100, 2.0, 0.05, 0.2,
+                          k % 2 ? OptionType::Put : OptionType::Call);
+    PDESolver solver(100, 1, true);
+    solver.setTimeTolerance(1e-4);
+    std::vector<double> out(book.size());
+    solver.priceEuropeanBatch(book.data(), book.size(), out.data());
+    for (std::size_t i = 0; i < book.size(); ++i)
+        EXPECT_DOUBLE_EQ(out[i], solver.priceEuropean(book[i]));
+}
@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "Option.hpp"
+#include "PDESolver.hpp"
+#include "Profiler.hpp"
+
+// SolveProfile::allocations through pde_alloc_counter's operator new.
+// Built only with -DPDE_INSTRUMENT=ON, as pde_instrument_tests: the
+// replacement cannot share a binary with test_allocation.cpp's.
+
+TEST(AllocationCounter, CountsCallingThread) {
+    std::uint64_t before = instrument::threadAllocations();
+    int* volatile p = new int(1);
+    delete p;
+    EXPECT_EQ(instrument::threadAllocations() - before, 1u);
+}
+
+// The first price sizes the workspace; once warm, prices allocate nothing.
+TEST(AllocationCounter, WarmSolverAllocatesNothing) {
+    Option call(100, 100, 1.0, 0.05, 0.2, OptionType::Call);
+    Option put(100, 105, 0.5, 0.03, 0.3, OptionType::Put, ExerciseType::American);
+    PDESolver solver(200, 100, true);
+
+    solver.priceEuropean(call);
+    EXPECT_GT(solver.lastProfile().allocations, 0u);
+    solver.priceEuropean(call);
+    EXPECT_EQ(solver.lastProfile().allocations, 0u);
+
+    solver.priceAmerican(put);
+    solver.priceAmerican(put);
+    EXPECT_EQ(solver.lastProfile().allocations, 0u);
+}
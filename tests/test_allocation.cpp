@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "Option.hpp"
+#include "PDESolver.hpp"
+#include "Tridiagonal.hpp"
+
+// Global allocation counter. Replacing operator new affects the whole
+// test binary, so it only counts; tests read the delta around the code
+// under test.
+static std::atomic<long> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+template <class F>
+static long countAllocations(F&& f) {
+    long before = g_allocations.load();
+    f();
+    return g_allocations.load() - before;
+}
+
+// --- Time loop does not allocate ---
+
+// Allocations per price must not depend on the number of time steps:
+// everything the backward sweep touches is sized once per price.
+TEST(Allocation, EuropeanIndependentOfTimeSteps) {
+    Option opt(100, 100, 1.0, 0.05, 0.20, OptionType::Call);
+    PDESolver few(200, 20, true);
+    PDESolver many(200, 2000, true);
+    few.priceEuropean(opt);   // warm up workspaces
+    many.priceEuropean(opt);
+
+    long a_few  = countAllocations([&] { few.priceEuropean(opt); });
+    long a_many = countAllocations([&] { many.priceEuropean(opt); });
+    EXPECT_EQ(a_few, a_many);
+}
+
+TEST(Allocation, AmericanIndependentOfTimeSteps) {
+    Option opt(100, 100, 1.0, 0.05, 0.20, OptionType::Put, ExerciseType::American);
+    PDESolver few(200, 20, true);
+    PDESolver many(200, 2000, true);
+    few.priceAmerican(opt);
+    many.priceAmerican(opt);
+
+    long a_few  = countAllocations([&] { few.priceAmerican(opt); });
+    long a_many = countAllocations([&] { many.priceAmerican(opt); });
+    EXPECT_EQ(a_few, a_many);
+}
+
+// --- Pre-factored solve ---
+
+TEST(Allocation, FactoredSolveIsAllocationFree) {
+    int n = 64;
+    std::vector<double> a(n, -1.0), b(n, 4.0), c(n, -1.0), x(n, 1.0), rhs(n, 1.0);
+    TridiagonalLU lu;
+    lu.factor(a, b, c);
+    long count = countAllocations([&] {
+        for (int k = 0; k < 100; ++k) lu.solve(rhs, x);
+    });
+    EXPECT_EQ(count, 0);
+}
+
+// --- Workspace reuse ---
+
+// Once a solver has priced at its largest grid, further prices make no
+// heap calls at all: grid, operator, LHS and solution levels are rebuilt
+// in the workspace.
+TEST(Allocation, RepeatedPricesAllocateNothing) {
+    std::vector<Option> book;
+    for (int k = 0; k < 20; ++k)
+        book.emplace_back(70.0 + 3.0 * k, 90.0 + 5.0 * (k % 5), 0.25 + 0.1 * k, 0.05, 0.25,
+                          k % 2 ? OptionType::Put : OptionType::Call,
+                          k % 3 ? ExerciseType::European : ExerciseType::American);
+
+    for (GridType grid : {GridType::Uniform, GridType::Adaptive, GridType::Sinh}) {
+        for (AmericanMethod method : {AmericanMethod::Projection, AmericanMethod::BrennanSchwartz,
+                                      AmericanMethod::Penalty, AmericanMethod::PSOR}) {
+            PDESolver solver(100, 50, grid);
+            solver.setAmericanMethod(method);
+            solver.setRannacherSteps(2);
+            for (const Option& opt : book) {   // warm up
+                solver.price(opt);
+                solver.priceWithGreeks(opt);
+            }
+            long count = countAllocations([&] {
+                for (const Option& opt : book) {
+                    solver.price(opt);
+                    solver.priceWithGreeks(opt);
+                }
+            });
+            EXPECT_EQ(count, 0) << static_cast<int>(grid) << " " << static_cast<int>(method);
+        }
+    }
+}
+
+TEST(Allocation, AdaptiveTimeAndLanesAllocateNothing) {
+    std::vector<Option> book;
+    for (int k = 0; k < 16; ++k)
+        book.emplace_back(80.0 + 2.5 * k, 100, 0.5 + 0.05 * k, 0.05, 0.2, OptionType::Put);
+    std::vector<double> out(book.size());
+
+    PDESolver adaptive(100, 1, GridType::Sinh);
+    adaptive.setTimeTolerance(1e-4);
+    PDESolver lanes(100, 50, GridType::Uniform);
+    for (const Option& opt : book)
+        adaptive.priceEuropean(opt);
+    lanes.priceEuropeanBatch(book.data(), book.size(), out.data());
+
+    EXPECT_EQ(countAllocations([&] {
+        for (const Option& opt : book)
+            adaptive.priceEuropean(opt);
+    }), 0);
+    EXPECT_EQ(countAllocations([&] {
+        lanes.priceEuropeanBatch(book.data(), book.size(), out.data());
+    }), 0);
+}
+
+// Solvers sharing a reserved workspace price exactly as with their own,
+// and switching between them allocates nothing.
+TEST(Allocation, SharedWorkspace) {
+    Option put(100, 100, 1.0, 0.05, 0.2, OptionType::Put, ExerciseType::American);
+    Option call(110, 100, 0.5, 0.03, 0.3, OptionType::Call);
+    PDESolver coarse(100, 100, GridType::Sinh), fine(400, 400, GridType::Adaptive);
+    PDESolver coarse_own(coarse), fine_own(fine);
+
+    auto workspace = std::make_shared<SolverWorkspace>();
+    workspace->reserve(401);
+    coarse.setWorkspace(workspace);
+    fine.setWorkspace(workspace);
+    EXPECT_EQ(coarse.workspace(), fine.workspace());
+    EXPECT_NE(PDESolver(coarse).workspace(), workspace);   // copies get their own
+
+    EXPECT_DOUBLE_EQ(coarse.price(put), coarse_own.price(put));
+    EXPECT_DOUBLE_EQ(fine.price(put), fine_own.price(put));
+    EXPECT_DOUBLE_EQ(coarse.price(call), coarse_own.price(call));
+    EXPECT_DOUBLE_EQ(fine.price(call), fine_own.price(call));
+    long count = countAllocations([&] {
+        for (int k = 0; k < 10; ++k) {
+            coarse.price(k % 2 ? put : call);
+            fine.price(k % 2 ? call : put);
+        }
+    });
+    EXPECT_EQ(count, 0);
+
+    fine.setWorkspace(nullptr);
+    EXPECT_NE(fine.workspace(), workspace);
+    EXPECT_NE(fine.workspace(), nullptr);
+}
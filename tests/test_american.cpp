@@ -74,3 +74,60 @@ TEST(American, HighRatePut) {
     // Premium should be strictly positive at high rates.
     EXPECT_GT(am_price, eu_price + 0.01);
 }
+
+// --- Early-exercise methods ---
+
+static const AmericanMethod kMethods[] = {
+    AmericanMethod::Projection, AmericanMethod::BrennanSchwartz,
+    AmericanMethod::Penalty, AmericanMethod::PSOR};
+
+TEST(AmericanMethods, DefaultIsProjection) {
+    PDESolver solver(100, 100, true);
+    EXPECT_EQ(solver.americanMethod(), AmericanMethod::Projection);
+}
+
+TEST(AmericanMethods, AllMatchReferencePut) {
+    // Reference value 6.0904 (binomial, 10000 steps).
+    Option am(100, 100, 1.0, 0.05, 0.20, OptionType::Put, ExerciseType::American);
+    for (AmericanMethod m : kMethods) {
+        PDESolver solver(200, 200, true);
+        solver.setAmericanMethod(m);
+        EXPECT_NEAR(solver.priceAmerican(am), 6.0904, 0.01)
+            << "method " << static_cast<int>(m);
+    }
+}
+
+TEST(AmericanMethods, LCPSolversAgree) {
+    // Brennan-Schwartz, penalty and PSOR all solve the same discrete LCP.
+    Option am(90, 100, 1.0, 0.08, 0.30, OptionType::Put, ExerciseType::American);
+    PDESolver solver(200, 200, true);
+    solver.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+    double bs = solver.priceAmerican(am);
+    solver.setAmericanMethod(AmericanMethod::Penalty);
+    EXPECT_NEAR(solver.priceAmerican(am), bs, 1e-6);
+    solver.setAmericanMethod(AmericanMethod::PSOR);
+    EXPECT_NEAR(solver.priceAmerican(am), bs, 1e-6);
+}
+
+TEST(AmericanMethods, BoundsHoldForAllMethods) {
+    Option am(80, 100, 1.0, 0.05, 0.20, OptionType::Put, ExerciseType::American);
+    Option eu(80, 100, 1.0, 0.05, 0.20, OptionType::Put, ExerciseType::European);
+    for (AmericanMethod m : kMethods) {
+        PDESolver solver(200, 200, true);
+        solver.setAmericanMethod(m);
+        double price = solver.priceAmerican(am);
+        EXPECT_GE(price, solver.priceEuropean(eu));
+        EXPECT_GE(price, am.payoff(am.S) - 1e-6);
+    }
+}
+
+TEST(AmericanMethods, CallsUnaffected) {
+    // No early exercise for calls without dividends, whatever the method.
+    Option am(100, 100, 1.0, 0.05, 0.20, OptionType::Call, ExerciseType::American);
+    Option eu(100, 100, 1.0, 0.05, 0.20, OptionType::Call, ExerciseType::European);
+    for (AmericanMethod m : kMethods) {
+        PDESolver solver(200, 200, true);
+        solver.setAmericanMethod(m);
+        EXPECT_NEAR(solver.priceAmerican(am), solver.priceEuropean(eu), TOL);
+    }
+}
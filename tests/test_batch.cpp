@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "BatchPricer.hpp"
+#include "ThreadPool.hpp"
+
+static std::vector<Option> makeBook() {
+    std::vector<Option> book;
+    for (int i = 0; i < 40; ++i) {
+        double S = 70.0 + 1.5 * i;
+        OptionType type = (i % 2 == 0) ? OptionType::Call : OptionType::Put;
+        ExerciseType ex = (i % 3 == 0) ? ExerciseType::American : ExerciseType::European;
+        book.emplace_back(S, 100.0, 0.5 + 0.05 * i, 0.05, 0.2, type, ex);
+    }
+    return book;
+}
+
+// --- Work-stealing pool ---
+
+TEST(ThreadPool, EveryIndexRunsOnce) {
+    WorkStealingPool pool(4);
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallelFor(hits.size(), [&](std::size_t i, int worker) {
+        EXPECT_GE(worker, 0);
+        EXPECT_LT(worker, pool.size());
+        // Skewed cost so that stealing actually happens.
+        volatile double x = 0.0;
+        for (std::size_t k = 0; k < (i < 100 ? 20000u : 10u); ++k) x += k;
+        hits[i].fetch_add(1);
+    });
+    for (auto& h : hits)
+        EXPECT_EQ(h.load(), 1);
+}
+
+TEST(ThreadPool, PropagatesException) {
+    WorkStealingPool pool(3);
+    EXPECT_THROW(pool.parallelFor(100, [](std::size_t i, int) {
+        if (i == 57) throw std::runtime_error("boom");
+    }), std::runtime_error);
+
+    // The pool stays usable after a failed loop.
+    std::atomic<int> count{0};
+    pool.parallelFor(10, [&](std::size_t, int) { ++count; });
+    EXPECT_EQ(count.load(), 10);
+}
+
+// --- Batch pricing ---
+
+TEST(BatchPricer, MatchesSerialPricing) {
+    auto book = makeBook();
+    PDESolver serial(100, 100, true);
+    BatchPricer pricer(serial, 4);
+    auto prices = pricer.priceBatch(book);
+    ASSERT_EQ(prices.size(), book.size());
+    for (std::size_t i = 0; i < book.size(); ++i)
+        EXPECT_EQ(prices[i], serial.price(book[i]));
+}
+
+TEST(BatchPricer, DeterministicAcrossThreadCounts) {
+    auto book = makeBook();
+    PDESolver prototype(100, 100, false);
+    auto one  = BatchPricer(prototype, 1).priceBatch(book);
+    auto many = BatchPricer(prototype, 7).priceBatch(book);
+    for (std::size_t i = 0; i < book.size(); ++i)
+        EXPECT_EQ(one[i], many[i]);
+}
+
+TEST(BatchPricer, EmptyBatch) {
+    BatchPricer pricer(PDESolver(100, 100, true), 2);
+    EXPECT_TRUE(pricer.priceBatch(std::vector<Option>{}).empty());
+}
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "BatchFile.hpp"
+#include "BatchPipeline.hpp"
+#include "BatchPricer.hpp"
+#include "PDESolver.hpp"
+
+static std::string tempPath(const std::string& name) {
+    return ::testing::TempDir() + "pde_batch_" + name;
+}
+
+static void writeText(const std::string& path, const std::string& text) {
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+static bool parse(const std::string& line, OptionRecord& rec) {
+    return batchfile::parseCsvLine(line.data(), line.data() + line.size(), rec);
+}
+
+static std::vector<Option> book(int count) {
+    std::vector<Option> options;
+    for (int i = 0; i < count; ++i)
+        options.emplace_back(100.0, 70.0 + (i * 7) % 61, 0.25 + 0.05 * (i % 20), 0.03,
+                             0.15 + 0.01 * (i % 30), i % 2 ? OptionType::Call : OptionType::Put,
+                             i % 3 ? ExerciseType::European : ExerciseType::American);
+    return options;
+}
+
+// Runs the pipeline into a temporary file and returns the output text.
+static std::string runPipeline(BatchPipeline& pipeline, const std::string& input,
+                               PipelineStats& stats) {
+    std::FILE* out = std::tmpfile();
+    stats = pipeline.run(input, out);
+    std::string text(std::ftell(out), '\0');
+    std::rewind(out);
+    EXPECT_EQ(std::fread(&text[0], 1, text.size(), out), text.size());
+    std::fclose(out);
+    return text;
+}
+
+TEST(BatchFile, CsvLines) {
+    OptionRecord rec;
+    ASSERT_TRUE(parse(" 100, 95.5 ,0.5,0.03,0.2, put ,A\r", rec));
+    EXPECT_EQ(rec.error, nullptr);
+    EXPECT_EQ(rec.K, 95.5);
+    EXPECT_EQ(rec.type, OptionType::Put);
+    EXPECT_EQ(rec.exercise, ExerciseType::American);
+
+    ASSERT_TRUE(parse("100,100,1,0.05,0.2,c", rec));
+    EXPECT_EQ(rec.error, nullptr);
+    EXPECT_EQ(rec.type, OptionType::Call);
+    EXPECT_EQ(rec.exercise, ExerciseType::European);
+
+    EXPECT_FALSE(parse("", rec));
+    EXPECT_FALSE(parse("  \r", rec));
+    EXPECT_FALSE(parse("# S,K,T", rec));
+
+    for (const char* bad : {"100,100,1,0.05,0.2", "100,100,1,0.05,0.2,C,E,x",
+                            "100,1e,1,0.05,0.2,C", "100,100,1,0.05,nan,C",
+                            "100,100,1,0.05,0.2,X", "100,100,1,0.05,0.2,C,Bermudan"}) {
+        ASSERT_TRUE(parse(bad, rec)) << bad;
+        EXPECT_NE(rec.error, nullptr) << bad;
+    }
+}
+
+TEST(BatchFile, CsvHeader) {
+    std::uint64_t lines = 0;
+    std::string with = "# book\n\nS,K,T,r,sigma,type\n100,100,1,0.05,0.2,C\n";
+    EXPECT_EQ(batchfile::csvStart(with.data(), with.size(), lines), with.find("100"));
+    EXPECT_EQ(lines, 3u);
+    std::string without = "100,100,1,0.05,0.2,C\n";
+    EXPECT_EQ(batchfile::csvStart(without.data(), without.size(), lines), 0u);
+    EXPECT_EQ(lines, 0u);
+}
+
+TEST(BatchFile, RoundTrip) {
+    std::vector<Option> options = book(50);
+    for (BatchFormat format : {BatchFormat::CSV, BatchFormat::Binary}) {
+        std::string path = tempPath(format == BatchFormat::CSV ? "rt.csv" : "rt.bin");
+        writeOptionFile(path, options, format);
+        std::vector<Option> back = readOptionFile(path);
+        ASSERT_EQ(back.size(), options.size());
+        for (std::size_t i = 0; i < options.size(); ++i) {
+            EXPECT_EQ(back[i].S, options[i].S);
+            EXPECT_EQ(back[i].K, options[i].K);
+            EXPECT_EQ(back[i].T, options[i].T);
+            EXPECT_EQ(back[i].sigma, options[i].sigma);
+            EXPECT_EQ(back[i].type, options[i].type);
+            EXPECT_EQ(back[i].exercise, options[i].exercise);
+        }
+        std::remove(path.c_str());
+    }
+}
+
+TEST(BatchFile, Errors) {
+    EXPECT_THROW(MappedFile(tempPath("missing")), std::runtime_error);
+#if defined(__unix__) || defined(__APPLE__)
+    // Not a regular file: a pipe would have to be buffered whole.
+    EXPECT_THROW(MappedFile("/dev/null"), std::runtime_error);
+#endif
+
+    std::string path = tempPath("bad.csv");
+    writeText(path, "100,100,1,0.05,0.2,C\n100,100,1,0.05,-0.2,C\n");
+    try {
+        readOptionFile(path);
+        FAIL() << "expected a runtime_error";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find(":2:"), std::string::npos) << e.what();
+    }
+
+    std::string bin = tempPath("bad.bin");
+    writeOptionFile(bin, book(3), BatchFormat::Binary);
+    std::ifstream in(bin, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    writeText(bin, data.substr(0, data.size() - 1));
+    EXPECT_THROW(readOptionFile(bin), std::runtime_error);
+    std::remove(path.c_str());
+    std::remove(bin.c_str());
+}
+
+// Output is BatchPricer's prices in input order, whatever the format,
+// the chunk size and the thread count.
+TEST(BatchPipeline, MatchesBatchPricer) {
+    std::vector<Option> options = book(300);
+    PDESolver prototype(50, 25, GridType::Sinh);
+    std::vector<double> expected = BatchPricer(prototype, 1).priceBatch(options);
+
+    std::string csv = tempPath("book.csv"), bin = tempPath("book.bin");
+    writeOptionFile(csv, options, BatchFormat::CSV);
+    writeOptionFile(bin, options, BatchFormat::Binary);
+    std::string reference;
+    for (const std::string& input : {csv, bin})
+        for (int threads : {1, 3})
+            for (std::size_t chunk : {std::size_t(1), std::size_t(700), std::size_t(1) << 20}) {
+                BatchPipeline pipeline(prototype, threads);
+                pipeline.setChunkBytes(chunk);
+                pipeline.setQueueDepth(1);
+                PipelineStats stats;
+                std::string text = runPipeline(pipeline, input, stats);
+                EXPECT_EQ(stats.records, options.size());
+                EXPECT_EQ(stats.rejected, 0u);
+                if (reference.empty())
+                    reference = text;
+                EXPECT_EQ(text, reference) << input << " threads=" << threads << " chunk=" << chunk;
+            }
+
+    std::istringstream lines(reference);
+    std::string line;
+    std::getline(lines, line);
+    EXPECT_EQ(line, "index,price");
+    for (std::size_t i = 0; i < options.size(); ++i) {
+        ASSERT_TRUE(std::getline(lines, line));
+        std::size_t comma = line.find(',');
+        EXPECT_EQ(std::stoul(line.substr(0, comma)), i);
+        EXPECT_EQ(std::stod(line.substr(comma + 1)), expected[i]) << i;
+    }
+    EXPECT_FALSE(std::getline(lines, line));
+    std::remove(csv.c_str());
+    std::remove(bin.c_str());
+}
+
+// Bad rows are priced nan and counted; the rest of the file goes through.
+TEST(BatchPipeline, RejectsRows) {
+    std::string path = tempPath("mixed.csv");
+    writeText(path,
+              "S,K,T,r,sigma,type,exercise\n"
+              "100,100,1,0.05,0.2,C,E\n"
+              "100,100,1,0.05,0.2\n"
+              "\n"
+              "100,100,1,0.05,-0.2,P,A\n"
+              "100,90,0.5,0.05,0.3,P,A");
+    BatchPipeline pipeline(PDESolver(50, 25), 2);
+    PipelineStats stats;
+    std::string text = runPipeline(pipeline, path, stats);
+    EXPECT_EQ(stats.records, 4u);
+    EXPECT_EQ(stats.rejected, 2u);
+    EXPECT_EQ(stats.first_error, "line 3: expected 6 or 7 fields");
+
+    std::istringstream lines(text);
+    std::string line;
+    std::vector<std::string> prices;
+    std::getline(lines, line);
+    while (std::getline(lines, line))
+        prices.push_back(line.substr(line.find(',') + 1));
+    ASSERT_EQ(prices.size(), 4u);
+    EXPECT_NE(prices[0], "nan");
+    EXPECT_EQ(prices[1], "nan");
+    EXPECT_EQ(prices[2], "nan");
+    EXPECT_NE(prices[3], "nan");
+
+    EXPECT_THROW(pipeline.setChunkBytes(0), std::invalid_argument);
+    EXPECT_THROW(pipeline.setQueueDepth(0), std::invalid_argument);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "BlackScholes.hpp"
+#include "FastMath.hpp"
+
+// --- Fast approximations stay within their documented bounds ---
+
+TEST(FastMath, Exp) {
+    for (double x = -700.0; x <= 700.0; x += 0.37) {
+        double ref = std::exp(x);
+        EXPECT_LE(std::abs(fastExp(x) - ref), 5e-16 * ref) << x;
+    }
+}
+
+TEST(FastMath, Log) {
+    for (double x = 1e-300; x < 1e300; x *= 1.37)
+        EXPECT_LE(std::abs(fastLog(x) - std::log(x)), 4e-16 * std::max(1.0, std::abs(std::log(x)))) << x;
+    for (double x = 0.5; x < 2.0; x += 0.001)
+        EXPECT_NEAR(fastLog(x), std::log(x), 3e-16) << x;
+}
+
+TEST(FastMath, NormalCDF) {
+    for (double x = -38.0; x <= 38.0; x += 0.013) {
+        double ref = 0.5 * std::erfc(-x * M_SQRT1_2);
+        EXPECT_NEAR(fastNormalCDF(x), ref, 5e-16) << x;
+        if (x > -10.0)
+            EXPECT_LE(std::abs(fastNormalCDF(x) - ref), 3e-14 * ref) << x;
+    }
+}
+
+// --- Scalar greeks agree with finite differences of price ---
+
+static Option bumped(const Option& o, double dS, double dT, double dr, double dsig) {
+    return Option(o.S + dS, o.K, o.T + dT, o.r + dr, o.sigma + dsig, o.type);
+}
+
+TEST(BlackScholesGreeks, ScalarMatchFiniteDifferences) {
+    for (OptionType type : {OptionType::Call, OptionType::Put}) {
+        Option o(105, 100, 0.75, 0.04, 0.25, type);
+        double h = 1e-4;
+        double p = BlackScholes::price(o);
+        double up = BlackScholes::price(bumped(o, h, 0, 0, 0));
+        double dn = BlackScholes::price(bumped(o, -h, 0, 0, 0));
+        EXPECT_NEAR(BlackScholes::delta(o), (up - dn) / (2 * h), 1e-7);
+        EXPECT_NEAR(BlackScholes::gamma(o), (up - 2 * p + dn) / (h * h), 1e-4);
+        EXPECT_NEAR(BlackScholes::vega(o),
+                    (BlackScholes::price(bumped(o, 0, 0, 0, h)) -
+                     BlackScholes::price(bumped(o, 0, 0, 0, -h))) / (2 * h), 1e-6);
+        // theta is dV/dt = -dV/dT
+        EXPECT_NEAR(BlackScholes::theta(o),
+                    -(BlackScholes::price(bumped(o, 0, h, 0, 0)) -
+                      BlackScholes::price(bumped(o, 0, -h, 0, 0))) / (2 * h), 1e-6);
+        EXPECT_NEAR(BlackScholes::rho(o),
+                    (BlackScholes::price(bumped(o, 0, 0, h, 0)) -
+                     BlackScholes::price(bumped(o, 0, 0, -h, 0))) / (2 * h), 1e-6);
+    }
+}
+
+// --- Batch kernel ---
+
+struct Batch {
+    std::vector<double> S, K, T, r, sigma;
+    std::vector<OptionType> type;
+    std::vector<double> price, delta, gamma, vega, theta, rho, vanna, volga;
+
+    void add(const Option& o) {
+        S.push_back(o.S); K.push_back(o.K); T.push_back(o.T);
+        r.push_back(o.r); sigma.push_back(o.sigma); type.push_back(o.type);
+    }
+    void run() {
+        std::size_t n = S.size();
+        for (auto* v : {&price, &delta, &gamma, &vega, &theta, &rho, &vanna, &volga})
+            v->assign(n, 0.0);
+        BSQuotes in{S.data(), K.data(), T.data(), r.data(), sigma.data(), type.data(), n};
+        BSGreeks out{price.data(), delta.data(), gamma.data(), vega.data(),
+                     theta.data(), rho.data(), vanna.data(), volga.data()};
+        BlackScholes::priceBatch(in, out);
+    }
+};
+
+TEST(BlackScholesBatch, MatchesScalarPath) {
+    Batch b;
+    std::vector<Option> opts;
+    for (int i = 0; i < 37; ++i) {
+        OptionType type = (i % 2 == 0) ? OptionType::Call : OptionType::Put;
+        opts.emplace_back(50.0 + 3.0 * i, 100.0, 0.05 + 0.1 * i, 0.002 * i, 0.08 + 0.015 * i, type);
+        b.add(opts.back());
+    }
+    b.run();
+    for (std::size_t i = 0; i < opts.size(); ++i) {
+        const Option& o = opts[i];
+        double scale = o.K;
+        EXPECT_NEAR(b.price[i], BlackScholes::price(o), 1e-12 * scale) << i;
+        EXPECT_NEAR(b.delta[i], BlackScholes::delta(o), 1e-13) << i;
+        EXPECT_NEAR(b.gamma[i], BlackScholes::gamma(o), 1e-13) << i;
+        EXPECT_NEAR(b.vega[i],  BlackScholes::vega(o),  1e-12 * scale) << i;
+        EXPECT_NEAR(b.theta[i], BlackScholes::theta(o), 1e-12 * scale) << i;
+        EXPECT_NEAR(b.rho[i],   BlackScholes::rho(o),   1e-12 * scale) << i;
+    }
+}
+
+TEST(BlackScholesBatch, SecondOrderCrossGreeks) {
+    Option o(95, 100, 1.5, 0.03, 0.3, OptionType::Call);
+    double h = 1e-4;
+    Batch b;
+    b.add(o);
+    b.run();
+    // vanna = d(vega)/dS, volga = d(vega)/dsigma
+    double vanna_fd = (BlackScholes::vega(bumped(o, h, 0, 0, 0)) -
+                       BlackScholes::vega(bumped(o, -h, 0, 0, 0))) / (2 * h);
+    double volga_fd = (BlackScholes::vega(bumped(o, 0, 0, 0, h)) -
+                       BlackScholes::vega(bumped(o, 0, 0, 0, -h))) / (2 * h);
+    EXPECT_NEAR(b.vanna[0], vanna_fd, 1e-6);
+    EXPECT_NEAR(b.volga[0], volga_fd, 1e-5);
+}
+
+TEST(BlackScholesBatch, PutCallParity) {
+    Batch b;
+    b.add(Option(100, 110, 2.0, 0.05, 0.2, OptionType::Call));
+    b.add(Option(100, 110, 2.0, 0.05, 0.2, OptionType::Put));
+    b.run();
+    EXPECT_NEAR(b.price[0] - b.price[1], 100.0 - 110.0 * std::exp(-0.1), 1e-12);
+    EXPECT_NEAR(b.delta[0] - b.delta[1], 1.0, 1e-15);
+    EXPECT_DOUBLE_EQ(b.gamma[0], b.gamma[1]);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "BlackScholes.hpp"
+#include "DupireSolver.hpp"
+#include "PDESolver.hpp"
+
+static const std::vector<double> kMaturities = {0.25, 0.5, 1.0};
+
+TEST(Dupire, MatchesBlackScholesAcrossStrikes) {
+    DupireSolver solver(400, 400);
+    solver.setRannacherSteps(2);
+    for (OptionType type : {OptionType::Call, OptionType::Put}) {
+        std::vector<StrikeSlice> slices = solver.solve(100, 0.05, 0.2, type, kMaturities);
+        ASSERT_EQ(slices.size(), kMaturities.size());
+        for (const StrikeSlice& slice : slices)
+            for (double K = 60; K <= 160; K += 5)
+                EXPECT_NEAR(slice.prices.evaluate(K),
+                            BlackScholes::price(Option(100, K, slice.T, 0.05, 0.2, type)), 1e-3)
+                    << "K=" << K << " T=" << slice.T;
+        EXPECT_EQ(solver.lastSteps(), 400);
+        EXPECT_EQ(solver.lastFactorizations(), 1);
+    }
+}
+
+// Forward and backward discretizations of the same grid family agree to
+// discretization error.
+TEST(Dupire, AgreesWithBackwardSolver) {
+    for (GridType grid : {GridType::Uniform, GridType::Adaptive, GridType::Sinh}) {
+        DupireSolver forward(400, 400, grid);
+        forward.setRannacherSteps(2);
+        std::vector<StrikeSlice> slices = forward.solve(100, 0.03, 0.3, OptionType::Put, {0.5});
+        PDESolver backward(400, 200, grid);
+        backward.setRannacherSteps(2);
+        for (double K = 70; K <= 140; K += 10)
+            EXPECT_NEAR(slices[0].prices.evaluate(K),
+                        backward.priceEuropean(Option(100, K, 0.5, 0.03, 0.3, OptionType::Put)),
+                        5e-3) << static_cast<int>(grid) << " K=" << K;
+    }
+}
+
+// C - P = S0 - K exp(-rT) is linear in K, so the stencils are exact for
+// it; only Crank-Nicolson's O(dt^2) error in exp(-rT) remains.
+TEST(Dupire, PutCallParity) {
+    DupireSolver solver(200, 200, GridType::Adaptive);
+    std::vector<StrikeSlice> calls = solver.solve(100, 0.05, 0.25, OptionType::Call, kMaturities);
+    std::vector<StrikeSlice> puts = solver.solve(100, 0.05, 0.25, OptionType::Put, kMaturities);
+    for (std::size_t j = 0; j < kMaturities.size(); ++j) {
+        const std::vector<double>& K = calls[j].prices.nodes();
+        for (std::size_t i = 0; i < K.size(); ++i)
+            EXPECT_NEAR(calls[j].prices.values()[i] - puts[j].prices.values()[i],
+                        100.0 - K[i] * std::exp(-0.05 * kMaturities[j]), 1e-6);
+    }
+}
+
+// A flat local volatility reproduces the constant-vol solve; a term
+// structure sigma(T) prices like Black-Scholes at the average variance.
+TEST(Dupire, LocalVolatility) {
+    DupireSolver flat(200, 100), local(200, 100);
+    local.setLocalVol([](double, double) { return 0.2; });
+    std::vector<StrikeSlice> a = flat.solve(100, 0.05, 0.2, OptionType::Call, {1.0});
+    std::vector<StrikeSlice> b = local.solve(100, 0.05, 0.2, OptionType::Call, {1.0});
+    for (int i = 0; i < a[0].prices.size(); ++i)
+        EXPECT_DOUBLE_EQ(a[0].prices.values()[i], b[0].prices.values()[i]);
+    EXPECT_EQ(local.lastFactorizations(), 100);
+
+    DupireSolver term(400, 400);
+    term.setRannacherSteps(2);
+    term.setLocalVol([](double, double T) { return 0.2 + 0.1 * T; });
+    for (const StrikeSlice& slice : term.solve(100, 0.05, 0.25, OptionType::Call, {0.5, 1.0})) {
+        double T = slice.T;
+        double var = 0.04 + 0.02 * T + 0.01 * T * T / 3.0;   // (1/T) int_0^T sigma^2
+        for (double K = 70; K <= 140; K += 10)
+            EXPECT_NEAR(slice.prices.evaluate(K),
+                        BlackScholes::price(Option(100, K, T, 0.05, std::sqrt(var),
+                                                   OptionType::Call)), 1e-3);
+    }
+}
+
+TEST(Dupire, Validation) {
+    EXPECT_THROW(DupireSolver(5, 10), std::invalid_argument);
+    EXPECT_THROW(DupireSolver(100, 10, GridType::SinhRefined), std::invalid_argument);
+    DupireSolver solver(100, 50);
+    EXPECT_THROW(solver.solve(100, 0.05, 0.2, OptionType::Call, {}), std::invalid_argument);
+    EXPECT_THROW(solver.solve(100, 0.05, 0.2, OptionType::Call, {0.5, -1.0}),
+                 std::invalid_argument);
+    EXPECT_THROW(solver.solve(-1, 0.05, 0.2, OptionType::Call, {1.0}), std::invalid_argument);
+    solver.setLocalVol([](double, double) { return 0.0; });
+    EXPECT_THROW(solver.solve(100, 0.05, 0.2, OptionType::Call, {1.0}), std::invalid_argument);
+}
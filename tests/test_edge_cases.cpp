@@ -99,3 +99,21 @@ TEST(Convergence, AdaptiveBetterThanUniform) {
 
     EXPECT_LT(err_adapt, err_unif);
 }
+
+// --- Domain truncation ---
+
+TEST(Convergence, WiderDomainFixesLongDatedHighVol) {
+    // At S_max = 3K the boundary condition costs ~7e-3 here, at any M.
+    Option opt(100, 100, 2.0, 0.05, 0.47, OptionType::Put);
+    double bs = BlackScholes::price(opt);
+
+    PDESolver solver(1600, 400, true);
+    solver.setRannacherSteps(2);
+    double err_default = std::abs(solver.priceEuropean(opt) - bs);
+    solver.setDomainMultiple(6.0);
+    double err_wide = std::abs(solver.priceEuropean(opt) - bs);
+
+    EXPECT_GT(err_default, 5e-3);
+    EXPECT_LT(err_wide, 1e-3);
+    EXPECT_THROW(solver.setDomainMultiple(1.0), std::invalid_argument);
+}
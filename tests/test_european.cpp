@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <vector>
 #include "Option.hpp"
 #include "PDESolver.hpp"
 #include "BlackScholes.hpp"
@@ -129,3 +132,209 @@ TEST(European, HighRatePut) {
     PDESolver solver(200, 200, true);
     EXPECT_NEAR(solver.priceEuropean(opt), BlackScholes::price(opt), TOL);
 }
+
+// --- Lane-batched pricing matches the scalar path ---
+
+TEST(EuropeanBatch, MatchesScalarMixedBook) {
+    // 11 options: not a multiple of the lane width, mixed type/strike/T/r/vol.
+    std::vector<Option> book;
+    for (int i = 0; i < 11; ++i) {
+        OptionType type = (i % 2 == 0) ? OptionType::Call : OptionType::Put;
+        book.emplace_back(80.0 + 4.0 * i, 90.0 + 2.0 * i, 0.25 + 0.2 * i,
+                          0.01 + 0.005 * i, 0.15 + 0.02 * i, type);
+    }
+    PDESolver solver(200, 200, true);
+    std::vector<double> batch(book.size());
+    solver.priceEuropeanBatch(book.data(), book.size(), batch.data());
+    for (std::size_t i = 0; i < book.size(); ++i)
+        EXPECT_NEAR(batch[i], solver.priceEuropean(book[i]), 1e-10);
+}
+
+TEST(EuropeanBatch, RejectsAmericans) {
+    std::vector<Option> book = {
+        Option(100, 100, 1.0, 0.05, 0.20, OptionType::Call),
+        Option(100, 110, 0.5, 0.03, 0.30, OptionType::Put, ExerciseType::American),
+    };
+    PDESolver solver(100, 100, true);
+    std::vector<double> out(book.size(), -1.0);
+    EXPECT_THROW(solver.priceEuropeanBatch(book.data(), book.size(), out.data()),
+                 std::invalid_argument);
+    EXPECT_EQ(out[0], -1.0);   // nothing priced
+}
+
+TEST(EuropeanBatch, UniformGridMatchesBlackScholes) {
+    std::vector<Option> book = {
+        Option(100, 100, 1.0, 0.05, 0.20, OptionType::Call),
+        Option(100, 110, 0.5, 0.03, 0.30, OptionType::Put),
+    };
+    PDESolver solver(200, 200, false);
+    std::vector<double> batch(book.size());
+    solver.priceEuropeanBatch(book.data(), book.size(), batch.data());
+    for (std::size_t i = 0; i < book.size(); ++i)
+        EXPECT_NEAR(batch[i], BlackScholes::price(book[i]), TOL);
+}
+
+// --- Grid families ---
+
+TEST(GridFamilies, SinhBeatsAdaptiveAtEqualNodes) {
+    // Short-dated, away from the money: the fixed +-25% zone of
+    // AdaptiveGrid is much wider than the diffusion length.
+    Option opt(113, 100, 0.1, 0.05, 0.15, OptionType::Call);
+    double bs = BlackScholes::price(opt);
+    PDESolver adaptive(200, 500, GridType::Adaptive);
+    PDESolver sinh(200, 500, GridType::Sinh);
+    PDESolver refined(200, 500, GridType::SinhRefined);
+    for (PDESolver* s : {&adaptive, &sinh, &refined})
+        s->setRannacherSteps(2);
+
+    double err_adaptive = std::abs(adaptive.priceEuropean(opt) - bs);
+    double err_sinh = std::abs(sinh.priceEuropean(opt) - bs);
+    double err_refined = std::abs(refined.priceEuropean(opt) - bs);
+    EXPECT_LT(err_sinh, 0.5 * err_adaptive);
+    EXPECT_LT(err_refined, 0.5 * err_sinh);
+}
+
+TEST(GridFamilies, AllFamiliesAccurate) {
+    Option opt(100, 100, 1.0, 0.05, 0.20, OptionType::Put);
+    double bs = BlackScholes::price(opt);
+    for (GridType g : {GridType::Uniform, GridType::Adaptive, GridType::Sinh,
+                       GridType::SinhRefined}) {
+        PDESolver solver(200, 200, g);
+        EXPECT_EQ(solver.gridType(), g);
+        EXPECT_NEAR(solver.priceEuropean(opt), bs, TOL);
+    }
+}
+
+TEST(GridFamilies, SinhBatchMatchesScalar) {
+    std::vector<Option> book;
+    for (int k = 0; k < 5; ++k)
+        book.emplace_back(85 + 7 * k, 100, 0.5, 0.05, 0.25, OptionType::Call);
+    for (GridType g : {GridType::Sinh, GridType::SinhRefined}) {
+        PDESolver solver(120, 60, g);
+        std::vector<double> out(book.size());
+        solver.priceEuropeanBatch(book.data(), book.size(), out.data());
+        for (std::size_t i = 0; i < book.size(); ++i)
+            EXPECT_NEAR(out[i], solver.priceEuropean(book[i]), 1e-12);
+    }
+}
+
+TEST(GridFamilies, BoolConstructorMapsToGridType) {
+    EXPECT_EQ(PDESolver(100, 100, true).gridType(), GridType::Adaptive);
+    EXPECT_EQ(PDESolver(100, 100, false).gridType(), GridType::Uniform);
+}
+
+// --- Partitioned solves ---
+
+// A grid above PartitionedTridiagonalLU::kMinRows priced with a solve pool,
+// with and without a setup cache, matches the Thomas solve to rounding;
+// Brennan-Schwartz, which always runs Thomas, matches exactly.
+TEST(SolvePool, MatchesThomasOnLargeGrids) {
+    Option call(100, 100, 1.0, 0.05, 0.2, OptionType::Call);
+    Option put(100, 105, 0.5, 0.03, 0.3, OptionType::Put, ExerciseType::American);
+    int M = PartitionedTridiagonalLU::kMinRows + 100;
+
+    PDESolver thomas(M, 50, GridType::Sinh);
+    thomas.setRannacherSteps(2);
+    PDESolver parallel = thomas;
+    parallel.setSolvePool(std::make_shared<WorkStealingPool>(2));
+    PDESolver cached = parallel;
+    cached.setSetupCache(std::make_shared<SetupCache>());
+
+    double expected = thomas.priceEuropean(call);
+    EXPECT_NEAR(parallel.priceEuropean(call), expected, 1e-10);
+    EXPECT_NEAR(cached.priceEuropean(call), expected, 1e-10);
+    EXPECT_NEAR(cached.priceEuropean(call), expected, 1e-10);   // cache hit
+    EXPECT_NEAR(parallel.priceAmerican(put), thomas.priceAmerican(put), 1e-10);
+
+    thomas.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+    parallel.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+    EXPECT_EQ(parallel.priceAmerican(put), thomas.priceAmerican(put));
+}
+
+// --- Reduced precision ---
+
+// Single applies to batches only; scalar prices run in double. One
+// mixed-precision correction recovers double accuracy. Americans ignore
+// the mode.
+TEST(Precision, SingleAndMixedTrackDouble) {
+    Option call(100, 100, 1.0, 0.05, 0.2, OptionType::Call);
+    Option put(100, 110, 0.5, 0.03, 0.3, OptionType::Put);
+    Option american(100, 105, 0.5, 0.03, 0.3, OptionType::Put, ExerciseType::American);
+
+    PDESolver full(200, 200, GridType::Sinh);
+    full.setRannacherSteps(2);
+    PDESolver single = full;
+    single.setPrecision(Precision::Single);
+    PDESolver mixed = full;
+    mixed.setPrecision(Precision::Mixed);
+    EXPECT_EQ(single.precision(), Precision::Single);
+
+    for (const Option& o : {call, put}) {
+        double expected = full.priceEuropean(o);
+        EXPECT_EQ(single.priceEuropean(o), expected);
+        EXPECT_NEAR(mixed.priceEuropean(o), expected, 1e-9 * expected);
+    }
+    EXPECT_EQ(single.priceAmerican(american), full.priceAmerican(american));
+    EXPECT_EQ(mixed.priceAmerican(american), full.priceAmerican(american));
+}
+
+// The float error grows with the grid; Single is refused beyond the
+// sizes where it holds 1e-4 relative, and Mixed holds it at production
+// sizes.
+TEST(Precision, RelativeErrorBudget) {
+    std::vector<Option> book;
+    for (int i = 0; i < 32; ++i) {
+        OptionType type = (i % 2 == 0) ? OptionType::Call : OptionType::Put;
+        book.emplace_back(80.0 + 1.2 * i, 100.0, 0.25 + 0.04 * i, 0.05, 0.15 + 0.01 * i, type);
+    }
+    std::vector<double> expected(book.size()), out(book.size());
+    auto maxError = [&] {
+        double err = 0.0;
+        for (std::size_t i = 0; i < book.size(); ++i)
+            err = std::max(err, std::abs(out[i] / expected[i] - 1.0));
+        return err;
+    };
+
+    PDESolver fine(2000, 200, GridType::Sinh);
+    EXPECT_THROW(fine.setPrecision(Precision::Single), std::invalid_argument);
+    EXPECT_EQ(fine.precision(), Precision::Double);
+    EXPECT_THROW(PDESolver(100, 1000).setPrecision(Precision::Single), std::invalid_argument);
+
+    fine.priceEuropeanBatch(book.data(), book.size(), expected.data());
+    fine.setPrecision(Precision::Mixed);
+    fine.priceEuropeanBatch(book.data(), book.size(), out.data());
+    EXPECT_LT(maxError(), 1e-4);
+    for (std::size_t i = 0; i < book.size(); i += 8)
+        EXPECT_NEAR(fine.priceEuropean(book[i]), expected[i], 1e-4 * expected[i]);
+
+    for (GridType grid : {GridType::Uniform, GridType::Adaptive, GridType::Sinh,
+                          GridType::LogUniform, GridType::LogSinh}) {
+        PDESolver largest(PDESolver::kMaxSingleSpace, PDESolver::kMaxSingleTime, grid);
+        largest.priceEuropeanBatch(book.data(), book.size(), expected.data());
+        largest.setPrecision(Precision::Single);
+        largest.priceEuropeanBatch(book.data(), book.size(), out.data());
+        EXPECT_LT(maxError(), 1e-4) << static_cast<int>(grid);
+    }
+}
+
+TEST(Precision, BatchMatchesScalar) {
+    std::vector<Option> book;
+    for (int i = 0; i < 19; ++i) {
+        OptionType type = (i % 2 == 0) ? OptionType::Call : OptionType::Put;
+        book.emplace_back(80.0 + 4.0 * i, 90.0 + 2.0 * i, 0.25 + 0.1 * i,
+                          0.01 + 0.003 * i, 0.15 + 0.01 * i, type);
+    }
+    PDESolver full(200, 200, GridType::Sinh);
+    std::vector<double> expected(book.size()), out(book.size());
+    full.priceEuropeanBatch(book.data(), book.size(), expected.data());
+    for (Precision p : {Precision::Single, Precision::Mixed}) {
+        PDESolver solver = full;
+        solver.setPrecision(p);
+        solver.priceEuropeanBatch(book.data(), book.size(), out.data());
+        double tol = p == Precision::Single ? 1e-4 : 1e-9;
+        for (std::size_t i = 0; i < book.size(); ++i) {
+            EXPECT_NEAR(out[i], expected[i], tol * std::max(1.0, expected[i]));
+            EXPECT_NEAR(out[i], solver.priceEuropean(book[i]), tol * std::max(1.0, expected[i]));
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "Option.hpp"
+#include "PDESolver.hpp"
+#include "BlackScholes.hpp"
+
+// --- European greeks against Black-Scholes ---
+
+TEST(Greeks, EuropeanCallMatchesBlackScholes) {
+    Option opt(100, 100, 1.0, 0.05, 0.20, OptionType::Call);
+    PDESolver solver(200, 200, true);
+    PricingResult g = solver.priceWithGreeks(opt);
+    EXPECT_NEAR(g.price, BlackScholes::price(opt), 0.05);
+    EXPECT_NEAR(g.delta, BlackScholes::delta(opt), 1e-3);
+    EXPECT_NEAR(g.gamma, BlackScholes::gamma(opt), 1e-3);
+    EXPECT_NEAR(g.theta, BlackScholes::theta(opt), 0.02);
+}
+
+TEST(Greeks, EuropeanPutOffNodeSpot) {
+    Option opt(93.7, 105, 0.5, 0.03, 0.30, OptionType::Put);
+    PDESolver solver(200, 200, true);
+    PricingResult g = solver.priceWithGreeks(opt);
+    EXPECT_NEAR(g.delta, BlackScholes::delta(opt), 2e-3);
+    EXPECT_NEAR(g.gamma, BlackScholes::gamma(opt), 1e-3);
+    EXPECT_NEAR(g.theta, BlackScholes::theta(opt), 0.02);
+}
+
+TEST(Greeks, PriceMatchesPlainSolve) {
+    Option eu(100, 100, 1.0, 0.05, 0.20, OptionType::Put);
+    Option am(100, 100, 1.0, 0.05, 0.20, OptionType::Put, ExerciseType::American);
+    PDESolver solver(150, 150, true);
+    EXPECT_EQ(solver.priceWithGreeks(eu).price, solver.priceEuropean(eu));
+    EXPECT_EQ(solver.priceWithGreeks(am).price, solver.priceAmerican(am));
+}
+
+// --- American greeks ---
+
+TEST(Greeks, AmericanPutInExerciseRegion) {
+    // Deep ITM: immediately exercised, worth K - S.
+    Option am(60, 100, 1.0, 0.05, 0.20, OptionType::Put, ExerciseType::American);
+    PDESolver solver(200, 200, true);
+    PricingResult g = solver.priceWithGreeks(am);
+    EXPECT_NEAR(g.price, 40.0, 1e-10);
+    EXPECT_DOUBLE_EQ(g.delta, -1.0);
+    EXPECT_DOUBLE_EQ(g.gamma, 0.0);
+    EXPECT_NEAR(g.theta, 0.0, 1e-8);
+}
+
+TEST(Greeks, AmericanPutMatchesBumpAndReprice) {
+    Option am(100, 100, 1.0, 0.05, 0.20, OptionType::Put, ExerciseType::American);
+    PDESolver solver(400, 400, true);
+    PricingResult g = solver.priceWithGreeks(am);
+
+    double h = 1.0;
+    auto at = [&](double S, double T) {
+        return solver.priceAmerican(Option(S, 100, T, 0.05, 0.20, OptionType::Put,
+                                           ExerciseType::American));
+    };
+    double up = at(100 + h, 1.0), mid = at(100, 1.0), dn = at(100 - h, 1.0);
+    EXPECT_NEAR(g.delta, (up - dn) / (2 * h), 2e-3);
+    EXPECT_NEAR(g.gamma, (up - 2 * mid + dn) / (h * h), 2e-3);
+    double dT = 0.01;
+    EXPECT_NEAR(g.theta, -(at(100, 1.0 + dT) - at(100, 1.0 - dT)) / (2 * dT), 0.02);
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <cmath>
+#include <vector>
 #include "Grid.hpp"
+#include "SolverKernels.hpp"
 
 // --- UniformGrid ---
 
@@ -78,3 +80,148 @@ TEST(UniformGrid, InvalidParametersThrow) {
     EXPECT_THROW(UniformGrid(300.0, 1), std::invalid_argument);
     EXPECT_THROW(UniformGrid(-1.0, 100), std::invalid_argument);
 }
+
+// --- SinhGrid ---
+
+TEST(SinhGrid, BoundariesAndSize) {
+    SinhGrid g(300.0, 100, {100.0}, 20.0);
+    EXPECT_EQ(g.size(), 101);
+    EXPECT_DOUBLE_EQ(g.spot(0), 0.0);
+    EXPECT_DOUBLE_EQ(g.spot(100), 300.0);
+    for (int i = 0; i < g.size() - 1; ++i)
+        EXPECT_GT(g.spot(i + 1), g.spot(i));
+}
+
+TEST(SinhGrid, CentresAreNodes) {
+    SinhGrid g(300.0, 101, {100.0, 87.3}, 10.0);
+    for (double c : {100.0, 87.3}) {
+        int i = g.findIndex(c);
+        bool on_node = g.spot(i) == c || g.spot(i + 1) == c;
+        EXPECT_TRUE(on_node) << c;
+    }
+}
+
+TEST(SinhGrid, SmoothSpacingFinestAtCentre) {
+    SinhGrid g(300.0, 200, {100.0}, 15.0);
+    int k = g.findIndex(100.0);
+    double h_centre = g.spacing(k);
+    EXPECT_LT(h_centre, g.spacing(0));
+    EXPECT_LT(h_centre, g.spacing(g.size() - 2));
+    // Neighbouring intervals differ by a few percent at most.
+    for (int i = 1; i < g.size() - 1; ++i) {
+        double ratio = g.spacing(i) / g.spacing(i - 1);
+        EXPECT_GT(ratio, 0.9);
+        EXPECT_LT(ratio, 1.1);
+    }
+}
+
+TEST(SinhGrid, InvalidParametersThrow) {
+    EXPECT_THROW(SinhGrid(300.0, 5, {100.0}, 10.0), std::invalid_argument);
+    EXPECT_THROW(SinhGrid(300.0, 100, {100.0}, 0.0), std::invalid_argument);
+    EXPECT_THROW(SinhGrid(300.0, 100, {}, 10.0), std::invalid_argument);
+}
+
+// --- LogGrid ---
+
+TEST(LogGrid, UniformInLogMoneyness) {
+    LogGrid g(100.0, std::log(3.0), 100);
+    EXPECT_EQ(g.size(), 101);
+    EXPECT_NEAR(g.spot(0), 100.0 / 3.0, 1e-12);
+    EXPECT_NEAR(g.spot(100), 300.0, 1e-12);
+    EXPECT_DOUBLE_EQ(g.spot(50), 100.0);   // even M: the strike is a node
+    const std::vector<double>& y = g.logNodes();
+    for (int i = 0; i < g.size(); ++i)
+        EXPECT_NEAR(std::log(g.spot(i) / 100.0), y[i], 1e-14);
+    for (int i = 1; i < g.size(); ++i)
+        EXPECT_NEAR(y[i] - y[i - 1], 2.0 * std::log(3.0) / 100, 1e-14);
+}
+
+TEST(LogGrid, SinhClusteredAtStrike) {
+    LogGrid g(80.0, 1.0, 101, 0.05);
+    EXPECT_DOUBLE_EQ(g.logNodes().front(), -1.0);
+    EXPECT_DOUBLE_EQ(g.logNodes().back(), 1.0);
+    int k = g.findIndex(80.0);
+    EXPECT_DOUBLE_EQ(g.spot(k), 80.0);     // odd M: still a node
+    const std::vector<double>& y = g.logNodes();
+    EXPECT_LT(y[k + 1] - y[k], 0.2 * (y[1] - y[0]));
+    for (int i = 2; i < g.size(); ++i) {
+        double ratio = (y[i] - y[i - 1]) / (y[i - 1] - y[i - 2]);
+        EXPECT_GT(ratio, 0.9);
+        EXPECT_LT(ratio, 1.1);
+    }
+}
+
+TEST(LogGrid, SameSpacingForEveryStrike) {
+    LogGrid a(50.0, 1.2, 80, 0.1), b(170.0, 1.2, 80, 0.1);
+    EXPECT_EQ(a.logNodes(), b.logNodes());
+}
+
+TEST(LogGrid, InvalidParametersThrow) {
+    EXPECT_THROW(LogGrid(100.0, 1.0, 1), std::invalid_argument);
+    EXPECT_THROW(LogGrid(0.0, 1.0, 100), std::invalid_argument);
+    EXPECT_THROW(LogGrid(100.0, 0.0, 100), std::invalid_argument);
+    EXPECT_THROW(LogGrid(100.0, 1.0, 100, -0.1), std::invalid_argument);
+}
+
+// --- DensityGrid ---
+
+TEST(DensityGrid, FollowsDensity) {
+    // Density 4x higher on [100, 200] than elsewhere.
+    std::vector<double> at{0.0, 99.0, 101.0, 199.0, 201.0, 300.0};
+    std::vector<double> rho{1.0, 1.0, 4.0, 4.0, 1.0, 1.0};
+    DensityGrid g(at, rho, 120, {150.0});
+    EXPECT_EQ(g.size(), 121);
+    EXPECT_DOUBLE_EQ(g.spot(120), 300.0);
+    EXPECT_NEAR(g.spacing(g.findIndex(50.0)) / g.spacing(g.findIndex(150.0)), 4.0, 0.1);
+    int i = g.findIndex(150.0);
+    EXPECT_DOUBLE_EQ(g.spot(i), 150.0);
+}
+
+TEST(DensityGrid, InvalidParametersThrow) {
+    std::vector<double> at{0.0, 100.0, 300.0};
+    EXPECT_THROW(DensityGrid(at, {1.0, 0.0, 1.0}, 50, {}), std::invalid_argument);
+    EXPECT_THROW(DensityGrid({0.0, 200.0, 100.0}, {1.0, 1.0, 1.0}, 50, {}),
+                 std::invalid_argument);
+    EXPECT_THROW(DensityGrid(at, {1.0, 1.0}, 50, {}), std::invalid_argument);
+}
+
+// --- Operator stencils ---
+
+TEST(OperatorStencil, UniformMatchesGeneral) {
+    UniformGrid grid(300.0, 120);
+    int n = grid.size();
+    std::vector<double> a1(n), b1(n), c1(n), a2(n), b2(n), c2(n);
+    kernels::fillOperator<kernels::UniformSpacing>(grid.nodes().data(), n, 0.3, 0.04,
+                                                   a1.data(), b1.data(), c1.data());
+    kernels::fillOperator<kernels::GeneralSpacing>(grid.nodes().data(), n, 0.3, 0.04,
+                                                   a2.data(), b2.data(), c2.data());
+    for (int i = 0; i < n; ++i) {
+        double scale = 1.0 + std::abs(b2[i]);
+        EXPECT_NEAR(a1[i], a2[i], 1e-12 * scale);
+        EXPECT_NEAR(b1[i], b2[i], 1e-12 * scale);
+        EXPECT_NEAR(c1[i], c2[i], 1e-12 * scale);
+    }
+}
+
+TEST(OperatorStencil, LogOperatorIsConstantOnUniformGrid) {
+    LogGrid grid(100.0, 1.0, 120);
+    int n = grid.size();
+    std::vector<double> a1(n), b1(n), c1(n), a2(n), b2(n), c2(n);
+    kernels::fillLogOperator<kernels::UniformSpacing>(grid.logNodes().data(), n, 0.3, 0.04,
+                                                      a1.data(), b1.data(), c1.data());
+    kernels::fillLogOperator<kernels::GeneralSpacing>(grid.logNodes().data(), n, 0.3, 0.04,
+                                                      a2.data(), b2.data(), c2.data());
+    for (int i = 1; i < n - 1; ++i) {
+        EXPECT_EQ(a1[i], a1[1]);
+        EXPECT_EQ(b1[i], b1[1]);
+        EXPECT_EQ(c1[i], c1[1]);
+        double scale = 1.0 + std::abs(b2[i]);
+        EXPECT_NEAR(a1[i], a2[i], 1e-9 * scale);
+        EXPECT_NEAR(b1[i], b2[i], 1e-9 * scale);
+        EXPECT_NEAR(c1[i], c2[i], 1e-9 * scale);
+    }
+    // Annihilates V = S = K exp(y) up to the discount term: L S = r S - r S = 0.
+    const std::vector<double>& S = grid.nodes();
+    for (int i = 1; i < n - 1; ++i)
+        EXPECT_NEAR(a1[i] * S[i - 1] + b1[i] * S[i] + c1[i] * S[i + 1], 0.0, 1e-5 * S[i]);
+}
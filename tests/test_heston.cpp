@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "BlackScholes.hpp"
+#include "HestonSolver.hpp"
+
+// Fang and Oosterlee's test case: Feller condition violated, v0 well
+// below theta.
+static const HestonParams kCos{0.0175, 1.5768, 0.0398, 0.5751, -0.5711};
+static const HestonParams kSkew{0.04, 1.5, 0.04, 0.3, -0.9};
+
+TEST(HestonClosedForm, ReferenceValue) {
+    Option call(100, 100, 1, 0.0, 0.2, OptionType::Call);
+    EXPECT_NEAR(hestonPrice(call, kCos), 5.785155450, 1e-7);
+}
+
+TEST(HestonClosedForm, ParityAndBlackScholesLimit) {
+    for (double K : {80.0, 100.0, 125.0}) {
+        Option call(100, K, 0.75, 0.03, 0.2, OptionType::Call);
+        Option put(100, K, 0.75, 0.03, 0.2, OptionType::Put);
+        EXPECT_NEAR(hestonPrice(call, kSkew) - hestonPrice(put, kSkew),
+                    100.0 - K * std::exp(-0.03 * 0.75), 1e-10);
+
+        // With v0 = theta and almost no vol of variance, v stays at theta.
+        HestonParams flat{0.04, 2.0, 0.04, 1e-4, 0.0};
+        EXPECT_NEAR(hestonPrice(call, flat), BlackScholes::price(call), 1e-6) << K;
+    }
+}
+
+// Every scheme converges to the closed form; 100x50 nodes and 50 steps
+// are within a few cents on both test cases.
+TEST(HestonSolver, MatchesClosedForm) {
+    for (AdiScheme scheme :
+         {AdiScheme::Douglas, AdiScheme::CraigSneyd, AdiScheme::HundsdorferVerwer}) {
+        HestonSolver solver(100, 50, 50, scheme, 1);
+        solver.setRannacherSteps(2);
+        for (double K : {80.0, 100.0, 120.0}) {
+            for (OptionType type : {OptionType::Call, OptionType::Put}) {
+                Option option(100, K, 1.0, 0.025, 0.2, type);
+                EXPECT_NEAR(solver.price(option, kSkew), hestonPrice(option, kSkew), 0.02)
+                    << static_cast<int>(scheme) << " K=" << K;
+            }
+        }
+        Option atm(100, 100, 1.0, 0.0, 0.2, OptionType::Call);
+        EXPECT_NEAR(solver.price(atm, kCos), 5.785155450, 0.02) << static_cast<int>(scheme);
+    }
+}
+
+// Doubling every resolution cuts the error about fourfold.
+TEST(HestonSolver, SecondOrder) {
+    Option put(100, 100, 1.0, 0.025, 0.2, OptionType::Put);
+    double exact = hestonPrice(put, kSkew);
+    double err[2];
+    for (int k = 0; k < 2; ++k) {
+        int n = 50 << k;
+        HestonSolver solver(n, n / 2, n / 2, AdiScheme::HundsdorferVerwer, 1);
+        err[k] = std::abs(solver.price(put, kSkew) - exact);
+    }
+    EXPECT_GT(err[0] / err[1], 3.0);
+}
+
+// Rows and column blocks are solved identically on any thread.
+TEST(HestonSolver, ThreadCountDoesNotChangePrices) {
+    Option call(100, 110, 0.5, 0.02, 0.2, OptionType::Call);
+    HestonSolver serial(80, 40, 40, AdiScheme::HundsdorferVerwer, 1);
+    HestonSolver parallel(80, 40, 40, AdiScheme::HundsdorferVerwer, 3);
+    EXPECT_EQ(parallel.threads(), 3);
+    EXPECT_EQ(serial.price(call, kSkew), parallel.price(call, kSkew));
+    EXPECT_EQ(serial.values(), parallel.values());
+}
+
+// The spot and v0 are nodes, and the solution satisfies the boundary
+// conditions at S = 0 and v_max.
+TEST(HestonSolver, GridsAndBoundaries) {
+    HestonSolver solver(60, 30, 20, AdiScheme::CraigSneyd, 1);
+    Option put(95, 100, 1.0, 0.05, 0.2, OptionType::Put);
+    solver.price(put, kSkew);
+    const Grid& s = solver.spotGrid();
+    const Grid& v = solver.varianceGrid();
+    EXPECT_EQ(s.size(), 61);
+    EXPECT_EQ(v.size(), 31);
+    EXPECT_EQ(s.spot(s.findIndex(95.0)), 95.0);
+    EXPECT_EQ(v.spot(v.findIndex(kSkew.v0)), kSkew.v0);
+    EXPECT_DOUBLE_EQ(s.nodes().back(), 800.0);
+
+    const std::vector<double>& u = solver.values();
+    double disc = 100.0 * std::exp(-0.05);
+    for (int j = 0; j < v.size(); ++j)
+        EXPECT_DOUBLE_EQ(u[j * s.size()], disc);
+    for (int i = 0; i < s.size(); ++i)
+        EXPECT_DOUBLE_EQ(u[(v.size() - 1) * s.size() + i], disc);
+}
+
+TEST(HestonSolver, RejectsInvalidInput) {
+    HestonSolver solver(50, 25, 10, AdiScheme::Douglas, 1);
+    Option american(100, 100, 1.0, 0.05, 0.2, OptionType::Put, ExerciseType::American);
+    EXPECT_THROW(solver.price(american, kSkew), std::invalid_argument);
+    Option put(100, 100, 1.0, 0.05, 0.2, OptionType::Put);
+    EXPECT_THROW(solver.price(put, HestonParams{0.04, 1.5, 0.04, 0.3, -1.5}),
+                 std::invalid_argument);
+    EXPECT_THROW(solver.price(put, HestonParams{0.04, 0.0, 0.04, 0.3, 0.0}),
+                 std::invalid_argument);
+    EXPECT_THROW(HestonSolver(5, 25, 10), std::invalid_argument);
+    EXPECT_THROW(solver.setDomainMultiple(1.0), std::invalid_argument);
+}
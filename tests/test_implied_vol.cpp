@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "BlackScholes.hpp"
+#include "ImpliedVol.hpp"
+#include "PDESolver.hpp"
+
+// Black-Scholes prices at known volatilities invert back to them, from
+// deep in to deep out of the money, in a handful of prices.
+TEST(ImpliedVol, EuropeanRoundTrip) {
+    ImpliedVolSolver solver(1);
+    for (OptionType type : {OptionType::Call, OptionType::Put})
+        for (double T : {0.05, 0.5, 2.0})
+            for (double K : {60.0, 90.0, 100.0, 110.0, 150.0})
+                for (double sigma : {0.05, 0.2, 0.6, 1.5}) {
+                    Option option(100, K, T, 0.03, sigma, type, ExerciseType::European);
+                    double price = BlackScholes::price(option);
+                    // Time values below ~1e-10 of the spot carry no
+                    // information about the volatility.
+                    double X = K * std::exp(-0.03 * T);
+                    double intrinsic = std::max(type == OptionType::Call ? 100 - X : X - 100, 0.0);
+                    if (price - intrinsic < 1e-8)
+                        continue;
+                    ImpliedVolResult r = solver.solve(option, price);
+                    ASSERT_EQ(r.status, VolStatus::Converged)
+                        << "K=" << K << " T=" << T << " sigma=" << sigma;
+                    double vega = BlackScholes::vega(option);
+                    EXPECT_NEAR(r.vol, sigma, std::max(1e-9, 1e-13 / vega))
+                        << "K=" << K << " T=" << T;
+                    EXPECT_LE(r.iterations, 12) << "K=" << K << " T=" << T << " sigma=" << sigma;
+                }
+}
+
+TEST(ImpliedVol, NoArbitrageBounds) {
+    ImpliedVolSolver solver(1);
+    Option call(100, 90, 1.0, 0.05, 0.2, OptionType::Call, ExerciseType::European);
+    double X = 90 * std::exp(-0.05);
+    EXPECT_EQ(solver.solve(call, 100 - X).status, VolStatus::BelowBound);
+    EXPECT_EQ(solver.solve(call, 100.0).status, VolStatus::AboveBound);
+    EXPECT_TRUE(std::isnan(solver.solve(call, 5.0).vol));
+
+    Option put(100, 110, 1.0, 0.05, 0.2, OptionType::Put, ExerciseType::American);
+    EXPECT_EQ(solver.solve(put, 10.0).status, VolStatus::BelowBound);
+    EXPECT_EQ(solver.solve(put, 110.0).status, VolStatus::AboveBound);
+    EXPECT_EQ(solver.solve(put, -1.0).iterations, 0);
+}
+
+// On grids that do not move with sigma, the fixed-grid path is the
+// ordinary price to rounding; on Sinh grids it is the price on the grid
+// of the first call.
+TEST(ImpliedVol, PriceAtVolatilityMatchesPrice) {
+    for (GridType grid : {GridType::Uniform, GridType::Adaptive, GridType::LogUniform}) {
+        PDESolver a(200, 100, grid), b(200, 100, grid);
+        Option option(100, 105, 0.75, 0.04, 0.25, OptionType::Put, ExerciseType::American);
+        for (double sigma : {0.25, 0.1, 0.4}) {
+            Option at = option;
+            at.sigma = sigma;
+            EXPECT_NEAR(a.priceAtVolatility(option, sigma), b.price(at), 1e-10)
+                << static_cast<int>(grid) << " sigma=" << sigma;
+        }
+    }
+
+    PDESolver a(200, 100, GridType::Sinh), b(200, 100, GridType::Sinh);
+    Option option(100, 105, 0.75, 0.04, 0.25, OptionType::Call, ExerciseType::European);
+    EXPECT_NEAR(a.priceAtVolatility(option, 0.25), b.price(option), 1e-12);
+    Option at = option;
+    at.sigma = 0.3;
+    EXPECT_NEAR(a.priceAtVolatility(option, 0.3), b.price(at), 1e-2);
+
+    EXPECT_THROW(a.priceAtVolatility(option, 0.0), std::invalid_argument);
+}
+
+// A new domain multiple rebuilds the kept grid.
+TEST(ImpliedVol, PriceAtVolatilityFollowsDomain) {
+    PDESolver a(200, 100, GridType::Uniform), b(200, 100, GridType::Uniform);
+    Option option(100, 105, 0.75, 0.04, 0.25, OptionType::Put, ExerciseType::American);
+    a.priceAtVolatility(option, 0.25);
+    a.setDomainMultiple(5.0);
+    b.setDomainMultiple(5.0);
+    EXPECT_NEAR(a.priceAtVolatility(option, 0.25), b.price(option), 1e-10);
+    EXPECT_EQ(a.gridSize(), b.gridSize());
+}
+
+// On a grid that does not move with sigma, a price from the solver's own
+// discrete model inverts to its volatility in a few PDE solves.
+TEST(ImpliedVol, AmericanRoundTrip) {
+    PDESolver prototype(200, 200, GridType::Adaptive);
+    prototype.setRannacherSteps(2);
+    prototype.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+    ImpliedVolSolver solver(prototype, 1);
+    PDESolver reference = prototype;
+    for (OptionType type : {OptionType::Put, OptionType::Call})
+        for (double K : {80.0, 100.0, 125.0})
+            for (double sigma : {0.1, 0.3, 0.8}) {
+                Option option(100, K, 1.0, 0.05, sigma, type, ExerciseType::American);
+                double price = reference.price(option);
+                // Deep in the money at low vol, exercise is immediate and
+                // the price is the payoff.
+                if (price - option.payoff(100) < 1e-8)
+                    continue;
+                ImpliedVolResult r = solver.solve(option, price);
+                ASSERT_EQ(r.status, VolStatus::Converged) << "K=" << K << " sigma=" << sigma;
+                EXPECT_NEAR(r.vol, sigma, 1e-6) << "K=" << K << " sigma=" << sigma;
+                EXPECT_LE(r.iterations, 8) << "K=" << K << " sigma=" << sigma;
+            }
+}
+
+// Quotes from the ordinary pricer invert to within discretization error.
+TEST(ImpliedVol, AmericanMatchesPricer) {
+    ImpliedVolSolver solver(1);
+    PDESolver pricer(400, 400, GridType::Sinh);
+    pricer.setRannacherSteps(2);
+    for (double K : {90.0, 100.0, 110.0}) {
+        Option option(100, K, 0.5, 0.05, 0.35, OptionType::Put, ExerciseType::American);
+        ImpliedVolResult r = solver.solve(option, pricer.price(option));
+        ASSERT_EQ(r.status, VolStatus::Converged);
+        EXPECT_NEAR(r.vol, 0.35, 2e-3) << "K=" << K;
+    }
+}
+
+TEST(ImpliedVol, BatchIndependentOfThreads) {
+    std::vector<Option> options;
+    std::vector<double> prices;
+    for (int i = 0; i < 64; ++i) {
+        double K = 80.0 + i;
+        double sigma = 0.15 + 0.005 * i;
+        ExerciseType ex = i % 3 == 0 ? ExerciseType::American : ExerciseType::European;
+        OptionType type = i % 2 ? OptionType::Call : OptionType::Put;
+        Option option(100, K, 0.75, 0.03, sigma, type, ex);
+        options.push_back(option);
+        prices.push_back(BlackScholes::price(option) * (ex == ExerciseType::American ? 1.01 : 1.0));
+    }
+    std::vector<ImpliedVolResult> one = ImpliedVolSolver(1).solveBatch(options, prices);
+    std::vector<ImpliedVolResult> four = ImpliedVolSolver(4).solveBatch(options, prices);
+    for (std::size_t i = 0; i < options.size(); ++i) {
+        EXPECT_EQ(one[i].status, four[i].status) << i;
+        EXPECT_EQ(one[i].iterations, four[i].iterations) << i;
+        if (one[i].status == VolStatus::Converged)
+            EXPECT_EQ(one[i].vol, four[i].vol) << i;
+    }
+    EXPECT_THROW(ImpliedVolSolver(1).solveBatch(options, {1.0}), std::invalid_argument);
+}
+
+TEST(ImpliedVol, Configuration) {
+    ImpliedVolSolver solver(1);
+    EXPECT_THROW(solver.setTolerance(0.0, 1e-7), std::invalid_argument);
+    EXPECT_THROW(solver.setMaxIterations(0), std::invalid_argument);
+    solver.setMaxIterations(1);
+    solver.setTolerance(1e-15, 1e-7);
+    Option option(100, 140, 1.0, 0.0, 0.2, OptionType::Call, ExerciseType::European);
+    ImpliedVolResult r = solver.solve(option, BlackScholes::price(option));
+    EXPECT_EQ(r.status, VolStatus::NoConvergence);
+    EXPECT_EQ(r.iterations, 1);
+}
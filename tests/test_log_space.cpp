@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "BlackScholes.hpp"
+#include "PDESolver.hpp"
+#include "SetupCache.hpp"
+
+static const Option kContracts[] = {
+    Option(100, 100, 1.0, 0.05, 0.20, OptionType::Call),
+    Option(90, 100, 0.25, 0.05, 0.30, OptionType::Put),
+    Option(113, 100, 0.1, 0.05, 0.15, OptionType::Call),
+    Option(100, 100, 2.0, 0.03, 0.45, OptionType::Put),
+};
+
+TEST(LogSpace, MatchesBlackScholes) {
+    for (GridType grid : {GridType::LogUniform, GridType::LogSinh}) {
+        PDESolver solver(400, 400, grid);
+        solver.setRannacherSteps(2);
+        for (const Option& opt : kContracts)
+            EXPECT_NEAR(solver.priceEuropean(opt), BlackScholes::price(opt), 1e-3)
+                << static_cast<int>(grid) << " K " << opt.K << " T " << opt.T;
+    }
+}
+
+TEST(LogSpace, SecondOrderInSpace) {
+    Option opt(100, 100, 1.0, 0.05, 0.2, OptionType::Put);
+    double exact = BlackScholes::price(opt);
+    for (GridType grid : {GridType::LogUniform, GridType::LogSinh}) {
+        double err[2];
+        for (int k = 0; k < 2; ++k) {
+            PDESolver solver(100 << k, 2000, grid);
+            solver.setRannacherSteps(2);
+            err[k] = std::abs(solver.priceEuropean(opt) - exact);
+        }
+        EXPECT_GT(err[0] / err[1], 3.0) << static_cast<int>(grid);
+        EXPECT_LT(err[0] / err[1], 5.0) << static_cast<int>(grid);
+    }
+}
+
+// The domain is widened to keep a far-from-the-money spot well inside.
+TEST(LogSpace, SpotFarFromStrike) {
+    PDESolver solver(400, 200, GridType::LogUniform);
+    solver.setRannacherSteps(2);
+    for (double S : {30.0, 350.0}) {
+        Option put(S, 100, 1.0, 0.05, 0.25, OptionType::Put);
+        Option call(S, 100, 1.0, 0.05, 0.25, OptionType::Call);
+        EXPECT_NEAR(solver.priceEuropean(put), BlackScholes::price(put), 2e-3) << S;
+        EXPECT_NEAR(solver.priceEuropean(call), BlackScholes::price(call), 2e-3) << S;
+    }
+}
+
+TEST(LogSpace, AmericanAndGreeks) {
+    Option am(100, 100, 1.0, 0.05, 0.2, OptionType::Put, ExerciseType::American);
+    PDESolver reference(1600, 1600, GridType::Sinh);
+    reference.setRannacherSteps(2);
+    reference.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+    double ref = reference.priceAmerican(am);
+
+    Option eu(100, 100, 1.0, 0.05, 0.2, OptionType::Call);
+    for (GridType grid : {GridType::LogUniform, GridType::LogSinh}) {
+        PDESolver solver(400, 400, grid);
+        solver.setRannacherSteps(2);
+        solver.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+        EXPECT_NEAR(solver.priceAmerican(am), ref, 1e-3) << static_cast<int>(grid);
+
+        PricingResult g = solver.priceWithGreeks(eu);
+        EXPECT_NEAR(g.delta, BlackScholes::delta(eu), 1e-4);
+        EXPECT_NEAR(g.gamma, BlackScholes::gamma(eu), 1e-5);
+        EXPECT_NEAR(g.theta, BlackScholes::theta(eu), 1e-3);
+    }
+}
+
+// Log grids differ between strikes only by scale, so one cached setup
+// serves a whole strike ladder.
+TEST(LogSpace, CachedSetupServesEveryStrike) {
+    for (GridType grid : {GridType::LogUniform, GridType::LogSinh}) {
+        auto cache = std::make_shared<SetupCache>();
+        PDESolver cached(200, 100, grid), plain(200, 100, grid);
+        cached.setSetupCache(cache);
+        for (int k = 0; k < 9; ++k) {
+            Option opt(100, 80.0 + 5.0 * k, 1.0, 0.05, 0.2, OptionType::Put);
+            EXPECT_DOUBLE_EQ(cached.priceEuropean(opt), plain.priceEuropean(opt));
+        }
+        EXPECT_EQ(cache->stats().misses, 1u);
+        EXPECT_EQ(cache->stats().hits, 8u);
+    }
+}
+
+TEST(LogSpace, LanesMatchScalar) {
+    PDESolver solver(200, 100, GridType::LogUniform);
+    std::vector<Option> book;
+    for (int i = 0; i < 6; ++i)
+        book.emplace_back(90.0 + 4.0 * i, 100.0, 0.5, 0.05, 0.2,
+                          i % 2 ? OptionType::Put : OptionType::Call);
+    std::vector<double> out(book.size());
+    solver.priceEuropeanBatch(book.data(), book.size(), out.data());
+    for (std::size_t i = 0; i < book.size(); ++i)
+        EXPECT_NEAR(out[i], solver.priceEuropean(book[i]), 1e-12) << i;
+}
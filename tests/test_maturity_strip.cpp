@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "BlackScholes.hpp"
+#include "PDESolver.hpp"
+
+static const std::vector<double> kTenors = {1.0 / 12, 0.25, 0.5, 1.0};
+
+// A strip holding only the option's own maturity is an ordinary price.
+TEST(MaturityStrip, SingleMaturityMatchesPrice) {
+    Option eu(100, 100, 1.0, 0.05, 0.2, OptionType::Put);
+    Option am(100, 100, 1.0, 0.05, 0.2, OptionType::Put, ExerciseType::American);
+    for (GridType grid : {GridType::Uniform, GridType::Adaptive, GridType::Sinh}) {
+        PDESolver solver(200, 100, grid), plain(200, 100, grid);
+        solver.setRannacherSteps(2);
+        plain.setRannacherSteps(2);
+        for (const Option& opt : {eu, am}) {
+            std::vector<MaturitySnapshot> strip = solver.priceMaturities(opt, {1.0});
+            ASSERT_EQ(strip.size(), 1u);
+            EXPECT_DOUBLE_EQ(strip[0].price, plain.price(opt));
+            EXPECT_EQ(solver.lastSolveStats().steps, 100);
+        }
+    }
+}
+
+// Each tenor of a European strip is within discretization error of the
+// analytic price, with the snapshot surface agreeing at the spot.
+TEST(MaturityStrip, EuropeanStripMatchesBlackScholes) {
+    for (OptionType type : {OptionType::Call, OptionType::Put}) {
+        PDESolver solver(400, 400, GridType::Adaptive);
+        solver.setRannacherSteps(2);
+        Option opt(105, 100, 1.0, 0.05, 0.25, type);
+        std::vector<MaturitySnapshot> strip = solver.priceMaturities(opt, kTenors);
+        ASSERT_EQ(strip.size(), kTenors.size());
+        for (std::size_t i = 0; i < kTenors.size(); ++i) {
+            Option tenor(105, 100, kTenors[i], 0.05, 0.25, type);
+            EXPECT_EQ(strip[i].T, kTenors[i]);
+            EXPECT_NEAR(strip[i].price, BlackScholes::price(tenor), 1e-3) << kTenors[i];
+            EXPECT_DOUBLE_EQ(strip[i].surface.evaluate(105.0), strip[i].price);
+        }
+        EXPECT_EQ(solver.lastSolveStats().steps, 400);
+    }
+}
+
+// American tenors agree with separate solves on the same grid and time
+// steps, and within time-discretization error with adaptive steps.
+TEST(MaturityStrip, AmericanMatchesSeparateSolves) {
+    Option opt(95, 100, 1.0, 0.06, 0.3, OptionType::Put, ExerciseType::American);
+    PDESolver strip_solver(300, 300, GridType::Adaptive);
+    strip_solver.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+    strip_solver.setRannacherSteps(2);
+    PDESolver adaptive(strip_solver);
+    adaptive.setTimeTolerance(1e-5);
+    std::vector<MaturitySnapshot> strip = strip_solver.priceMaturities(opt, kTenors);
+    std::vector<MaturitySnapshot> graded = adaptive.priceMaturities(opt, kTenors);
+
+    for (std::size_t i = 0; i < kTenors.size(); ++i) {
+        Option tenor = opt;
+        tenor.T = kTenors[i];
+        PDESolver separate(300, std::max(10, static_cast<int>(300 * kTenors[i])),
+                           GridType::Adaptive);
+        separate.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+        separate.setRannacherSteps(2);
+        double expected = separate.priceAmerican(tenor);
+        EXPECT_NEAR(strip[i].price, expected, 1e-5) << kTenors[i];
+        EXPECT_NEAR(graded[i].price, expected, 2e-3) << kTenors[i];
+    }
+}
+
+TEST(MaturityStrip, OrderDuplicatesAndValidation) {
+    PDESolver solver(100, 100, true);
+    Option opt(100, 100, 1.0, 0.05, 0.2, OptionType::Call);
+    std::vector<MaturitySnapshot> strip = solver.priceMaturities(opt, {1.0, 0.25, 1.0, 0.5});
+    ASSERT_EQ(strip.size(), 4u);
+    EXPECT_EQ(strip[1].T, 0.25);
+    EXPECT_DOUBLE_EQ(strip[0].price, strip[2].price);
+    EXPECT_LT(strip[1].price, strip[3].price);
+    EXPECT_LT(strip[3].price, strip[0].price);
+
+    EXPECT_THROW(solver.priceMaturities(opt, {}), std::invalid_argument);
+    EXPECT_THROW(solver.priceMaturities(opt, {0.5, 0.0}), std::invalid_argument);
+    // A failed strip leaves the solver pricing normally.
+    PDESolver plain(100, 100, true);
+    EXPECT_DOUBLE_EQ(solver.priceEuropean(opt), plain.priceEuropean(opt));
+}
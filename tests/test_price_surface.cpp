@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "BlackScholes.hpp"
+#include "Grid.hpp"
+#include "PDESolver.hpp"
+#include "PriceSurface.hpp"
+
+// --- Lookup agrees with Grid::findIndex ---
+
+static void expectSameLookup(const Grid& g) {
+    std::vector<double> values(g.size(), 0.0);
+    PriceSurface surface(g.nodes(), values);
+    for (double S = -5.0; S <= 305.0; S += 0.173)
+        EXPECT_EQ(surface.locate(S), g.findIndex(S)) << S;
+    for (double S : g.nodes())   // exactly on nodes
+        EXPECT_EQ(surface.locate(S), g.findIndex(S)) << S;
+}
+
+TEST(PriceSurface, LocateUniform) {
+    expectSameLookup(UniformGrid(300.0, 100));
+}
+
+TEST(PriceSurface, LocateAdaptive) {
+    expectSameLookup(AdaptiveGrid(300.0, 200, 100.0));
+}
+
+TEST(PriceSurface, LocateManySegments) {
+    // Geometric spacing: every interval is its own run, exercising the
+    // binary-search fallback.
+    std::vector<double> nodes;
+    for (int i = 0; i <= 50; ++i)
+        nodes.push_back(std::pow(1.05, i) - 1.0);
+    PriceSurface surface(nodes, std::vector<double>(nodes.size(), 0.0));
+    for (int i = 0; i < 50; ++i)
+        EXPECT_EQ(surface.locate(0.5 * (nodes[i] + nodes[i + 1])), i);
+}
+
+// --- Evaluation ---
+
+TEST(PriceSurface, MatchesSolverAtSpot) {
+    Option opt(103.3, 100, 1.0, 0.05, 0.20, OptionType::Call);
+    PDESolver solver(200, 200, true);
+    PriceSurface surface = solver.priceSurface(opt);
+    EXPECT_DOUBLE_EQ(surface.evaluate(opt.S), solver.priceEuropean(opt));
+}
+
+TEST(PriceSurface, SpotLadderMatchesBlackScholes) {
+    PDESolver solver(200, 200, true);
+    Option base(100, 100, 1.0, 0.05, 0.20, OptionType::Put);
+    PriceSurface surface = solver.priceSurface(base);
+
+    std::vector<double> ladder;
+    for (double S = 80.0; S <= 120.0; S += 2.5)
+        ladder.push_back(S);
+    auto linear = surface.evaluate(ladder, Interpolation::Linear);
+    auto cubic  = surface.evaluate(ladder, Interpolation::Cubic);
+
+    double err_linear = 0.0, err_cubic = 0.0;
+    for (std::size_t k = 0; k < ladder.size(); ++k) {
+        double bs = BlackScholes::price(Option(ladder[k], 100, 1.0, 0.05, 0.20, OptionType::Put));
+        err_linear = std::max(err_linear, std::abs(linear[k] - bs));
+        err_cubic  = std::max(err_cubic,  std::abs(cubic[k] - bs));
+    }
+    EXPECT_LT(err_linear, 0.05);
+    EXPECT_LT(err_cubic, 0.05);
+    EXPECT_LE(err_cubic, err_linear);
+}
+
+TEST(PriceSurface, CubicReproducesNodesAndLines) {
+    std::vector<double> nodes = {0.0, 1.0, 1.5, 3.0, 4.0};
+    std::vector<double> values;
+    for (double x : nodes) values.push_back(2.0 * x + 1.0);
+    PriceSurface surface(nodes, values);
+    for (double x = 0.0; x <= 4.0; x += 0.1)
+        EXPECT_NEAR(surface.evaluate(x, Interpolation::Cubic), 2.0 * x + 1.0, 1e-12);
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+        EXPECT_DOUBLE_EQ(surface.evaluate(nodes[i], Interpolation::Cubic), values[i]);
+}
+
+TEST(PriceSurface, OutlivesSolverAndMoves) {
+    PriceSurface moved = [] {
+        PDESolver solver(100, 100, false);
+        return solver.priceSurface(Option(100, 100, 1.0, 0.05, 0.2, OptionType::Call));
+    }();
+    PriceSurface target = std::move(moved);
+    EXPECT_EQ(target.size(), 101);
+    EXPECT_GT(target.evaluate(100.0), 0.0);
+}
+
+TEST(PriceSurface, InvalidInputThrows) {
+    EXPECT_THROW(PriceSurface({1.0}, {1.0}), std::invalid_argument);
+    EXPECT_THROW(PriceSurface({1.0, 2.0}, {1.0}), std::invalid_argument);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "BatchPricer.hpp"
+#include "PDESolver.hpp"
+#include "Profiler.hpp"
+
+// Most of these need a build with -DPDE_INSTRUMENT=ON and are skipped
+// otherwise.
+
+static std::size_t count(const std::string& text, const std::string& what) {
+    std::size_t n = 0;
+    for (auto pos = text.find(what); pos != std::string::npos; pos = text.find(what, pos + 1))
+        ++n;
+    return n;
+}
+
+TEST(Profiler, DisabledRecordsNothing) {
+    if (instrument::enabled) GTEST_SKIP() << "built with PDE_INSTRUMENT";
+    auto profiler = std::make_shared<Profiler>();
+    PDESolver solver(100, 50, true);
+    solver.setProfiler(profiler);
+    solver.priceEuropean(Option(100, 100, 1.0, 0.05, 0.2, OptionType::Put));
+    EXPECT_EQ(solver.lastProfile().prices, 0u);
+    EXPECT_EQ(profiler->totals().prices, 0u);
+    EXPECT_EQ(profiler->events(), 0u);
+}
+
+TEST(Profiler, EuropeanPhasesAndCounters) {
+    if (!instrument::enabled) GTEST_SKIP() << "needs PDE_INSTRUMENT";
+    PDESolver solver(100, 50, true);
+    solver.priceEuropean(Option(100, 100, 1.0, 0.05, 0.2, OptionType::Put));
+    SolveProfile p = solver.lastProfile();
+    EXPECT_EQ(p.prices, 1u);
+    EXPECT_EQ(p.time_steps, 50u);
+    EXPECT_EQ(p.nodes, 50u * solver.gridSize());
+    EXPECT_EQ(p.exercised_nodes, 0u);
+    EXPECT_EQ(p.calls(Phase::Grid), 1u);
+    EXPECT_EQ(p.calls(Phase::Assembly), 1u);
+    EXPECT_EQ(p.calls(Phase::Factor), 1u);
+    EXPECT_EQ(p.calls(Phase::TimeLoop), 1u);
+    EXPECT_EQ(p.calls(Phase::Solve), 50u);
+    EXPECT_EQ(p.calls(Phase::Exercise), 0u);
+    EXPECT_GE(p.ns(Phase::TimeLoop), p.ns(Phase::Solve));
+}
+
+TEST(Profiler, AmericanCountsExercise) {
+    if (!instrument::enabled) GTEST_SKIP() << "needs PDE_INSTRUMENT";
+    Option am(100, 100, 1.0, 0.05, 0.2, OptionType::Put, ExerciseType::American);
+    for (AmericanMethod method : {AmericanMethod::Projection, AmericanMethod::BrennanSchwartz,
+                                  AmericanMethod::Penalty}) {
+        PDESolver solver(100, 50, true);
+        solver.setAmericanMethod(method);
+        solver.priceAmerican(am);
+        SolveProfile p = solver.lastProfile();
+        EXPECT_EQ(p.calls(Phase::Exercise), 50u);
+        // Deep in the money the put is exercised at every step.
+        EXPECT_GT(p.exercised_nodes, 50u * 10);
+        EXPECT_LT(p.exercised_nodes, p.nodes);
+    }
+}
+
+TEST(Profiler, AdaptiveCountsRefactorizations) {
+    if (!instrument::enabled) GTEST_SKIP() << "needs PDE_INSTRUMENT";
+    PDESolver solver(100, 1, GridType::Sinh);
+    solver.setTimeTolerance(1e-4);
+    solver.priceEuropean(Option(100, 100, 1.0, 0.05, 0.2, OptionType::Put));
+    SolveProfile p = solver.lastProfile();
+    EXPECT_EQ(p.calls(Phase::Factor), static_cast<std::uint64_t>(
+                                          solver.lastSolveStats().factorizations));
+    EXPECT_EQ(p.time_steps, static_cast<std::uint64_t>(solver.lastSolveStats().steps));
+}
+
+TEST(Profiler, AggregatesAcrossThreads) {
+    if (!instrument::enabled) GTEST_SKIP() << "needs PDE_INSTRUMENT";
+    std::vector<Option> book;
+    for (int i = 0; i < 40; ++i)
+        book.emplace_back(80.0 + i, 100, 1.0, 0.05, 0.2,
+                          i % 2 ? OptionType::Put : OptionType::Call);
+    auto profiler = std::make_shared<Profiler>();
+    PDESolver prototype(100, 20, true);
+    prototype.setProfiler(profiler);
+    BatchPricer(prototype, 4).priceBatch(book);
+
+    SolveProfile total = profiler->totals();
+    EXPECT_EQ(total.prices, book.size());
+    EXPECT_EQ(total.time_steps, 20u * book.size());
+    EXPECT_EQ(total.calls(Phase::Solve), 20u * book.size());
+    // price, grid, assembly, factor and time_loop per option
+    EXPECT_EQ(profiler->events(), 5u * book.size());
+
+    profiler->reset();
+    EXPECT_EQ(profiler->totals().prices, 0u);
+    EXPECT_EQ(profiler->events(), 0u);
+}
+
+TEST(Profiler, ChromeTrace) {
+    Profiler profiler(3);
+    SolveProfile one;
+    one.prices = 1;
+    std::vector<TraceEvent> events(2, TraceEvent{phaseName(Phase::TimeLoop), 0, 1500,
+                                                 std::this_thread::get_id(), 1000, 0, 7});
+    profiler.record(one, events);
+    profiler.record(one, events);   // one event over the limit
+    EXPECT_EQ(profiler.totals().prices, 2u);
+    EXPECT_EQ(profiler.events(), 3u);
+    EXPECT_EQ(profiler.droppedEvents(), 1u);
+
+    std::ostringstream out;
+    profiler.writeChromeTrace(out);
+    std::string json = out.str();
+    EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(count(json, "\"ph\":\"X\""), 3u);
+    EXPECT_EQ(count(json, "\"name\":\"time_loop\""), 3u);
+    EXPECT_NE(json.find("\"steps\":7"), std::string::npos);
+    EXPECT_NE(json.find("\"dropped_events\":1"), std::string::npos);
+    EXPECT_THROW(profiler.writeChromeTrace("/nonexistent/dir/trace.json"), std::runtime_error);
+}
+
+// Events 1 us apart, some 1000 s into the trace, keep their order and
+// spacing.
+TEST(Profiler, ChromeTraceKeepsLateTimestamps) {
+    Profiler profiler;
+    std::uint64_t late = instrument::nowNs() + 1000000000000ull;
+    std::vector<TraceEvent> events;
+    for (std::uint64_t k = 0; k < 3; ++k)
+        events.push_back(TraceEvent{phaseName(Phase::Grid), late + 1000 * k, 250,
+                                    std::this_thread::get_id(), 0, 0, 0});
+    profiler.record(SolveProfile(), events);
+
+    std::ostringstream out;
+    profiler.writeChromeTrace(out);
+    std::string json = out.str();
+    std::vector<double> ts;
+    for (auto pos = json.find("\"ts\":"); pos != std::string::npos;
+         pos = json.find("\"ts\":", pos + 1))
+        ts.push_back(std::stod(json.substr(pos + 5)));
+    ASSERT_EQ(ts.size(), 3u);
+    EXPECT_NEAR(ts[1] - ts[0], 1.0, 1e-6);
+    EXPECT_NEAR(ts[2] - ts[1], 1.0, 1e-6);
+    EXPECT_NE(json.find("\"dur\":0.250"), std::string::npos);
+}
+
+TEST(Profiler, SolverTraceEvents) {
+    if (!instrument::enabled) GTEST_SKIP() << "needs PDE_INSTRUMENT";
+    auto profiler = std::make_shared<Profiler>();
+    PDESolver solver(100, 30, true);
+    solver.setProfiler(profiler);
+    solver.priceEuropean(Option(100, 100, 1.0, 0.05, 0.2, OptionType::Call));
+
+    std::ostringstream out;
+    profiler->writeChromeTrace(out);
+    std::string json = out.str();
+    for (const char* name : {"price", "grid", "assembly", "factor", "time_loop"})
+        EXPECT_EQ(count(json, std::string("\"name\":\"") + name + "\""), 1u) << name;
+    EXPECT_NE(json.find("\"steps\":30"), std::string::npos);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "Option.hpp"
+#include "PDESolver.hpp"
+#include "BlackScholes.hpp"
+
+// Short-dated ATM put with large time steps relative to the fine spacing
+// at the strike: the regime where Crank-Nicolson rings at the kink.
+static Option shortPut() {
+    return Option(100, 100, 0.25, 0.05, 0.20, OptionType::Put);
+}
+
+TEST(Rannacher, DefaultIsPureCrankNicolson) {
+    PDESolver solver(100, 100, true);
+    EXPECT_EQ(solver.rannacherSteps(), 0);
+    EXPECT_THROW(solver.setRannacherSteps(-1), std::invalid_argument);
+}
+
+TEST(Rannacher, DampsGammaOscillation) {
+    Option opt = shortPut();
+    double exact = BlackScholes::gamma(opt);
+
+    PDESolver solver(400, 10, true);
+    double cn_err = std::abs(solver.priceWithGreeks(opt).gamma - exact);
+    solver.setRannacherSteps(2);
+    double ran_err = std::abs(solver.priceWithGreeks(opt).gamma - exact);
+
+    EXPECT_GT(cn_err, 0.1);      // CN gamma is off by O(1) here
+    EXPECT_LT(ran_err, 1e-3);
+}
+
+TEST(Rannacher, MoreStepsThanGridIsAllImplicit) {
+    // Asking for more start-up steps than exist is not an error.
+    Option opt = shortPut();
+    PDESolver solver(200, 4, true);
+    solver.setRannacherSteps(10);
+    EXPECT_NEAR(solver.priceEuropean(opt), BlackScholes::price(opt), 0.1);
+}
+
+TEST(Rannacher, BatchMatchesScalar) {
+    std::vector<Option> book;
+    for (int k = 0; k < 6; ++k)
+        book.emplace_back(90 + 4 * k, 100, 0.25, 0.05, 0.2,
+                          k % 2 ? OptionType::Put : OptionType::Call);
+    PDESolver solver(200, 10, true);
+    solver.setRannacherSteps(2);
+    std::vector<double> out(book.size());
+    solver.priceEuropeanBatch(book.data(), book.size(), out.data());
+    for (std::size_t i = 0; i < book.size(); ++i)
+        EXPECT_NEAR(out[i], solver.priceEuropean(book[i]), 1e-12);
+}
+
+TEST(Rannacher, AmericanStillMatchesReference) {
+    Option am(100, 100, 1.0, 0.05, 0.20, OptionType::Put, ExerciseType::American);
+    PDESolver solver(200, 50, true);
+    solver.setRannacherSteps(2);
+    solver.setAmericanMethod(AmericanMethod::BrennanSchwartz);
+    EXPECT_NEAR(solver.priceAmerican(am), 6.0904, 0.01);
+}
+
+// --- Richardson extrapolation ---
+
+TEST(Richardson, ReachesOneBasisPointOnCoarseGrid) {
+    Option opt = shortPut();
+    double exact = BlackScholes::price(opt);
+
+    PDESolver solver(200, 20, true);
+    solver.setRannacherSteps(2);
+    double single = std::abs(solver.priceEuropean(opt) - exact);
+    double extrapolated = std::abs(solver.priceExtrapolated(opt) - exact);
+
+    EXPECT_GT(single, 1e-3);
+    EXPECT_LT(extrapolated, 1e-4);
+}
+
+TEST(Richardson, ConvergesFasterThanSecondOrder) {
+    Option opt(100, 100, 1.0, 0.05, 0.20, OptionType::Call);
+    double exact = BlackScholes::price(opt);
+    PDESolver coarse(100, 100, true), fine(200, 200, true);
+    double e_coarse = std::abs(coarse.priceExtrapolated(opt) - exact);
+    double e_fine = std::abs(fine.priceExtrapolated(opt) - exact);
+    EXPECT_GT(e_coarse / e_fine, 8.0);
+}
+
+TEST(Richardson, LeavesGridSettingsUnchanged) {
+    Option opt = shortPut();
+    PDESolver solver(100, 20, true);
+    double before = solver.priceEuropean(opt);
+    solver.priceExtrapolated(opt);
+    EXPECT_DOUBLE_EQ(solver.priceEuropean(opt), before);
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "LatencyHistogram.hpp"
+#include "PDESolver.hpp"
+#include "PricingClient.hpp"
+#include "PricingServer.hpp"
+
+static std::string socketPath(const std::string& name) {
+    return ::testing::TempDir() + "pde_server_" + name + ".sock";
+}
+
+TEST(LatencyHistogram, Percentiles) {
+    LatencyHistogram h;
+    EXPECT_EQ(h.percentile(0.5), 0.0);
+    for (std::uint64_t v = 1; v <= 100000; ++v)
+        h.record(v);
+    EXPECT_EQ(h.count(), 100000u);
+    EXPECT_EQ(h.max(), 100000u);
+    EXPECT_NEAR(h.percentile(0.5), 50000.0, 50000.0 * 0.016);
+    EXPECT_NEAR(h.percentile(0.99), 99000.0, 99000.0 * 0.016);
+    EXPECT_NEAR(h.percentile(0.999), 99900.0, 99900.0 * 0.016);
+    EXPECT_LE(h.percentile(1.0), 100000.0);
+
+    LatencyHistogram small;
+    for (std::uint64_t v : {3, 3, 7})
+        small.record(v);
+    EXPECT_EQ(small.percentile(0.5), 3.0);   // exact below 32 ns
+    h.merge(small);
+    EXPECT_EQ(h.count(), 100003u);
+    h.reset();
+    EXPECT_EQ(h.count(), 0u);
+}
+
+// Prices through the server are the solver's own: Americans exactly,
+// Europeans through the lane path to rounding.
+TEST(PricingServer, PricesMatchSolver) {
+    PDESolver prototype(100, 50, GridType::Sinh);
+    PricingServer server(prototype, ServerConfig{2, 64, std::chrono::microseconds(200), 1024});
+    std::string path = socketPath("prices");
+    server.listenUnix(path);
+    PricingClient client(path);
+
+    std::vector<Option> options;
+    for (int i = 0; i < 24; ++i)
+        options.emplace_back(100.0, 85.0 + 2.5 * i, 0.5 + 0.1 * (i % 3), 0.04, 0.25,
+                             i % 2 ? OptionType::Call : OptionType::Put,
+                             i % 4 == 0 ? ExerciseType::American : ExerciseType::European);
+    for (std::size_t i = 0; i < options.size(); ++i)
+        client.send(1000 + i, options[i]);
+    std::vector<double> got(options.size(), -1.0);
+    for (std::size_t i = 0; i < options.size(); ++i) {
+        PriceReply reply = client.receive();
+        ASSERT_EQ(reply.status, PriceStatus::Ok);
+        got.at(reply.id - 1000) = reply.price;
+    }
+    PDESolver reference = prototype;
+    for (std::size_t i = 0; i < options.size(); ++i)
+        EXPECT_NEAR(got[i], reference.price(options[i]), 1e-11) << i;
+
+    // Pipelined requests arrive together and are batched.
+    ServerStats stats = server.stats();
+    EXPECT_EQ(stats.requests, options.size());
+    EXPECT_EQ(stats.priced, options.size());
+    EXPECT_LT(stats.batches, options.size());
+    EXPECT_GT(stats.p99_us, 0.0);
+    EXPECT_GE(stats.p999_us, stats.p50_us);
+}
+
+TEST(PricingServer, InvalidAndStats) {
+    PricingServer server(PDESolver(50, 25), ServerConfig{1, 8, std::chrono::microseconds(0), 64});
+    int port = server.listenTcp(0);
+    PricingClient client("127.0.0.1", port);
+
+    Option bad(100, 100, 1, 0.05, 0.2, OptionType::Put);
+    bad.sigma = -0.2;
+    PriceReply reply = client.price(bad);
+    EXPECT_EQ(reply.status, PriceStatus::Invalid);
+    EXPECT_TRUE(std::isnan(reply.price));
+    reply = client.price(Option(100, 100, 1, 0.05, 0.2, OptionType::Put));
+    EXPECT_EQ(reply.status, PriceStatus::Ok);
+
+    std::string json = client.stats();
+    EXPECT_NE(json.find("\"requests\": 2"), std::string::npos) << json;
+    EXPECT_NE(json.find("\"invalid\": 1"), std::string::npos) << json;
+    EXPECT_NE(json.find("\"p999\""), std::string::npos) << json;
+    EXPECT_NE(json.find("\"connections\": 1"), std::string::npos) << json;
+}
+
+// With a long batch window, a 1 us deadline has passed when pricing
+// starts; without a deadline the same request is priced.
+TEST(PricingServer, Deadlines) {
+    PricingServer server(PDESolver(50, 25),
+                         ServerConfig{1, 64, std::chrono::microseconds(20000), 64});
+    std::string path = socketPath("deadline");
+    server.listenUnix(path);
+    PricingClient client(path);
+    Option option(100, 100, 1, 0.05, 0.2, OptionType::Call);
+    client.send(1, option, 1);
+    client.send(2, option, 0);
+    for (int i = 0; i < 2; ++i) {
+        PriceReply reply = client.receive();
+        EXPECT_EQ(reply.status, reply.id == 1 ? PriceStatus::DeadlineExceeded : PriceStatus::Ok);
+    }
+    EXPECT_EQ(server.stats().expired, 1u);
+}
+
+// Beyond max_queue waiting requests, the rest are turned away at once.
+TEST(PricingServer, Overload) {
+    PricingServer server(PDESolver(50, 25),
+                         ServerConfig{1, 64, std::chrono::microseconds(50000), 2});
+    std::string path = socketPath("overload");
+    server.listenUnix(path);
+    PricingClient client(path);
+    Option option(100, 100, 1, 0.05, 0.2, OptionType::Call);
+    for (int i = 0; i < 10; ++i)
+        client.send(i, option);
+    int ok = 0, overloaded = 0;
+    for (int i = 0; i < 10; ++i) {
+        PriceReply reply = client.receive();
+        ok += reply.status == PriceStatus::Ok;
+        overloaded += reply.status == PriceStatus::Overloaded;
+    }
+    EXPECT_EQ(ok + overloaded, 10);
+    EXPECT_GE(overloaded, 1);
+    EXPECT_EQ(server.stats().overloaded, static_cast<std::uint64_t>(overloaded));
+}
+
+// A client that sends but never reads is dropped once max_outbound bytes
+// of replies are waiting for it; others are still served, and stop()
+// does not wait on it.
+TEST(PricingServer, DropsClientThatNeverReads) {
+    PricingServer server(PDESolver(50, 25),
+                         ServerConfig{1, 64, std::chrono::microseconds(0), 65536, 4096});
+    std::string path = socketPath("slow");
+    server.listenUnix(path);
+
+    int slow = protocol::connectUnix(path);
+    Option option(100, 100, 1, 0.05, 0.2, OptionType::Call);
+    char frame[protocol::kLengthSize + protocol::kPriceRequestSize];
+    for (int i = 0; i < 20000; ++i) {
+        protocol::encodeRequest(i, 0, option, frame);
+        if (::send(slow, frame, sizeof(frame), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(frame)))
+            break;   // dropped already
+    }
+    auto until = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (server.stats().dropped == 0 && std::chrono::steady_clock::now() < until)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(server.stats().dropped, 1u);
+
+    PricingClient client(path);
+    EXPECT_EQ(client.price(option).status, PriceStatus::Ok);
+    server.stop();
+    ::close(slow);
+}
+
+TEST(PricingServer, LoadGenerator) {
+    PricingServer server(PDESolver(50, 25));
+    std::string path = socketPath("load");
+    server.listenUnix(path);
+    LoadConfig config;
+    config.unix_path = path;
+    config.connections = 3;
+    config.in_flight = 4;
+    config.requests = 300;
+    std::vector<Option> book;
+    for (int i = 0; i < 10; ++i)
+        book.emplace_back(100, 90 + 2 * i, 1, 0.05, 0.2, OptionType::Put, ExerciseType::American);
+    LoadReport report = runLoad(config, book);
+    EXPECT_EQ(report.ok, 300u);
+    EXPECT_EQ(report.latency.count(), 300u);
+    EXPECT_GT(report.requestsPerSecond(), 0.0);
+    EXPECT_EQ(server.stats().priced, 300u);
+
+    server.stop();
+    EXPECT_THROW(PricingClient client(path), std::runtime_error);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "BatchPricer.hpp"
+#include "PDESolver.hpp"
+#include "SetupCache.hpp"
+
+static SetupKey keyFor(double K) {
+    return {GridType::Uniform, 100, K, 3.0 * K, 0.2, 0.05, 0.01,
+            Elimination::Forward, 0.0, 0.0};
+}
+
+TEST(SetupCache, RepeatedShapeSkipsSetup) {
+    auto cache = std::make_shared<SetupCache>(8);
+    PDESolver cached(200, 100, GridType::Adaptive);
+    cached.setSetupCache(cache);
+    PDESolver plain(200, 100, GridType::Adaptive);
+
+    for (int k = 0; k < 9; ++k) {
+        Option opt(80.0 + 5.0 * k, 100, 1.0, 0.05, 0.2, OptionType::Put);
+        EXPECT_DOUBLE_EQ(cached.priceEuropean(opt), plain.priceEuropean(opt));
+    }
+    SetupCacheStats stats = cache->stats();
+    EXPECT_EQ(stats.misses, 1u);   // the grid does not depend on the spot
+    EXPECT_EQ(stats.hits, 8u);
+    EXPECT_EQ(stats.size, 1u);
+}
+
+// A hit reuses the factored LHS, so the price factors nothing.
+TEST(SetupCache, HitCountsNoFactorization) {
+    PDESolver solver(200, 100, GridType::Adaptive);
+    solver.setSetupCache(std::make_shared<SetupCache>(8));
+    Option opt(100, 100, 1.0, 0.05, 0.2, OptionType::Put);
+    solver.priceEuropean(opt);
+    EXPECT_EQ(solver.lastSolveStats().factorizations, 1);
+    solver.priceEuropean(opt);
+    EXPECT_EQ(solver.lastSolveStats().factorizations, 0);
+    EXPECT_EQ(solver.lastSolveStats().steps, 100);
+}
+
+TEST(SetupCache, SinhGridKeysOnSpot) {
+    auto cache = std::make_shared<SetupCache>();
+    PDESolver solver(100, 50, GridType::Sinh);
+    solver.setSetupCache(cache);
+    PDESolver plain(100, 50, GridType::Sinh);
+
+    for (double S : {95.0, 105.0, 95.0}) {
+        Option opt(S, 100, 0.5, 0.05, 0.25, OptionType::Call);
+        EXPECT_DOUBLE_EQ(solver.priceEuropean(opt), plain.priceEuropean(opt));
+    }
+    EXPECT_EQ(cache->stats().misses, 2u);
+    EXPECT_EQ(cache->stats().hits, 1u);
+}
+
+TEST(SetupCache, AmericanMethodsAndGreeks) {
+    // A Brennan-Schwartz put is factored bottom-up: it must not share the
+    // European put's entry.
+    auto cache = std::make_shared<SetupCache>();
+    Option eu(100, 100, 1.0, 0.05, 0.2, OptionType::Put);
+    Option am(100, 100, 1.0, 0.05, 0.2, OptionType::Put, ExerciseType::American);
+    for (AmericanMethod method : {AmericanMethod::Projection, AmericanMethod::BrennanSchwartz,
+                                  AmericanMethod::Penalty, AmericanMethod::PSOR}) {
+        PDESolver solver(100, 100, true), plain(100, 100, true);
+        solver.setSetupCache(cache);
+        solver.setAmericanMethod(method);
+        solver.setRannacherSteps(2);
+        plain.setAmericanMethod(method);
+        plain.setRannacherSteps(2);
+        EXPECT_DOUBLE_EQ(solver.priceEuropean(eu), plain.priceEuropean(eu));
+        EXPECT_DOUBLE_EQ(solver.priceAmerican(am), plain.priceAmerican(am));
+        PricingResult g = solver.priceWithGreeks(am), h = plain.priceWithGreeks(am);
+        EXPECT_DOUBLE_EQ(g.delta, h.delta);
+        EXPECT_DOUBLE_EQ(g.theta, h.theta);
+    }
+    EXPECT_EQ(cache->stats().size, 2u);
+}
+
+TEST(SetupCache, EvictsLeastRecentlyUsed) {
+    SetupCache cache(2);
+    auto setup = std::make_shared<const SolverSetup>();
+    cache.insert(keyFor(90), setup);
+    cache.insert(keyFor(100), setup);
+    EXPECT_NE(cache.find(keyFor(90)), nullptr);    // 90 is now most recent
+    cache.insert(keyFor(110), setup);              // evicts 100
+    EXPECT_EQ(cache.find(keyFor(100)), nullptr);
+    EXPECT_NE(cache.find(keyFor(90)), nullptr);
+    EXPECT_NE(cache.find(keyFor(110)), nullptr);
+
+    SetupCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 3u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.size, 2u);
+
+    cache.clear();
+    EXPECT_EQ(cache.stats().size, 0u);
+    EXPECT_THROW(SetupCache(0), std::invalid_argument);
+}
+
+TEST(SetupCache, AdaptiveTimeBypassesCache) {
+    auto cache = std::make_shared<SetupCache>();
+    PDESolver solver(100, 1, true);
+    solver.setSetupCache(cache);
+    solver.setTimeTolerance(1e-4);
+    solver.priceEuropean(Option(100, 100, 1.0, 0.05, 0.2, OptionType::Put));
+    EXPECT_EQ(cache->stats().hits + cache->stats().misses, 0u);
+}
+
+TEST(SetupCache, SharedAcrossBatchThreads) {
+    std::vector<Option> book;
+    for (int i = 0; i < 200; ++i)
+        book.emplace_back(80.0 + 0.2 * i, 90.0 + 10.0 * (i % 3), 1.0, 0.05, 0.2,
+                          i % 2 ? OptionType::Put : OptionType::Call,
+                          i % 5 ? ExerciseType::European : ExerciseType::American);
+
+    PDESolver prototype(100, 50, true);
+    std::vector<double> expected = BatchPricer(prototype, 1).priceBatch(book);
+
+    auto cache = std::make_shared<SetupCache>();
+    prototype.setSetupCache(cache);
+    BatchPricer pricer(prototype, 4);
+    std::vector<double> prices = pricer.priceBatch(book);
+    for (std::size_t i = 0; i < book.size(); ++i)
+        EXPECT_DOUBLE_EQ(prices[i], expected[i]);
+
+    // Three strikes; Projection Americans share the European entries.
+    SetupCacheStats stats = cache->stats();
+    EXPECT_EQ(stats.hits + stats.misses, book.size());
+    EXPECT_EQ(stats.size, 3u);
+    EXPECT_LE(stats.misses, 3u * pricer.threads());
+}
@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "PartitionedTridiagonal.hpp"
+#include "Tridiagonal.hpp"
+
+// Diagonally dominant test system with non-constant diagonals.
+static void makeSystem(int n, std::vector<double>& a, std::vector<double>& b,
+                       std::vector<double>& c, std::vector<double>& d) {
+    a.resize(n); b.resize(n); c.resize(n); d.resize(n);
+    for (int i = 0; i < n; ++i) {
+        a[i] = -0.3 - 0.01 * i;
+        b[i] = 2.0 + 0.05 * i;
+        c[i] = -0.7 + 0.002 * i;
+        d[i] = std::sin(0.1 * i);
+    }
+}
+
+// --- Thomas algorithm ---
+
+TEST(Tridiagonal, ThomasResidual) {
+    std::vector<double> a, b, c, d, x;
+    makeSystem(50, a, b, c, d);
+    solveTridiagonal(a, b, c, d, x);
+    for (int i = 0; i < 50; ++i) {
+        double Ax = b[i] * x[i];
+        if (i > 0)  Ax += a[i] * x[i - 1];
+        if (i < 49) Ax += c[i] * x[i + 1];
+        EXPECT_NEAR(Ax, d[i], 1e-13);
+    }
+}
+
+// --- Pre-factored solve ---
+
+TEST(Tridiagonal, FactoredMatchesThomas) {
+    std::vector<double> a, b, c, d, x_thomas, x_lu;
+    makeSystem(50, a, b, c, d);
+    solveTridiagonal(a, b, c, d, x_thomas);
+    TridiagonalLU lu;
+    lu.factor(a, b, c);
+    lu.solve(d, x_lu);
+    for (int i = 0; i < 50; ++i)
+        EXPECT_NEAR(x_lu[i], x_thomas[i], 1e-14);
+}
+
+TEST(Tridiagonal, FactoredSolveInPlace) {
+    std::vector<double> a, b, c, d, x;
+    makeSystem(30, a, b, c, d);
+    TridiagonalLU lu;
+    lu.factor(a, b, c);
+    lu.solve(d, x);
+    lu.solve(d, d);  // rhs and solution share storage
+    for (int i = 0; i < 30; ++i)
+        EXPECT_DOUBLE_EQ(d[i], x[i]);
+}
+
+// --- Fused product solve ---
+
+TEST(Tridiagonal, ProductMatchesExplicitRhs) {
+    int n = 40;
+    std::vector<double> a, b, c, d, bl(n), bd(n), bu(n);
+    makeSystem(n, a, b, c, d);
+    for (int i = 0; i < n; ++i) {
+        bl[i] = 0.2 + 0.01 * i;
+        bd[i] = 0.5 - 0.003 * i;
+        bu[i] = 0.3 * std::cos(0.2 * i);
+    }
+    std::vector<double> rhs(n);
+    for (int i = 0; i < n; ++i) {
+        rhs[i] = bd[i] * d[i];
+        if (i > 0)     rhs[i] += bl[i] * d[i - 1];
+        if (i < n - 1) rhs[i] += bu[i] * d[i + 1];
+    }
+    for (Elimination order : {Elimination::Forward, Elimination::Backward}) {
+        TridiagonalLU lu;
+        lu.factor(a, b, c, order);
+        std::vector<double> expected, x, v = d;
+        lu.solve(rhs, expected);
+        lu.solveProduct(bl.data(), bd.data(), bu.data(), d, x);
+        lu.solveProduct(bl.data(), bd.data(), bu.data(), v, v);  // in place
+        for (int i = 0; i < n; ++i) {
+            EXPECT_NEAR(x[i], expected[i], 1e-14);
+            EXPECT_DOUBLE_EQ(v[i], x[i]);
+        }
+    }
+}
+
+// Five right-hand sides side by side in a row stride of 7, in place.
+TEST(Tridiagonal, ColumnsMatchSolve) {
+    int n = 30, count = 5, stride = 7;
+    std::vector<double> a, b, c, d;
+    makeSystem(n, a, b, c, d);
+    for (Elimination order : {Elimination::Forward, Elimination::Backward}) {
+        TridiagonalLU lu;
+        lu.factor(a, b, c, order);
+        std::vector<double> block(n * stride, -1.0);
+        for (int i = 0; i < n; ++i)
+            for (int l = 0; l < count; ++l)
+                block[i * stride + l] = d[i] * (1.0 + l);
+        lu.solveColumns(block.data(), stride, count);
+        for (int l = 0; l < count; ++l) {
+            std::vector<double> rhs(n), x;
+            for (int i = 0; i < n; ++i)
+                rhs[i] = d[i] * (1.0 + l);
+            lu.solve(rhs, x);
+            for (int i = 0; i < n; ++i)
+                EXPECT_EQ(block[i * stride + l], x[i]);
+        }
+        for (int i = 0; i < n; ++i)
+            EXPECT_EQ(block[i * stride + count], -1.0);   // outside the block
+    }
+}
+
+TEST(Tridiagonal, InconsistentSizesThrow) {
+    std::vector<double> a(5), b(6), c(6);
+    TridiagonalLU lu;
+    EXPECT_THROW(lu.factor(a, b, c), std::invalid_argument);
+}
+
+// --- Lane-interleaved solve ---
+
+TEST(Tridiagonal, LanesMatchScalarPerSystem) {
+    constexpr int W = LaneTridiagonalLU::lanes;
+    int n = 40;
+    std::vector<double> A(n * W), B(n * W), C(n * W), D(n * W), X;
+    std::vector<std::vector<double>> expected(W);
+    for (int l = 0; l < W; ++l) {
+        std::vector<double> a, b, c, d;
+        makeSystem(n, a, b, c, d);
+        for (int i = 0; i < n; ++i) {
+            // Make every lane a different system.
+            b[i] += 0.1 * l;
+            d[i] += l;
+            A[i * W + l] = a[i];
+            B[i * W + l] = b[i];
+            C[i * W + l] = c[i];
+            D[i * W + l] = d[i];
+        }
+        TridiagonalLU lu;
+        lu.factor(a, b, c);
+        lu.solve(d, expected[l]);
+    }
+    LaneTridiagonalLU lanes;
+    lanes.factor(A, B, C);
+    lanes.solve(D, X);
+    EXPECT_EQ(lanes.size(), n);
+    for (int l = 0; l < W; ++l)
+        for (int i = 0; i < n; ++i)
+            EXPECT_NEAR(X[i * W + l], expected[l][i], 1e-14);
+}
+
+TEST(Tridiagonal, LanesRejectPartialRows) {
+    std::vector<double> v(LaneTridiagonalLU::lanes * 3 + 1, 1.0);
+    LaneTridiagonalLU lanes;
+    EXPECT_THROW(lanes.factor(v, v, v), std::invalid_argument);
+}
+
+// --- Single precision ---
+
+// The float LU is factored in double and rounded once, so on a well
+// conditioned system it agrees with the double solve to float precision,
+// in the scalar and in the lane solve alike.
+TEST(Tridiagonal, SingleMatchesDouble) {
+    int n = 60;
+    std::vector<double> a, b, c, d, x;
+    makeSystem(n, a, b, c, d);
+    TridiagonalLU lu;
+    lu.factor(a, b, c);
+    lu.solve(d, x);
+
+    BasicTridiagonalLU<float> lu_single;
+    lu_single.factor(a, b, c);
+    std::vector<float> d_single(d.begin(), d.end()), x_single;
+    lu_single.solve(d_single, x_single);
+    for (int i = 0; i < n; ++i)
+        EXPECT_NEAR(x_single[i], x[i], 1e-6);
+
+    constexpr int W = BasicLaneTridiagonalLU<float>::lanes;
+    std::vector<double> A(n * W), B(n * W), C(n * W);
+    std::vector<float> D(n * W), X;
+    for (int l = 0; l < W; ++l)
+        for (int i = 0; i < n; ++i) {
+            A[i * W + l] = a[i];
+            B[i * W + l] = b[i];
+            C[i * W + l] = c[i];
+            D[i * W + l] = static_cast<float>(d[i]);
+        }
+    BasicLaneTridiagonalLU<float> lanes;
+    lanes.factor(A, B, C);
+    lanes.solve(D, X);
+    for (int l = 0; l < W; ++l)
+        for (int i = 0; i < n; ++i)
+            EXPECT_NEAR(X[i * W + l], x[i], 1e-6);
+}
+
+// --- Partitioned solve ---
+
+// Sizes with equal and unequal block lengths, a partial last group of
+// blocks, solved directly and through B v, in place, with and without a
+// pool: all agree with Thomas to rounding and with each other exactly.
+TEST(Tridiagonal, PartitionedMatchesThomas) {
+    WorkStealingPool pool(3);
+    for (int n : {1026, 1027, 2100, 5003}) {
+        std::vector<double> a, b, c, d, bl(n), bd(n), bu(n);
+        makeSystem(n, a, b, c, d);
+        for (int i = 0; i < n; ++i) {
+            bl[i] = 0.2 + 0.01 * i;
+            bd[i] = 0.5 - 0.003 * i;
+            bu[i] = 0.3 * std::cos(0.2 * i);
+        }
+        TridiagonalLU lu;
+        lu.factor(a, b, c);
+        PartitionedTridiagonalLU part;
+        part.factor(a, b, c);
+        EXPECT_EQ(part.size(), n);
+        EXPECT_EQ(part.blocks(), n / (PartitionedTridiagonalLU::kBlockRows + 1));
+
+        std::vector<double> expected, expected_product, work;
+        lu.solve(d, expected);
+        lu.solveProduct(bl.data(), bd.data(), bu.data(), d, expected_product);
+
+        std::vector<double> x, y = d, z = d;
+        part.solve(d, x, work);
+        part.solve(y, y, work, &pool);   // in place
+        part.solveProduct(bl.data(), bd.data(), bu.data(), z, z, work, &pool);
+        for (int i = 0; i < n; ++i) {
+            EXPECT_NEAR(x[i], expected[i], 1e-13 * (1.0 + std::abs(expected[i])));
+            EXPECT_EQ(y[i], x[i]);
+            EXPECT_NEAR(z[i], expected_product[i],
+                        1e-13 * (1.0 + std::abs(expected_product[i])));
+        }
+    }
+}
+
+TEST(Tridiagonal, PartitionedRejectsSmallSystems) {
+    std::vector<double> v(2 * PartitionedTridiagonalLU::kBlockRows + 1, 1.0), w(3, 1.0);
+    PartitionedTridiagonalLU part;
+    EXPECT_THROW(part.factor(v, v, v), std::invalid_argument);
+    EXPECT_THROW(part.factor(w, v, v), std::invalid_argument);
+    EXPECT_EQ(part.size(), 0);
+    EXPECT_EQ(part.blocks(), 0);
+}
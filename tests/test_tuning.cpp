@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "BlackScholes.hpp"
+#include "Option.hpp"
+#include "TunedPricer.hpp"
+
+TEST(Tuning, RejectsNonPositiveTolerance) {
+    EXPECT_THROW(TunedPricer(0.0, 0.0), std::invalid_argument);
+    EXPECT_THROW(TunedPricer(-1e-3), std::invalid_argument);
+}
+
+TEST(Tuning, MeetsAbsoluteTolerance) {
+    const Option book[] = {
+        Option(100, 100, 1.0, 0.05, 0.20, OptionType::Call),
+        Option(90, 100, 0.25, 0.05, 0.30, OptionType::Put),
+        Option(120, 100, 2.0, 0.03, 0.15, OptionType::Call),
+    };
+    for (double tol : {1e-2, 1e-4}) {
+        TunedPricer pricer(tol);
+        for (const Option& opt : book)
+            EXPECT_NEAR(pricer.price(opt), BlackScholes::price(opt), tol);
+    }
+}
+
+TEST(Tuning, MeetsRelativeTolerance) {
+    Option opt(80, 100, 0.5, 0.05, 0.25, OptionType::Call);   // deep OTM, small price
+    TunedPricer pricer(0.0, 1e-3);
+    double exact = BlackScholes::price(opt);
+    EXPECT_NEAR(pricer.price(opt), exact, 1e-3 * exact);
+}
+
+TEST(Tuning, TighterToleranceCostsMore) {
+    Option opt(100, 100, 1.0, 0.05, 0.20, OptionType::Put);
+    Resolution loose = TunedPricer(1e-2).resolutionFor(opt);
+    Resolution tight = TunedPricer(1e-5).resolutionFor(opt);
+    EXPECT_GT(static_cast<double>(tight.n_space) * tight.n_time,
+              static_cast<double>(loose.n_space) * loose.n_time);
+}
+
+TEST(Tuning, CachesPerContractClass) {
+    TunedPricer pricer(1e-3);
+    pricer.price(Option(100, 100, 1.0, 0.05, 0.20, OptionType::Call));
+    pricer.price(Option(101, 100, 1.1, 0.05, 0.21, OptionType::Call));   // same class
+    EXPECT_EQ(pricer.searches(), 1u);
+
+    pricer.price(Option(100, 100, 1.0, 0.05, 0.20, OptionType::Put));    // other type
+    pricer.price(Option(100, 100, 0.1, 0.05, 0.20, OptionType::Call));   // other maturity
+    pricer.price(Option(140, 100, 1.0, 0.05, 0.20, OptionType::Call));   // other moneyness
+    EXPECT_EQ(pricer.searches(), 4u);
+    EXPECT_EQ(pricer.cachedClasses(), 4u);
+}
+
+TEST(Tuning, AmericanMeetsReference) {
+    Option am(100, 100, 1.0, 0.05, 0.20, OptionType::Put, ExerciseType::American);
+    TunedPricer pricer(1e-3);
+    EXPECT_NEAR(pricer.price(am), 6.0904, 2e-3);   // reference itself is to 1e-4
+}
+
+// Only the resolutions cached for a class keep their solvers.
+TEST(Tuning, DropsTrialSolvers) {
+    TunedPricer pricer(1e-3);
+    pricer.price(Option(100, 100, 1.0, 0.05, 0.20, OptionType::Call));
+    pricer.price(Option(100, 100, 1.0, 0.05, 0.20, OptionType::Put));
+    EXPECT_EQ(pricer.searches(), 2u);
+    EXPECT_LE(pricer.solvers(), pricer.cachedClasses());
+    EXPECT_GE(pricer.solvers(), 1u);
+}
+
+// A tolerance below what kMaxSpace can resolve is reported, not hidden.
+TEST(Tuning, ReportsUnmetTolerance) {
+    Option opt(100, 100, 1.0, 0.05, 0.20, OptionType::Put);
+    TunedPrice loose = TunedPricer(1e-3).priceWithStatus(opt);
+    EXPECT_TRUE(loose.converged);
+    EXPECT_NEAR(loose.price, BlackScholes::price(opt), 1e-3);
+
+    TunedPricer tight(1e-12);
+    TunedPrice result = tight.priceWithStatus(opt);
+    EXPECT_FALSE(result.converged);
+    EXPECT_FALSE(tight.resolutionFor(opt).converged);
+    EXPECT_NEAR(result.price, BlackScholes::price(opt), 1e-3);
+}